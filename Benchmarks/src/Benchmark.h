@@ -0,0 +1,268 @@
+#pragma once
+#include <chrono>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace ReeeEngine
+{
+	/* Stop the compiler optimizing away a value that a benchmark calculates. */
+	template<class T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER)
+		static volatile const void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	/* Timing results of a single benchmark. All times are in nanoseconds per operation. */
+	struct BenchmarkResult
+	{
+		std::string name;
+		size_t iterations = 0;
+		size_t samples = 0;
+		double meanNs = 0.0;
+		double varianceNs = 0.0;
+		double minNs = 0.0;
+		double maxNs = 0.0;
+		double opsPerSecond = 0.0;
+	};
+
+	/* Maximum error of an approximation measured against a reference. */
+	struct AccuracyResult
+	{
+		std::string name;
+		double range = 0.0;
+		double maxAbsError = 0.0;
+	};
+
+	/* Per frame cost of a run spread across frames, e.g. streaming in a level. All times are in milliseconds. */
+	struct FrameCostResult
+	{
+		std::string name;
+		size_t frames = 0;
+		double meanMs = 0.0;
+		double peakMs = 0.0;
+		double budgetMs = 0.0;
+	};
+
+	/* A measured count of a run, e.g. how many turns each amortized object got. */
+	struct CounterResult
+	{
+		std::string name;
+		double value = 0.0;
+	};
+
+	/* Result of a headless correctness check ran alongside the benchmarks, e.g. that an optimized path matches its reference. */
+	struct CheckResult
+	{
+		std::string name;
+		bool passed = false;
+		std::string detail;
+	};
+
+	/* Headless micro benchmark runner that writes its results as JSON.
+	 * NOTE: Each benchmark is given an iteration count and must run its operation that many times so the
+	 *       timing loop itself never goes through a function pointer per operation. */
+	class BenchmarkSuite
+	{
+	public:
+
+		/* Function that runs the benchmarked operation a given number of times. */
+		typedef std::function<void(size_t iterations)> BenchmarkFunction;
+
+		/* Setup the suite with the number of timed samples and how long each sample should roughly take. */
+		BenchmarkSuite(const std::string& name, size_t sampleCount = 15, double targetSampleMs = 10.0) :
+			suiteName(name), samples(std::max<size_t>(2, sampleCount)), targetSampleNs(targetSampleMs * 1000000.0) {}
+
+		/* Add a benchmark to run. Only benchmarks whose name contains the filter are added. */
+		void Add(const std::string& name, const BenchmarkFunction& function)
+		{
+			if (!PassesFilter(name)) return;
+			benchmarks.push_back({ name, function });
+		}
+
+		/* Returns if a benchmark with this name should be ran. */
+		bool PassesFilter(const std::string& name) const
+		{
+			return filter.empty() || name.find(filter) != std::string::npos;
+		}
+
+		/* Add a measured accuracy result to be written with the timings. */
+		void AddAccuracy(const std::string& name, double range, double maxAbsError)
+		{
+			accuracy.push_back({ name, range, maxAbsError });
+		}
+
+		/* Add the measured per frame cost of a run to be written with the timings. */
+		void AddFrameCost(const std::string& name, size_t frames, double meanMs, double peakMs, double budgetMs)
+		{
+			frameCosts.push_back({ name, frames, meanMs, peakMs, budgetMs });
+		}
+
+		/* Add a measured count of a run to be written with the timings. */
+		void AddCounter(const std::string& name, double value)
+		{
+			counters.push_back({ name, value });
+		}
+
+		/* Add the result of a correctness check to be written with the timings. Details are only kept for failed checks. */
+		void AddCheck(const std::string& name, bool passed, const std::string& detail = "")
+		{
+			checks.push_back({ name, passed, passed ? std::string() : detail });
+		}
+
+		/* Returns if any added check failed. */
+		bool HasFailedChecks() const
+		{
+			return std::any_of(checks.begin(), checks.end(), [](const CheckResult& check) { return !check.passed; });
+		}
+
+		/* Returns every added check. */
+		const std::vector<CheckResult>& GetChecks() const { return checks; }
+
+		/* Set the name filter used by Add. */
+		void SetFilter(const std::string& newFilter) { filter = newFilter; }
+
+		/* Run every added benchmark and store the results. */
+		void Run()
+		{
+			results.clear();
+			for (const auto& benchmark : benchmarks)
+			{
+				results.push_back(RunBenchmark(benchmark.first, benchmark.second));
+			}
+		}
+
+		/* Returns the results of the last run. */
+		const std::vector<BenchmarkResult>& GetResults() const { return results; }
+
+		/* Write the suite, its timings, accuracy, frame cost, counter and check results as JSON. */
+		void WriteJson(std::ostream& stream, const std::string& simdPath) const
+		{
+			stream << "{\n";
+			stream << "\t\"suite\": \"" << suiteName << "\",\n";
+			stream << "\t\"simd\": \"" << simdPath << "\",\n";
+			stream << "\t\"samples\": " << samples << ",\n";
+			stream << "\t\"benchmarks\": [\n";
+			for (size_t i = 0; i < results.size(); i++)
+			{
+				const BenchmarkResult& result = results[i];
+				stream << "\t\t{ \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+					<< ", \"ns_per_op\": " << result.meanNs << ", \"ns_per_op_variance\": " << result.varianceNs
+					<< ", \"ns_per_op_stddev\": " << std::sqrt(result.varianceNs) << ", \"ns_per_op_min\": " << result.minNs
+					<< ", \"ns_per_op_max\": " << result.maxNs << ", \"ops_per_second\": " << result.opsPerSecond << " }"
+					<< (i + 1 < results.size() ? ",\n" : "\n");
+			}
+			stream << "\t],\n";
+			stream << "\t\"accuracy\": [\n";
+			for (size_t i = 0; i < accuracy.size(); i++)
+			{
+				const AccuracyResult& result = accuracy[i];
+				stream << "\t\t{ \"name\": \"" << result.name << "\", \"range\": " << result.range
+					<< ", \"max_abs_error\": " << result.maxAbsError << " }" << (i + 1 < accuracy.size() ? ",\n" : "\n");
+			}
+			stream << "\t],\n";
+			stream << "\t\"frame_costs\": [\n";
+			for (size_t i = 0; i < frameCosts.size(); i++)
+			{
+				const FrameCostResult& result = frameCosts[i];
+				stream << "\t\t{ \"name\": \"" << result.name << "\", \"frames\": " << result.frames << ", \"mean_ms\": " << result.meanMs
+					<< ", \"peak_ms\": " << result.peakMs << ", \"budget_ms\": " << result.budgetMs << " }" << (i + 1 < frameCosts.size() ? ",\n" : "\n");
+			}
+			stream << "\t],\n";
+			stream << "\t\"counters\": [\n";
+			for (size_t i = 0; i < counters.size(); i++)
+			{
+				const CounterResult& result = counters[i];
+				stream << "\t\t{ \"name\": \"" << result.name << "\", \"value\": " << result.value << " }" << (i + 1 < counters.size() ? ",\n" : "\n");
+			}
+			stream << "\t],\n";
+			stream << "\t\"checks\": [\n";
+			for (size_t i = 0; i < checks.size(); i++)
+			{
+				const CheckResult& result = checks[i];
+				stream << "\t\t{ \"name\": \"" << result.name << "\", \"passed\": " << (result.passed ? "true" : "false")
+					<< ", \"detail\": \"" << result.detail << "\" }" << (i + 1 < checks.size() ? ",\n" : "\n");
+			}
+			stream << "\t]\n";
+			stream << "}\n";
+		}
+
+	private:
+
+		/* Time one call of a benchmark in nanoseconds. */
+		static double TimeCall(const BenchmarkFunction& function, size_t iterations)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			function(iterations);
+			const auto end = std::chrono::steady_clock::now();
+			return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+		}
+
+		/* Calibrate the iteration count then time each sample of a benchmark. */
+		BenchmarkResult RunBenchmark(const std::string& name, const BenchmarkFunction& function) const
+		{
+			// Double the iterations until one sample takes long enough to time accurately. Also warms the caches.
+			size_t iterations = 1;
+			double elapsed = TimeCall(function, iterations);
+			while (elapsed < targetSampleNs && iterations < ((size_t)1 << 40))
+			{
+				const double scale = elapsed > 0.0 ? std::min(8.0, std::max(2.0, targetSampleNs / elapsed)) : 8.0;
+				iterations = (size_t)(iterations * scale);
+				elapsed = TimeCall(function, iterations);
+			}
+
+			// Time each sample.
+			std::vector<double> nsPerOp(samples);
+			for (size_t i = 0; i < samples; i++)
+			{
+				nsPerOp[i] = TimeCall(function, iterations) / (double)iterations;
+			}
+
+			// Work out the statistics.
+			BenchmarkResult result;
+			result.name = name;
+			result.iterations = iterations;
+			result.samples = samples;
+			for (double value : nsPerOp) result.meanNs += value;
+			result.meanNs /= (double)samples;
+			for (double value : nsPerOp) result.varianceNs += (value - result.meanNs) * (value - result.meanNs);
+			result.varianceNs /= (double)(samples - 1);
+			result.minNs = *std::min_element(nsPerOp.begin(), nsPerOp.end());
+			result.maxNs = *std::max_element(nsPerOp.begin(), nsPerOp.end());
+			result.opsPerSecond = result.meanNs > 0.0 ? 1000000000.0 / result.meanNs : 0.0;
+			return result;
+		}
+
+	private:
+
+		// Name written to the JSON output.
+		std::string suiteName;
+
+		// Number of timed samples per benchmark and the time each should take.
+		size_t samples;
+		double targetSampleNs;
+
+		// Only benchmarks containing this are added when not empty.
+		std::string filter;
+
+		// Benchmarks to run and results.
+		std::vector<std::pair<std::string, BenchmarkFunction>> benchmarks;
+		std::vector<BenchmarkResult> results;
+		std::vector<AccuracyResult> accuracy;
+		std::vector<FrameCostResult> frameCosts;
+		std::vector<CounterResult> counters;
+		std::vector<CheckResult> checks;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include "EntityModule.h"
+
+using namespace ReeeEngine;
+
+namespace EntityModule
+{
+	/* Health component only this module knows about. */
+	struct ModuleHealth
+	{
+		float current;
+		float maximum;
+	};
+
+	void AddHealth(EntityStore& store, EntityStore::Entity entity, float health)
+	{
+		store.Add(entity, ModuleHealth{ health, health });
+	}
+
+	float GetHealth(EntityStore& store, EntityStore::Entity entity)
+	{
+		const ModuleHealth* health = store.Get<ModuleHealth>(entity);
+		return health ? health->current : -1.0f;
+	}
+
+	float SumHealth(EntityStore& store)
+	{
+		float sum = 0.0f;
+		store.ForEach<ModuleHealth>([&sum](ModuleHealth& health) { sum += health.current; });
+		return sum;
+	}
+
+	EntityStore::ComponentType GetHealthType(const EntityStore& store)
+	{
+		return store.FindComponentType<ModuleHealth>();
+	}
+}
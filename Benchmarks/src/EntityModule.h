@@ -0,0 +1,19 @@
+#pragma once
+#include "ReeeEngine/World/Core/EntityStore.h"
+
+/* Stand in for a game module using an entity store it did not create. Compiled in its own translation unit so its component
+ * types are first seen outside the store's code, the way a game sees the engine's store. */
+namespace EntityModule
+{
+	/* Give an entity the modules health component. */
+	void AddHealth(ReeeEngine::EntityStore& store, ReeeEngine::EntityStore::Entity entity, float health);
+
+	/* Returns an entities health or -1 if it has no health component. */
+	float GetHealth(ReeeEngine::EntityStore& store, ReeeEngine::EntityStore::Entity entity);
+
+	/* Returns the sum of every entities health. */
+	float SumHealth(ReeeEngine::EntityStore& store);
+
+	/* Returns the index of the health component type in a store. */
+	ReeeEngine::EntityStore::ComponentType GetHealthType(const ReeeEngine::EntityStore& store);
+}
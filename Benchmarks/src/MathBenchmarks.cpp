@@ -0,0 +1,1827 @@
+/* Headless micro benchmarks for the engine math layer, transform hierarchy, entity store and object pools, along with checks that
+ * the optimized engine code still gives the right results. Any failed check makes the run return 1.
+ * NOTE: Only includes header only engine code so it builds on its own without the engine, windows or DirectX.
+ *       On Linux build and run with:
+ *           g++ -std=c++17 -O2 -mavx2 -mfma -IReeeEngine/src Benchmarks/src/MathBenchmarks.cpp Benchmarks/src/EntityModule.cpp -o MathBenchmarks -pthread
+ *           ./MathBenchmarks [--out results.json] [--samples 15] [--filter Transform]
+ *       Results are written as JSON to stdout or the --out file so they can be compared across engine versions. */
+#include "Benchmark.h"
+#include "EntityModule.h"
+#include "ReeeEngine/Math/ReeeMath.h"
+#include "ReeeEngine/Math/Vector3D.h"
+#include "ReeeEngine/Math/Rotator.h"
+#include "ReeeEngine/Math/Quat.h"
+#include "ReeeEngine/Math/Matrix4x4.h"
+#include "ReeeEngine/Math/Transform.h"
+#include "ReeeEngine/World/Core/TransformHierarchy.h"
+#include "ReeeEngine/World/Core/EntityStore.h"
+#include "ReeeEngine/World/Core/ObjectHandle.h"
+#include "ReeeEngine/World/Core/ObjectPool.h"
+#include "ReeeEngine/World/Core/SpatialIndex.h"
+#include "ReeeEngine/World/Core/TickManager.h"
+#include "ReeeEngine/World/Level/LevelStreamer.h"
+#include "ReeeEngine/Rendering/Renderables/FrustumCuller.h"
+#include "ReeeEngine/Rendering/RenderQueue.h"
+#include "ReeeEngine/Rendering/PipelineStateCache.h"
+#include "ReeeEngine/Rendering/Renderables/InstanceBatcher.h"
+#include "ReeeEngine/Rendering/Renderables/StaticMeshBatcher.h"
+#include <iostream>
+#include <fstream>
+#include <random>
+#include <cstring>
+#include <filesystem>
+#include <tuple>
+
+using namespace ReeeEngine;
+
+// Number of inputs each benchmark cycles through. Power of two so the index is a mask.
+static const size_t InputCount = 1024;
+static const size_t InputMask = InputCount - 1;
+
+/* Returns the name of the SIMD path the math layer was compiled with. */
+static const char* GetSimdPath()
+{
+#if defined(REEE_SIMD_AVX2) && defined(REEE_SIMD_FMA)
+	return "AVX2+FMA";
+#elif defined(REEE_SIMD_AVX2)
+	return "AVX2";
+#elif defined(REEE_SIMD_SSE4)
+	return "SSE4";
+#elif defined(REEE_SIMD_SSE)
+	return "SSE2";
+#elif defined(REEE_SIMD_NEON)
+	return "NEON";
+#else
+	return "Scalar";
+#endif
+}
+
+/* Fixed seed inputs so every run measures the same values. */
+struct BenchmarkInputs
+{
+	std::vector<float> positiveFloats;
+	std::vector<float> angles;
+	std::vector<Vector3D> vectors;
+	std::vector<Rotator> rotators;
+	std::vector<Transform> transforms;
+	std::vector<Matrix4x4> matrices;
+
+	BenchmarkInputs()
+	{
+		std::mt19937 random(12345);
+		std::uniform_real_distribution<float> positive(0.001f, 1000.0f);
+		std::uniform_real_distribution<float> signedValue(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<float> degrees(-720.0f, 720.0f);
+		std::uniform_real_distribution<float> scale(0.5f, 4.0f);
+
+		for (size_t i = 0; i < InputCount; i++)
+		{
+			positiveFloats.push_back(positive(random));
+			angles.push_back(degrees(random) * (PI / 180.0f));
+			vectors.push_back(Vector3D(signedValue(random), signedValue(random), signedValue(random)));
+			rotators.push_back(Rotator(degrees(random), degrees(random), degrees(random)));
+			transforms.push_back(Transform(vectors.back(), rotators.back(), Vector3D(scale(random), scale(random), scale(random))));
+			matrices.push_back(transforms.back().GetTransformAsMatrix());
+		}
+	}
+};
+
+/* Add the scalar math benchmarks. */
+static void AddReeeMathBenchmarks(BenchmarkSuite& suite, BenchmarkInputs& inputs)
+{
+	suite.Add("ReeeMath::InvSqrt", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(ReeeMath::InvSqrt(inputs.positiveFloats[i & InputMask]));
+	});
+	suite.Add("1/std::sqrt", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(1.0f / std::sqrt(inputs.positiveFloats[i & InputMask]));
+	});
+	suite.Add("ReeeMath::InterpTo<float>", [&inputs](size_t iterations)
+	{
+		float current = 0.0f;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			current = ReeeMath::InterpTo(current, inputs.positiveFloats[i & InputMask], 0.016f, 5.0f);
+			DoNotOptimize(current);
+		}
+	});
+
+	// Sine and cosine against the standard library.
+	suite.Add("std::sin+std::cos", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			const float angle = inputs.angles[i & InputMask];
+			DoNotOptimize(std::sin(angle));
+			DoNotOptimize(std::cos(angle));
+		}
+	});
+	suite.Add("ReeeMath::SinCos", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			float sinResult, cosResult;
+			ReeeMath::SinCos(inputs.angles[i & InputMask], sinResult, cosResult);
+			DoNotOptimize(sinResult);
+			DoNotOptimize(cosResult);
+		}
+	});
+	suite.Add("ReeeMath::SinCosBatch (per angle)", [&inputs](size_t iterations)
+	{
+		alignas(16) float sinResults[InputCount], cosResults[InputCount];
+		for (size_t done = 0; done < iterations; done += InputCount)
+		{
+			const size_t count = std::min(InputCount, iterations - done);
+			ReeeMath::SinCosBatch(inputs.angles.data(), sinResults, cosResults, count);
+			DoNotOptimize(sinResults[0]);
+		}
+	});
+}
+
+/* Plain three float vector with scalar math, the layout and code Vector3D had before it was backed by SIMD registers. */
+struct PlainVector3D
+{
+	float X, Y, Z;
+
+	PlainVector3D GetNormal() const
+	{
+		const float sizeSquared = X * X + Y * Y + Z * Z;
+		if (sizeSquared <= 0.0f) return { 0.0f, 0.0f, 0.0f };
+		const float scale = 1.0f / std::sqrt(sizeSquared);
+		return { X * scale, Y * scale, Z * scale };
+	}
+
+	float Dot(const PlainVector3D& other) const
+	{
+		return X * other.X + Y * other.Y + Z * other.Z;
+	}
+
+	PlainVector3D Cross(const PlainVector3D& other) const
+	{
+		return { Y * other.Z - Z * other.Y, Z * other.X - X * other.Z, X * other.Y - Y * other.X };
+	}
+};
+
+/* The same 1M (2^20) vectors as Vector3D and as plain structs, streamed through normalize, cross and dot. */
+struct VectorStreamInputs
+{
+	static const size_t VectorCount = (size_t)1 << 20;
+	static const size_t VectorMask = VectorCount - 1;
+
+	std::vector<Vector3D> vectors;
+	std::vector<Vector3D> results;
+	std::vector<PlainVector3D> plainVectors;
+	std::vector<PlainVector3D> plainResults;
+	std::vector<float> dots;
+
+	VectorStreamInputs() : vectors(VectorCount), results(VectorCount), plainVectors(VectorCount), plainResults(VectorCount), dots(VectorCount)
+	{
+		std::mt19937 random(11235);
+		std::uniform_real_distribution<float> signedValue(-1000.0f, 1000.0f);
+		for (size_t i = 0; i < VectorCount; i++)
+		{
+			vectors[i] = Vector3D(signedValue(random), signedValue(random), signedValue(random));
+			plainVectors[i] = { vectors[i].X, vectors[i].Y, vectors[i].Z };
+		}
+	}
+};
+
+/* Add the benchmarks of normalizing, crossing and dotting 1M vectors through Vector3D against the plain struct baseline.
+ * Each operation reads the next vector and writes its result so the loops stream through memory like a mesh would. */
+static void AddVectorStreamBenchmarks(BenchmarkSuite& suite, VectorStreamInputs& stream)
+{
+	const size_t mask = VectorStreamInputs::VectorMask;
+	suite.Add("Vector 1M normalize: plain struct", [&stream, mask](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) stream.plainResults[i & mask] = stream.plainVectors[i & mask].GetNormal();
+		DoNotOptimize(stream.plainResults[0]);
+	});
+	suite.Add("Vector 1M normalize: Vector3D", [&stream, mask](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) stream.results[i & mask] = stream.vectors[i & mask].GetNormal();
+		DoNotOptimize(stream.results[0]);
+	});
+	suite.Add("Vector 1M cross: plain struct", [&stream, mask](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) stream.plainResults[i & mask] = stream.plainVectors[i & mask].Cross(stream.plainVectors[(i + 1) & mask]);
+		DoNotOptimize(stream.plainResults[0]);
+	});
+	suite.Add("Vector 1M cross: Vector3D", [&stream, mask](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) stream.results[i & mask] = stream.vectors[i & mask] ^ stream.vectors[(i + 1) & mask];
+		DoNotOptimize(stream.results[0]);
+	});
+	suite.Add("Vector 1M dot: plain struct", [&stream, mask](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) stream.dots[i & mask] = stream.plainVectors[i & mask].Dot(stream.plainVectors[(i + 1) & mask]);
+		DoNotOptimize(stream.dots[0]);
+	});
+	suite.Add("Vector 1M dot: Vector3D", [&stream, mask](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) stream.dots[i & mask] = stream.vectors[i & mask] | stream.vectors[(i + 1) & mask];
+		DoNotOptimize(stream.dots[0]);
+	});
+}
+
+/* Add the vector and rotator benchmarks. */
+static void AddVectorBenchmarks(BenchmarkSuite& suite, BenchmarkInputs& inputs)
+{
+	suite.Add("Vector3D::GetNormal", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(inputs.vectors[i & InputMask].GetNormal());
+	});
+	suite.Add("Rotator::Normalize", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			Rotator rotator = inputs.rotators[i & InputMask];
+			rotator.Normalize();
+			DoNotOptimize(rotator);
+		}
+	});
+	suite.Add("Rotator::GetNormalized", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(inputs.rotators[i & InputMask].GetNormalized());
+	});
+	suite.Add("Rotator::ToQuaternion", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(inputs.rotators[i & InputMask].ToQuaternion());
+	});
+	suite.Add("Rotator::ToQuaternionBatch (per rotator)", [&inputs](size_t iterations)
+	{
+		std::vector<Quat> quaternions(InputCount);
+		for (size_t done = 0; done < iterations; done += InputCount)
+		{
+			const size_t count = std::min(InputCount, iterations - done);
+			Rotator::ToQuaternionBatch(inputs.rotators.data(), quaternions.data(), count);
+			DoNotOptimize(quaternions[0]);
+		}
+	});
+}
+
+/* Add the transform benchmarks. */
+static void AddTransformBenchmarks(BenchmarkSuite& suite, BenchmarkInputs& inputs)
+{
+	// Before the cache every call rebuilt the rotation from the rotator, the uncached cases do the same with the current math.
+	suite.Add("Transform::GetTransformAsMatrix (uncached, rebuilt from rotator)", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			const Transform& transform = inputs.transforms[i & InputMask];
+			DoNotOptimize(Matrix4x4::Compose(transform.GetScale(), Quat::FromRotator(inputs.rotators[i & InputMask]), transform.GetLocation()));
+		}
+	});
+	suite.Add("Transform::GetTransformAsMatrix (cached)", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(inputs.transforms[i & InputMask].GetTransformAsMatrix());
+	});
+	suite.Add("Transform::TransformVector (uncached, rebuilt from rotator)", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(Quat::FromRotator(inputs.rotators[i & InputMask]).RotateVector(inputs.vectors[i & InputMask]));
+	});
+	suite.Add("Transform::TransformVector (cached)", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(inputs.transforms[i & InputMask].TransformVector(inputs.vectors[i & InputMask]));
+	});
+	suite.Add("Transform::GetTransformAsMatrix (after SetLocation)", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			Transform& transform = inputs.transforms[i & InputMask];
+			transform.SetLocation(inputs.vectors[(i + 1) & InputMask]);
+			DoNotOptimize(transform.GetTransformAsMatrix());
+		}
+	});
+	suite.Add("Transform::GetTransformAsMatrix (after SetRotation)", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			Transform& transform = inputs.transforms[i & InputMask];
+			// Offset by the lap so the new rotation never matches the last one and hits the early out.
+			transform.SetRotation(inputs.rotators[(i + 1 + i / InputCount) & InputMask]);
+			DoNotOptimize(transform.GetTransformAsMatrix());
+		}
+	});
+	suite.Add("Transform::SetTransformFromMatrix", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			Transform& transform = inputs.transforms[i & InputMask];
+			transform.SetTransformFromMatrix(inputs.matrices[(i + 1) & InputMask]);
+			DoNotOptimize(transform);
+		}
+	});
+	suite.Add("Matrix4x4::operator*", [&inputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) DoNotOptimize(inputs.matrices[i & InputMask] * inputs.matrices[(i + 1) & InputMask]);
+	});
+}
+
+/* Hierarchy of 1000 nodes for the transform hierarchy benchmarks. A root with 10 children that each have 10 children
+ * which then share the remaining 889 nodes between them, like a small scene of objects with attached components. */
+struct HierarchyInputs
+{
+	static const size_t NodeCount = 1000;
+
+	TransformHierarchy hierarchy;
+	std::vector<TransformHierarchy::Handle> handles;
+	std::vector<TransformHierarchy::Handle> movedNodes;
+	std::vector<Transform> newTransforms;
+
+	HierarchyInputs(BenchmarkInputs& inputs)
+	{
+		handles.push_back(hierarchy.Add());
+		for (size_t i = 1; i < NodeCount; i++)
+		{
+			const TransformHierarchy::Handle parent = i <= 10 ? handles[0] : (i <= 110 ? handles[1 + (i - 11) / 10] : handles[11 + (i - 111) % 100]);
+			handles.push_back(hierarchy.Add());
+			hierarchy.Attach(handles[i], parent);
+			hierarchy.SetLocal(handles[i], inputs.transforms[i & InputMask]);
+		}
+		hierarchy.UpdateWorldTransforms();
+		hierarchy.ConsumeChanged([](TransformHierarchy::Handle) {});
+
+		// Move the first level of objects around, each one carries a subtree of about 100 nodes.
+		for (size_t i = 1; i <= 10; i++) movedNodes.push_back(handles[i]);
+		newTransforms.assign(inputs.transforms.begin(), inputs.transforms.end());
+	}
+
+	/* Set the world transform one channel at a time the way SceneComponent used to, optionally notifying after each channel
+	 * like it did before transform changes were coalesced. */
+	void SetWorldPerChannel(TransformHierarchy::Handle handle, const Transform& newWorld, bool flushEachChannel)
+	{
+		const TransformHierarchy::Handle parent = hierarchy.GetParent(handle);
+		const Vector3D relativeLocation = hierarchy.GetWorld(parent).InverseTransformPosition(newWorld.GetLocation());
+		hierarchy.EditLocal(handle).SetLocation(relativeLocation);
+		if (flushEachChannel) Flush();
+
+		const Quat relativeQuat = (newWorld.GetQuaternion() * hierarchy.GetWorld(parent).GetQuaternion().GetInverse()).GetNormal();
+		hierarchy.EditLocal(handle).SetQuaternion(relativeQuat);
+		if (flushEachChannel) Flush();
+
+		Transform scaledWorld = hierarchy.GetWorld(handle);
+		scaledWorld.SetScale(newWorld.GetScale());
+		const Vector3D relativeScale = scaledWorld.GetRelativeTo(hierarchy.GetWorld(parent)).GetScale();
+		hierarchy.EditLocal(handle).SetScale(relativeScale);
+		if (flushEachChannel) Flush();
+	}
+
+	/* Update the world transforms and rebuild the matrix of every changed node like MeshComponent::TransformChanged does. */
+	void Flush()
+	{
+		hierarchy.UpdateWorldTransforms();
+		hierarchy.ConsumeChanged([this](TransformHierarchy::Handle handle)
+		{
+			DoNotOptimize(hierarchy.GetWorld(handle).GetTransformAsMatrix());
+		});
+	}
+};
+
+/* Add the transform hierarchy benchmarks. Each operation moves 10 subtrees of 100 nodes in a 1000 node hierarchy. */
+static void AddHierarchyBenchmarks(BenchmarkSuite& suite, HierarchyInputs& hierarchy)
+{
+	suite.Add("TransformHierarchy 1000 nodes: per channel set, notify each channel", [&hierarchy](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (size_t j = 0; j < hierarchy.movedNodes.size(); j++)
+			{
+				hierarchy.SetWorldPerChannel(hierarchy.movedNodes[j], hierarchy.newTransforms[(i * 16 + j) & InputMask], true);
+			}
+		}
+	});
+	suite.Add("TransformHierarchy 1000 nodes: per channel set, notify once", [&hierarchy](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (size_t j = 0; j < hierarchy.movedNodes.size(); j++)
+			{
+				hierarchy.SetWorldPerChannel(hierarchy.movedNodes[j], hierarchy.newTransforms[(i * 16 + j) & InputMask], false);
+			}
+			hierarchy.Flush();
+		}
+	});
+	suite.Add("TransformHierarchy 1000 nodes: SetWorld, notify once", [&hierarchy](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (size_t j = 0; j < hierarchy.movedNodes.size(); j++)
+			{
+				hierarchy.hierarchy.SetWorld(hierarchy.movedNodes[j], hierarchy.newTransforms[(i * 16 + j) & InputMask]);
+			}
+			hierarchy.Flush();
+		}
+	});
+}
+
+/* Scene of objects made of 10 scene components each, a root with 3 children that each have 2 children of their own. */
+struct ScalingScene
+{
+	TransformHierarchy hierarchy;
+	std::vector<TransformHierarchy::Handle> roots;
+	size_t componentCount;
+
+	ScalingScene(size_t objectCount, BenchmarkInputs& inputs) : componentCount(objectCount * 10)
+	{
+		size_t input = 0;
+		for (size_t object = 0; object < objectCount; object++)
+		{
+			const TransformHierarchy::Handle root = hierarchy.Add();
+			roots.push_back(root);
+			hierarchy.SetLocal(root, inputs.transforms[input++ & InputMask]);
+			for (int child = 0; child < 3; child++)
+			{
+				const TransformHierarchy::Handle childHandle = hierarchy.Add();
+				hierarchy.Attach(childHandle, root);
+				hierarchy.SetLocal(childHandle, inputs.transforms[input++ & InputMask]);
+				for (int grandChild = 0; grandChild < 2; grandChild++)
+				{
+					const TransformHierarchy::Handle grandChildHandle = hierarchy.Add();
+					hierarchy.Attach(grandChildHandle, childHandle);
+					hierarchy.SetLocal(grandChildHandle, inputs.transforms[input++ & InputMask]);
+				}
+			}
+		}
+		hierarchy.UpdateWorldTransforms();
+		hierarchy.ConsumeChanged([](TransformHierarchy::Handle) {});
+	}
+
+	/* Mark the given share of objects as moved, every object when moveEvery is 1, the way a frame of gameplay would. */
+	void MarkMoved(size_t moveEvery)
+	{
+		if (moveEvery == 1)
+		{
+			hierarchy.MarkAllDirty();
+			return;
+		}
+		for (size_t object = 0; object < roots.size(); object += moveEvery) hierarchy.MarkDirty(roots[object]);
+	}
+};
+
+/* Add the thread scaling benchmarks of updating world transforms in scenes of 10k and 100k components, with every object moved and
+ * with 1 in 10 and 1 in 100 moved. These set where SceneComponent::SetParallelTransformUpdateCount should be on a given machine. */
+static void AddScalingBenchmarks(BenchmarkSuite& suite, std::vector<std::unique_ptr<ScalingScene>>& scenes, std::vector<std::unique_ptr<WorkerPool>>& pools)
+{
+	for (auto& scene : scenes)
+	{
+		ScalingScene* scenePointer = scene.get();
+		for (size_t moveEvery : { (size_t)1, (size_t)10, (size_t)100 })
+		{
+			const std::string moved = moveEvery == 1 ? "all" : "1/" + std::to_string(moveEvery);
+			const std::string prefix = "TransformHierarchy " + std::to_string(scene->componentCount) + " nodes update (" + moved + " moved): ";
+			suite.Add(prefix + "serial sweep", [scenePointer, moveEvery](size_t iterations)
+			{
+				for (size_t i = 0; i < iterations; i++)
+				{
+					scenePointer->MarkMoved(moveEvery);
+					scenePointer->hierarchy.UpdateWorldTransforms();
+				}
+			});
+			for (auto& pool : pools)
+			{
+				WorkerPool* poolPointer = pool.get();
+				suite.Add(prefix + std::to_string(pool->GetThreadCount()) + " threads", [scenePointer, poolPointer, moveEvery](size_t iterations)
+				{
+					for (size_t i = 0; i < iterations; i++)
+					{
+						scenePointer->MarkMoved(moveEvery);
+						scenePointer->hierarchy.UpdateWorldTransformsParallel(*poolPointer);
+					}
+				});
+			}
+		}
+	}
+}
+
+/* Stand in for Object with the tick members BasicTickManager uses, so the tick scheduling can be ran without the engine.
+ * Its tick mixes the state of its prerequisites into its own and counts any prerequisite that had not ticked before it this frame. */
+class ScheduledObject
+{
+public:
+	ScheduledObject(const std::string& objectName, const TickSettings& settings, uint32_t tickWork) : name(objectName), tickSettings(settings), work(tickWork) {}
+
+	bool CanEverTick() const { return tickSettings.canEverTick; }
+
+	void Tick(float deltaTime)
+	{
+		for (const ScheduledObject* prerequisite : tickPrerequisites)
+		{
+			if (prerequisite->tickCount <= tickCount) orderErrors++;
+			state += prerequisite->state;
+		}
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		for (uint32_t i = 0; i < work; i++) value = value * 0.5f + deltaTime;
+		tickCount++;
+	}
+
+	std::string name;
+	TickSettings tickSettings;
+	std::vector<ScheduledObject*> tickPrerequisites;
+	BasicTickManager<ScheduledObject>* tickManager = nullptr;
+	uint32_t tickIndex = 0;
+
+	// Iterations of busy work each tick does, the state mixed from its prerequisites and the number of ticks so far.
+	uint32_t work;
+	float value = 0.0f;
+	uint64_t state = 0;
+	uint32_t tickCount = 0;
+	uint32_t orderErrors = 0;
+};
+
+/* 10k ticked objects with no prerequisites registered once to tick on the game thread and once to tick on any thread. */
+struct TickInputs
+{
+	static const size_t ObjectCount = 10000;
+
+	std::vector<std::unique_ptr<ScheduledObject>> gameThreadObjects;
+	std::vector<std::unique_ptr<ScheduledObject>> anyThreadObjects;
+	BasicTickManager<ScheduledObject> gameThreadTicks;
+	BasicTickManager<ScheduledObject> anyThreadTicks;
+
+	TickInputs()
+	{
+		TickSettings settings;
+		settings.canEverTick = true;
+		for (size_t i = 0; i < ObjectCount; i++)
+		{
+			gameThreadObjects.push_back(std::make_unique<ScheduledObject>("Object" + std::to_string(i), settings, 64));
+			gameThreadTicks.Register(gameThreadObjects.back().get());
+		}
+		settings.runOnAnyThread = true;
+		for (size_t i = 0; i < ObjectCount; i++)
+		{
+			anyThreadObjects.push_back(std::make_unique<ScheduledObject>("Object" + std::to_string(i), settings, 64));
+			anyThreadTicks.Register(anyThreadObjects.back().get());
+		}
+	}
+};
+
+/* Add the thread scaling benchmarks of ticking 10k objects on the game thread and spread across worker pools. */
+static void AddTickBenchmarks(BenchmarkSuite& suite, TickInputs& tickInputs, std::vector<std::unique_ptr<WorkerPool>>& pools)
+{
+	const float deltaTime = 1.0f / 60.0f;
+	suite.Add("TickManager 10k objects: game thread", [&tickInputs, &pools, deltaTime](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) tickInputs.gameThreadTicks.Tick(deltaTime, pools[0].get());
+	});
+	for (auto& pool : pools)
+	{
+		WorkerPool* poolPointer = pool.get();
+		suite.Add("TickManager 10k objects: any thread, " + std::to_string(pool->GetThreadCount()) + " threads", [&tickInputs, poolPointer, deltaTime](size_t iterations)
+		{
+			for (size_t i = 0; i < iterations; i++) tickInputs.anyThreadTicks.Tick(deltaTime, poolPointer);
+		});
+	}
+}
+
+/* Velocity entity component moved along by the entity benchmarks. */
+struct EntityVelocity
+{
+	Vector3D value;
+};
+
+/* Stand in for a component the way World::Tick runs them: allocated on its own and ticked through a virtual call. */
+class TickedComponent
+{
+public:
+	TickedComponent(const std::string& componentName) : name(componentName) {}
+	virtual ~TickedComponent() = default;
+	virtual void Tick(float) {}
+
+	std::string name;
+};
+
+/* Component that moves its owners transform by a velocity every tick. */
+class MovingComponent : public TickedComponent
+{
+public:
+	MovingComponent(Transform& ownerTransform, const Vector3D& newVelocity) : TickedComponent("Mover"), transform(ownerTransform), velocity(newVelocity) {}
+	virtual void Tick(float deltaTime) override
+	{
+		transform.SetLocation(transform.GetLocation() + velocity * deltaTime);
+	}
+
+	Transform& transform;
+	Vector3D velocity;
+};
+
+/* Stand in for a GameObject: a named shared object ticking a list of separately allocated components, a root component with an
+ * empty tick like SceneComponent and one that moves the object. */
+class TickedObject
+{
+public:
+	TickedObject(const std::string& objectName, const Transform& startTransform, const Vector3D& velocity) : name(objectName), transform(startTransform)
+	{
+		ownedComponents.push_back(std::make_shared<TickedComponent>("RootComponent"));
+		ownedComponents.push_back(std::make_shared<MovingComponent>(transform, velocity));
+		for (auto& component : ownedComponents) components.push_back(component.get());
+	}
+	virtual ~TickedObject() = default;
+	virtual void Tick(float deltaTime)
+	{
+		for (TickedComponent* component : components) component->Tick(deltaTime);
+	}
+
+	std::string name;
+	Transform transform;
+	std::vector<std::shared_ptr<TickedComponent>> ownedComponents;
+	std::vector<TickedComponent*> components;
+};
+
+/* The same 100k moving objects stored as ticked objects and as entities. */
+struct EntityInputs
+{
+	static const size_t ObjectCount = 100000;
+
+	std::vector<std::shared_ptr<TickedObject>> objects;
+	EntityStore entities;
+
+	EntityInputs(BenchmarkInputs& inputs)
+	{
+		for (size_t i = 0; i < ObjectCount; i++)
+		{
+			const Transform& startTransform = inputs.transforms[i & InputMask];
+			const Vector3D& velocity = inputs.vectors[(i + 1) & InputMask];
+			objects.push_back(std::make_shared<TickedObject>("Object" + std::to_string(i), startTransform, velocity));
+			entities.Create(startTransform, EntityVelocity{ velocity });
+		}
+	}
+};
+
+/* Add the benchmarks comparing a frame of moving 100k objects through virtual ticks against an entity system. */
+static void AddEntityBenchmarks(BenchmarkSuite& suite, EntityInputs& entityInputs)
+{
+	const float deltaTime = 1.0f / 60.0f;
+	suite.Add("World 100k objects: virtual object and component ticks", [&entityInputs, deltaTime](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (auto& object : entityInputs.objects) object->Tick(deltaTime);
+		}
+		DoNotOptimize(entityInputs.objects[0]->transform);
+	});
+	suite.Add("World 100k objects: EntityStore system", [&entityInputs, deltaTime](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			entityInputs.entities.ForEach<Transform, EntityVelocity>([deltaTime](Transform& transform, EntityVelocity& velocity)
+			{
+				transform.SetLocation(transform.GetLocation() + velocity.value * deltaTime);
+			});
+		}
+		DoNotOptimize(entityInputs.entities.GetCount());
+	});
+}
+
+/* Check component types added by another module get their own index in each store, so a store shared between the engine and
+ * a game keeps both modules components apart whichever order they are first used in. */
+static void AddEntityStoreChecks(BenchmarkSuite& suite)
+{
+	if (!suite.PassesFilter("EntityStore")) return;
+
+	// The first store sees this modules velocity type first, the second sees the other modules health type first.
+	const size_t entityCount = 100;
+	EntityStore velocityFirst, healthFirst;
+	std::vector<EntityStore::Entity> velocityFirstEntities, healthFirstEntities;
+	for (size_t i = 0; i < entityCount; i++)
+	{
+		velocityFirstEntities.push_back(velocityFirst.Create(EntityVelocity{ Vector3D((float)i, 0.0f, 0.0f) }));
+		if (i % 2 == 0) EntityModule::AddHealth(velocityFirst, velocityFirstEntities[i], (float)i);
+		healthFirstEntities.push_back(healthFirst.Create());
+		EntityModule::AddHealth(healthFirst, healthFirstEntities[i], (float)i);
+		if (i % 2 == 0) healthFirst.Add(healthFirstEntities[i], EntityVelocity{ Vector3D((float)i, 0.0f, 0.0f) });
+	}
+
+	size_t wrongComponents = 0;
+	float expectedHealth = 0.0f, expectedEvenHealth = 0.0f;
+	for (size_t i = 0; i < entityCount; i++)
+	{
+		const bool even = i % 2 == 0;
+		const EntityVelocity* velocity = velocityFirst.Get<EntityVelocity>(velocityFirstEntities[i]);
+		wrongComponents += velocity && velocity->value.X == (float)i ? 0 : 1;
+		wrongComponents += EntityModule::GetHealth(velocityFirst, velocityFirstEntities[i]) == (even ? (float)i : -1.0f) ? 0 : 1;
+		const EntityVelocity* otherVelocity = healthFirst.Get<EntityVelocity>(healthFirstEntities[i]);
+		wrongComponents += even ? (otherVelocity && otherVelocity->value.X == (float)i ? 0 : 1) : (otherVelocity ? 1 : 0);
+		wrongComponents += EntityModule::GetHealth(healthFirst, healthFirstEntities[i]) == (float)i ? 0 : 1;
+		expectedHealth += (float)i;
+		expectedEvenHealth += even ? (float)i : 0.0f;
+	}
+	const bool indicesPerStore = velocityFirst.FindComponentType<EntityVelocity>() == 0 && EntityModule::GetHealthType(velocityFirst) == 1 &&
+		EntityModule::GetHealthType(healthFirst) == 0 && healthFirst.FindComponentType<EntityVelocity>() == 1 && velocityFirst.GetComponentTypeCount() == 2;
+	const bool sums = EntityModule::SumHealth(velocityFirst) == expectedEvenHealth && EntityModule::SumHealth(healthFirst) == expectedHealth;
+	suite.AddCheck("EntityStore: component types from another translation unit get their own index in each store", indicesPerStore && sums && wrongComponents == 0,
+		std::to_string(wrongComponents) + " wrong components, velocity type " + std::to_string(velocityFirst.FindComponentType<EntityVelocity>()) + " and " +
+		std::to_string(healthFirst.FindComponentType<EntityVelocity>()) + ", health type " + std::to_string(EntityModule::GetHealthType(velocityFirst)) + " and " +
+		std::to_string(EntityModule::GetHealthType(healthFirst)));
+}
+
+/* Stand in for a spawned GameObject: a named object with a transform and a handle back into its world. */
+class SpawnedObject
+{
+public:
+	SpawnedObject(const std::string& objectName) : name(objectName) {}
+	virtual ~SpawnedObject() = default;
+
+	std::string name;
+	Transform transform;
+	ObjectHandle<SpawnedObject> handle;
+};
+
+/* Rolling sets of live objects, each churn replaces the oldest object with a newly spawned one. */
+struct ChurnInputs
+{
+	static const size_t LiveCount = 10000;
+	static const size_t ChurnCount = 100000;
+
+	std::vector<std::shared_ptr<SpawnedObject>> sharedObjects;
+	std::vector<std::weak_ptr<SpawnedObject>> weakObjects;
+	std::vector<std::shared_ptr<SpawnedObject>> pooledObjects;
+	std::vector<ObjectHandle<SpawnedObject>> pooledHandles;
+	HandleTable<SpawnedObject> handles;
+
+	ChurnInputs() : sharedObjects(LiveCount), weakObjects(LiveCount), pooledObjects(LiveCount), pooledHandles(LiveCount)
+	{
+		for (size_t i = 0; i < LiveCount; i++)
+		{
+			sharedObjects[i] = std::make_shared<SpawnedObject>("Projectile");
+			weakObjects[i] = sharedObjects[i];
+			SpawnPooled(i);
+		}
+	}
+
+	/* Replace the pooled object in a slot the way World::NewObject spawns one. */
+	void SpawnPooled(size_t slot)
+	{
+		if (pooledObjects[slot]) handles.Remove(pooledObjects[slot]->handle);
+		pooledObjects[slot] = std::allocate_shared<SpawnedObject>(PoolAllocator<SpawnedObject>(), "Projectile");
+		pooledObjects[slot]->handle = handles.Add(pooledObjects[slot].get());
+		pooledHandles[slot] = pooledObjects[slot]->handle;
+	}
+};
+
+/* Add the benchmarks comparing spawning, destroying and looking up objects through shared pointers against pools and handles. */
+static void AddChurnBenchmarks(BenchmarkSuite& suite, ChurnInputs& churnInputs)
+{
+	suite.Add("World 100k spawn/destroy: make_shared", [&churnInputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (size_t churn = 0; churn < ChurnInputs::ChurnCount; churn++)
+			{
+				churnInputs.sharedObjects[churn % ChurnInputs::LiveCount] = std::make_shared<SpawnedObject>("Projectile");
+			}
+		}
+		DoNotOptimize(churnInputs.sharedObjects[0]->transform);
+	});
+	suite.Add("World 100k spawn/destroy: ObjectPool + handles", [&churnInputs](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (size_t churn = 0; churn < ChurnInputs::ChurnCount; churn++)
+			{
+				churnInputs.SpawnPooled(churn % ChurnInputs::LiveCount);
+			}
+		}
+		DoNotOptimize(churnInputs.pooledObjects[0]->transform);
+	});
+	suite.Add("World 10k lookups: weak_ptr lock", [&churnInputs](size_t iterations)
+	{
+		size_t alive = 0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const auto& weakObject : churnInputs.weakObjects)
+			{
+				if (std::shared_ptr<SpawnedObject> object = weakObject.lock()) alive += object->name.size();
+			}
+		}
+		DoNotOptimize(alive);
+	});
+	suite.Add("World 10k lookups: HandleTable::Get", [&churnInputs](size_t iterations)
+	{
+		size_t alive = 0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const auto& handle : churnInputs.pooledHandles)
+			{
+				if (SpawnedObject* object = churnInputs.handles.Get(handle)) alive += object->name.size();
+			}
+		}
+		DoNotOptimize(alive);
+	});
+}
+
+/* 100k objects moving around a 2km cube, kept both as a plain list of bounds and in a spatial index. */
+struct SpatialInputs
+{
+	static const size_t ObjectCount = 100000;
+	static const size_t QueryCount = 64;
+	static const size_t NearestCount = 16;
+
+	std::vector<BoundingBox> bounds;
+	std::vector<Vector3D> velocities;
+	std::vector<uint32_t> proxies;
+	std::vector<uint8_t> visible;
+	SpatialIndex<uint32_t> index;
+	std::vector<Vector3D> queryPoints;
+	Frustum frustum;
+
+	SpatialInputs() : bounds(ObjectCount), velocities(ObjectCount), proxies(ObjectCount), visible(ObjectCount), index(1.0f)
+	{
+		std::mt19937 random(13579);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+		std::uniform_real_distribution<float> size(0.5f, 2.0f);
+		std::uniform_real_distribution<float> speed(-10.0f, 10.0f);
+		for (uint32_t i = 0; i < ObjectCount; i++)
+		{
+			bounds[i] = BoundingBox::FromCenterExtents(Vector3D(position(random), position(random), position(random)), Vector3D(size(random)));
+			velocities[i] = Vector3D(speed(random), speed(random), speed(random));
+			proxies[i] = index.Insert(bounds[i], i);
+		}
+		for (size_t i = 0; i < QueryCount; i++) queryPoints.push_back(Vector3D(position(random), position(random), position(random)));
+
+		// A camera in the middle of the cube looking along X with a far plane short of the edge.
+		const Matrix4x4 view = Matrix4x4::LookToLH(Vector3D(0.0f), Vector3D(1.0f, 0.0f, 0.0f), Vector3D(0.0f, 1.0f, 0.0f));
+		frustum.SetFromMatrix(view * Matrix4x4::PerspectiveFovLH(1.0f, 16.0f / 9.0f, 0.1f, 800.0f));
+	}
+
+	/* Move every object on by a frame, turning back at the edges of the cube. */
+	void Move(float deltaTime)
+	{
+		for (size_t i = 0; i < ObjectCount; i++)
+		{
+			Vector3D offset = velocities[i] * deltaTime;
+			const Vector3D center = bounds[i].GetCenter();
+			if (std::abs(center.X + offset.X) > 1000.0f || std::abs(center.Y + offset.Y) > 1000.0f || std::abs(center.Z + offset.Z) > 1000.0f)
+			{
+				velocities[i] = velocities[i] * -1.0f;
+				offset = offset * -1.0f;
+			}
+			bounds[i] = BoundingBox(bounds[i].Min + offset, bounds[i].Max + offset);
+		}
+	}
+};
+
+/* 10k draws of a scene in gather order, spread over a few shaders, a few hundred textures and meshes at random depths. */
+struct RenderQueueInputs
+{
+	static const size_t DrawCount = 10000;
+
+	std::vector<DrawPacket> packets;
+
+	RenderQueueInputs()
+	{
+		std::mt19937 random(24680);
+		std::uniform_int_distribution<uint32_t> shader(0, 3);
+		std::uniform_int_distribution<uint32_t> material(0, 499);
+		std::uniform_real_distribution<float> depth(0.1f, 5000.0f);
+		for (size_t i = 0; i < DrawCount; i++)
+		{
+			const uint32_t mesh = material(random);
+			packets.push_back({ RenderQueue::MakeKey(RenderPass::Opaque, shader(random), mesh / 2, mesh, depth(random)), nullptr });
+		}
+	}
+};
+
+/* 10k draws of the same mesh and material scattered in front of a camera, already sorted by the render queue. */
+struct InstancingInputs
+{
+	static const size_t DrawCount = 10000;
+
+	RenderQueue queue;
+	std::vector<Matrix4x4> models;
+	Matrix4x4 view;
+	Matrix4x4 projection;
+
+	InstancingInputs() : models(DrawCount)
+	{
+		std::mt19937 random(97531);
+		std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+		for (size_t i = 0; i < DrawCount; i++)
+		{
+			const Vector3D location(position(random) + 510.0f, position(random), position(random));
+			models[i] = Matrix4x4::Translation(location);
+			queue.Submit(RenderQueue::MakeKey(RenderPass::Opaque, 0, 0, 0, location.X), (const RenderableMesh*)&models[i]);
+		}
+		queue.Sort();
+		view = Matrix4x4::LookToLH(Vector3D(0.0f), Vector3D(1.0f, 0.0f, 0.0f), Vector3D(0.0f, 1.0f, 0.0f));
+		projection = Matrix4x4::PerspectiveFovLH(1.0f, 16.0f / 9.0f, 0.1f, 2000.0f);
+	}
+};
+
+/* Add the benchmarks of sorting a frames draws with the render queues radix sort against a comparison sort. */
+static void AddRenderQueueBenchmarks(BenchmarkSuite& suite, RenderQueueInputs& renderInputs, InstancingInputs& instancingInputs)
+{
+	suite.Add("Render queue 10k draws: gather + std::sort", [&renderInputs](size_t iterations)
+	{
+		std::vector<DrawPacket> sorted;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			sorted.assign(renderInputs.packets.begin(), renderInputs.packets.end());
+			std::sort(sorted.begin(), sorted.end(), [](const DrawPacket& a, const DrawPacket& b) { return a.key < b.key; });
+		}
+		DoNotOptimize(sorted[0]);
+	});
+	suite.Add("Render queue 10k draws: gather + RenderQueue::Sort", [&renderInputs](size_t iterations)
+	{
+		RenderQueue queue;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			queue.Clear();
+			for (const DrawPacket& packet : renderInputs.packets) queue.Submit(packet.key, packet.renderable);
+			queue.Sort();
+		}
+		DoNotOptimize(queue.GetPackets()[0]);
+	});
+
+	// Building the transforms of 10k draws of the same mesh one constant buffer at a time against building the instance transforms of their instanced draws.
+	suite.Add("Instancing 10k identical meshes: per draw transforms (10k draws)", [&instancingInputs](size_t iterations)
+	{
+		// Each draw writes its own block as each draw maps the transform constant buffer.
+		std::vector<InstanceTransform> constantBuffers(InstancingInputs::DrawCount);
+		for (size_t i = 0; i < iterations; i++)
+		{
+			const std::vector<DrawPacket>& packets = instancingInputs.queue.GetPackets();
+			for (size_t draw = 0; draw < packets.size(); draw++)
+			{
+				const Matrix4x4 modelView = *(const Matrix4x4*)packets[draw].renderable * instancingInputs.view;
+				constantBuffers[draw].modelView = modelView.GetTransposed();
+				constantBuffers[draw].modelViewProj = (modelView * instancingInputs.projection).GetTransposed();
+			}
+		}
+		DoNotOptimize(constantBuffers[0]);
+	});
+	suite.Add("Instancing 10k identical meshes: InstanceBatcher::Build (10 draws)", [&instancingInputs](size_t iterations)
+	{
+		InstanceBatcher batcher;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			batcher.Build(instancingInputs.queue.GetPackets(), instancingInputs.view, instancingInputs.projection,
+				[](const DrawPacket& packet) { return *(const Matrix4x4*)packet.renderable; },
+				[](const DrawPacket&, const DrawPacket&) { return true; });
+		}
+		DoNotOptimize(batcher.GetInstances()[0]);
+	});
+
+	// The binds of a mesh draw, its own shaders, layout, buffers and texture plus the topology, transform buffer and sampler every mesh shares.
+	suite.Add("Render queue 10k draws: mesh binds through PipelineStateCache", [](size_t iterations)
+	{
+		static const uint8_t meshObjects[RenderQueueInputs::DrawCount] = {};
+		static const uint8_t sharedObjects[3] = {};
+		PipelineStateCache cache;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (size_t draw = 0; draw < RenderQueueInputs::DrawCount; draw++)
+			{
+				const void* mesh = &meshObjects[draw];
+				cache.Bind(PipelineBindType::Topology, 0u, nullptr, 4u);
+				cache.Bind(PipelineBindType::PixelShaderResource, 0u, mesh);
+				cache.Bind(PipelineBindType::PixelSampler, 0u, &sharedObjects[0]);
+				cache.Bind(PipelineBindType::VertexBuffer, 0u, mesh, 32u);
+				cache.Bind(PipelineBindType::IndexBuffer, 0u, mesh);
+				cache.Bind(PipelineBindType::VertexShader, 0u, mesh);
+				cache.Bind(PipelineBindType::PixelShader, 0u, mesh);
+				cache.Bind(PipelineBindType::InputLayout, 0u, mesh);
+				cache.Bind(PipelineBindType::PixelConstantBuffer, 1u, mesh);
+				cache.Bind(PipelineBindType::VertexConstantBuffer, 0u, &sharedObjects[1]);
+			}
+			cache.EndFrame();
+		}
+		DoNotOptimize(cache.GetStats());
+	});
+}
+
+/* Add the benchmarks comparing moving, range, frustum and nearest queries on the spatial index against checking every object. */
+static void AddSpatialBenchmarks(BenchmarkSuite& suite, SpatialInputs& spatial)
+{
+	const float deltaTime = 1.0f / 60.0f;
+	suite.Add("Spatial 100k moving: move bounds (brute force)", [&spatial, deltaTime](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++) spatial.Move(deltaTime);
+		DoNotOptimize(spatial.bounds[0]);
+	});
+	suite.Add("Spatial 100k moving: move bounds + SpatialIndex refit", [&spatial, deltaTime](size_t iterations)
+	{
+		for (size_t i = 0; i < iterations; i++)
+		{
+			spatial.Move(deltaTime);
+			for (uint32_t proxy : spatial.proxies) spatial.index.MarkDirty(proxy);
+			spatial.index.Refit([&spatial](uint32_t object) { return spatial.bounds[object]; });
+		}
+		DoNotOptimize(spatial.index.GetHeight());
+	});
+	suite.Add("Spatial 100k: 64 radius queries (brute force)", [&spatial](size_t iterations)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const Vector3D& point : spatial.queryPoints)
+			{
+				for (const BoundingBox& box : spatial.bounds) found += box.GetDistanceSquared(point) <= 50.0f * 50.0f ? 1 : 0;
+			}
+		}
+		DoNotOptimize(found);
+	});
+	suite.Add("Spatial 100k: 64 radius queries (SpatialIndex)", [&spatial](size_t iterations)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const Vector3D& point : spatial.queryPoints) spatial.index.QueryRadius(point, 50.0f, [&found](uint32_t) { found++; });
+		}
+		DoNotOptimize(found);
+	});
+	suite.Add("Spatial 100k: frustum cull draws (BoundingBox::IntersectsFrustum)", [&spatial](size_t iterations)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const BoundingBox& box : spatial.bounds) found += box.IntersectsFrustum(spatial.frustum) ? 1 : 0;
+		}
+		DoNotOptimize(found);
+	});
+	suite.Add("Spatial 100k: frustum cull draws (FrustumCuller)", [&spatial](size_t iterations)
+	{
+		FrustumCuller culler;
+		size_t found = 0;
+		for (size_t i = 0; i < iterations; i++) found += culler.Cull(spatial.frustum, spatial.bounds.data(), spatial.bounds.size());
+		DoNotOptimize(found);
+	});
+	suite.Add("Spatial 100k: frustum query (BoundsBatch::CullBoxes)", [&spatial](size_t iterations)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < iterations; i++) found += BoundsBatch::CullBoxes(spatial.frustum, spatial.bounds.data(), spatial.bounds.size(), spatial.visible.data());
+		DoNotOptimize(found);
+	});
+	suite.Add("Spatial 100k: frustum query (SpatialIndex)", [&spatial](size_t iterations)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < iterations; i++) spatial.index.QueryFrustum(spatial.frustum, [&found](uint32_t) { found++; });
+		DoNotOptimize(found);
+	});
+	suite.Add("Spatial 100k: 64 16-nearest queries (brute force)", [&spatial](size_t iterations)
+	{
+		std::vector<float> distances(SpatialInputs::ObjectCount);
+		float nearest = 0.0f;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const Vector3D& point : spatial.queryPoints)
+			{
+				for (size_t object = 0; object < SpatialInputs::ObjectCount; object++) distances[object] = spatial.bounds[object].GetDistanceSquared(point);
+				std::nth_element(distances.begin(), distances.begin() + SpatialInputs::NearestCount - 1, distances.end());
+				nearest += distances[SpatialInputs::NearestCount - 1];
+			}
+		}
+		DoNotOptimize(nearest);
+	});
+	suite.Add("Spatial 100k: 64 16-nearest queries (SpatialIndex)", [&spatial](size_t iterations)
+	{
+		SpatialHit<uint32_t> hits[SpatialInputs::NearestCount];
+		float nearest = 0.0f;
+		for (size_t i = 0; i < iterations; i++)
+		{
+			for (const Vector3D& point : spatial.queryPoints)
+			{
+				const size_t found = spatial.index.QueryNearest(point, hits, SpatialInputs::NearestCount);
+				nearest += hits[found - 1].distanceSquared;
+			}
+		}
+		DoNotOptimize(nearest);
+	});
+}
+
+/* Stream a 50k object level in around the origin with the default frame budget and record what each frame cost, against
+ * loading the whole level in one blocking frame. Spawning is the pooled stand in object so the times are the streamers own cost. */
+static void AddStreamingResults(BenchmarkSuite& suite)
+{
+	const std::string budgetName = "LevelStreamer 50k objects: budgeted frames";
+	const std::string flushName = "LevelStreamer 50k objects: blocking flush";
+	if (!suite.PassesFilter(budgetName) && !suite.PassesFilter(flushName)) return;
+
+	// Write a 2km square level with its objects scattered across 400 chunks.
+	const size_t objectCount = 50000;
+	const std::string levelPath = (std::filesystem::temp_directory_path() / "ReeeBenchmarkLevel.rlevel").string();
+	LevelFile level(100.0f);
+	std::mt19937 random(24680);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	for (size_t i = 0; i < objectCount; i++)
+	{
+		LevelObject object;
+		object.type = "StaticMeshObject";
+		object.name = "Rock";
+		object.location = Vector3D(position(random), 0.0f, position(random));
+		object.meshPath = "Assets/Meshes/Rock.obj";
+		level.AddObject(object);
+	}
+	if (!level.Save(levelPath))
+	{
+		std::cerr << "Failed to write " << levelPath << std::endl;
+		return;
+	}
+
+	// Spawn the stand in objects into a pool and handle table the way the world does.
+	HandleTable<SpawnedObject> handles;
+	std::vector<std::shared_ptr<SpawnedObject>> spawned;
+	spawned.reserve(objectCount);
+	auto spawn = [&handles, &spawned](const LevelObject& levelObject) -> ObjectHandle<GameObject>
+	{
+		spawned.push_back(std::allocate_shared<SpawnedObject>(PoolAllocator<SpawnedObject>(), levelObject.name));
+		SpawnedObject* object = spawned.back().get();
+		object->transform = Transform(levelObject.location, levelObject.rotation, levelObject.scale);
+		object->handle = handles.Add(object);
+		return ObjectHandle<GameObject>(object->handle.index, object->handle.generation);
+	};
+	auto destroy = [&handles](const ObjectHandle<GameObject>& handle)
+	{
+		handles.Remove(ObjectHandle<SpawnedObject>(handle.index, handle.generation));
+	};
+
+	// Load everything in range of the origin, the whole level, within the default budget.
+	LevelStreamingSettings settings;
+	settings.loadRadius = 1500.0f;
+	settings.unloadRadius = 1600.0f;
+	const Vector3D origin(0.0f);
+	if (suite.PassesFilter(budgetName))
+	{
+		LevelStreamer streamer(spawn, destroy);
+		streamer.SetSettings(settings);
+		streamer.Open(levelPath);
+		while (!streamer.IsReady() && !streamer.HasFailed()) std::this_thread::yield();
+		size_t frames = 0;
+		double totalMs = 0.0, peakMs = 0.0;
+		while (streamer.IsReady())
+		{
+			streamer.Update(origin);
+			const LevelStreamingStats& stats = streamer.GetStats();
+			if (stats.spawned + stats.destroyed > 0)
+			{
+				frames++;
+				totalMs += stats.updateMs;
+				peakMs = std::max(peakMs, (double)stats.updateMs);
+			}
+			if (streamer.IsIdle()) break;
+		}
+		if (spawned.size() != objectCount) std::cerr << "Streamed in " << spawned.size() << " of " << objectCount << " objects" << std::endl;
+		suite.AddFrameCost(budgetName, frames, frames ? totalMs / frames : 0.0, peakMs, settings.frameBudgetMs);
+		streamer.DestroyAll();
+		spawned.clear();
+	}
+	if (suite.PassesFilter(flushName))
+	{
+		LevelStreamer streamer(spawn, destroy);
+		streamer.SetSettings(settings);
+		streamer.Open(levelPath);
+		while (!streamer.IsReady() && !streamer.HasFailed()) std::this_thread::yield();
+		const auto start = std::chrono::steady_clock::now();
+		streamer.Flush(origin);
+		const double flushMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		suite.AddFrameCost(flushName, 1, flushMs, flushMs, 0.0);
+		streamer.DestroyAll();
+		spawned.clear();
+	}
+	std::remove(levelPath.c_str());
+}
+
+/* Measure the per frame cost of ticking 10k expensive amortized objects within the default budget and check every object gets its turn.
+ * Turns go round the objects in order carrying on from where the last frame stopped, so no object is ever more than one turn behind. */
+static void AddAmortizedTickResults(BenchmarkSuite& suite)
+{
+	const std::string name = "TickManager 10k amortized objects: default budget";
+	if (!suite.PassesFilter(name)) return;
+	const size_t objectCount = 10000, frameCount = 120;
+	TickSettings settings;
+	settings.canEverTick = true;
+	settings.amortized = true;
+	std::vector<std::unique_ptr<ScheduledObject>> objects;
+	BasicTickManager<ScheduledObject> ticks;
+	for (size_t i = 0; i < objectCount; i++)
+	{
+		objects.push_back(std::make_unique<ScheduledObject>("Object" + std::to_string(i), settings, 500));
+		ticks.Register(objects.back().get());
+	}
+
+	// The first tick builds the schedule of every object so is left out of the frame costs.
+	ticks.Tick(1.0f / 60.0f);
+	double totalMs = 0.0, peakMs = 0.0;
+	size_t totalTurns = ticks.GetStats().amortized;
+	for (size_t frame = 0; frame < frameCount; frame++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		ticks.Tick(1.0f / 60.0f);
+		const double frameMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		totalMs += frameMs;
+		peakMs = std::max(peakMs, frameMs);
+		totalTurns += ticks.GetStats().amortized;
+	}
+	const double budgetMs = ticks.GetAmortizedBudget() / 1000.0;
+	suite.AddFrameCost(name, frameCount, totalMs / frameCount, peakMs, budgetMs);
+	suite.AddCheck("TickManager: amortized objects keep to the budget on average", totalMs / frameCount <= budgetMs * 1.05,
+		std::to_string(totalMs / frameCount) + " ms mean against a " + std::to_string(budgetMs) + " ms budget");
+
+	uint32_t fewestTurns = ~0u, mostTurns = 0;
+	size_t objectTurns = 0;
+	for (const auto& object : objects)
+	{
+		fewestTurns = std::min(fewestTurns, object->tickCount);
+		mostTurns = std::max(mostTurns, object->tickCount);
+		objectTurns += object->tickCount;
+	}
+	suite.AddCounter(name + " (turns per object)", (double)totalTurns / objectCount);
+	suite.AddCounter(name + " (turns per frame)", (double)totalTurns / (frameCount + 1));
+	suite.AddCheck("TickManager: amortized objects share their turns evenly", fewestTurns > 0 && mostTurns - fewestTurns <= 1 && objectTurns == totalTurns,
+		std::to_string(fewestTurns) + " to " + std::to_string(mostTurns) + " turns per object, " + std::to_string(objectTurns) + " ticked against " +
+		std::to_string(totalTurns) + " counted");
+}
+
+/* Measure the worst error of the fast approximations against double precision references. */
+static void AddAccuracyResults(BenchmarkSuite& suite)
+{
+	const double range = SINCOS_ACCURATE_RANGE;
+	double sinError = 0.0, cosError = 0.0;
+	const int steps = 2000000;
+	for (int i = -steps; i <= steps; i++)
+	{
+		const float angle = (float)(range * i / steps);
+		float sinResult, cosResult;
+		ReeeMath::SinCos(angle, sinResult, cosResult);
+		sinError = std::max(sinError, std::abs(sinResult - std::sin((double)angle)));
+		cosError = std::max(cosError, std::abs(cosResult - std::cos((double)angle)));
+	}
+	suite.AddAccuracy("ReeeMath::SinCos sin", range, sinError);
+	suite.AddAccuracy("ReeeMath::SinCos cos", range, cosError);
+
+	double invSqrtError = 0.0;
+	for (int i = 1; i <= steps; i++)
+	{
+		const float value = (float)i * 0.001f;
+		invSqrtError = std::max(invSqrtError, std::abs(ReeeMath::InvSqrt(value) * std::sqrt((double)value) - 1.0));
+	}
+	suite.AddAccuracy("ReeeMath::InvSqrt relative", 2000.0, invSqrtError);
+
+	// Quaternion components against a double precision conversion.
+	double quaternionError = 0.0;
+	std::mt19937 random(54321);
+	std::uniform_real_distribution<float> degrees(-720.0f, 720.0f);
+	for (int i = 0; i < 100000; i++)
+	{
+		const Rotator rotator(degrees(random), degrees(random), degrees(random));
+		const double halfPitch = rotator.Pitch * (3.14159265358979323846 / 360.0);
+		const double halfYaw = rotator.Yaw * (3.14159265358979323846 / 360.0);
+		const double halfRoll = rotator.Roll * (3.14159265358979323846 / 360.0);
+		const double sp = std::sin(halfPitch), cp = std::cos(halfPitch);
+		const double sy = std::sin(halfYaw), cy = std::cos(halfYaw);
+		const double sr = std::sin(halfRoll), cr = std::cos(halfRoll);
+		const Quat result = rotator.ToQuaternion();
+		quaternionError = std::max(quaternionError, std::abs(result.X - (cy * sp * cr + sy * cp * sr)));
+		quaternionError = std::max(quaternionError, std::abs(result.Y - (sy * cp * cr - cy * sp * sr)));
+		quaternionError = std::max(quaternionError, std::abs(result.Z - (cy * cp * sr - sy * sp * cr)));
+		quaternionError = std::max(quaternionError, std::abs(result.W - (cy * cp * cr + sy * sp * sr)));
+	}
+	suite.AddAccuracy("Rotator::ToQuaternion", 720.0, quaternionError);
+}
+
+/* Vertex with the position and normal layout StaticMeshBatcher expects, the same as the engines Vertex. */
+struct CheckVertex
+{
+	struct { float x, y, z; } pos;
+	struct { float x, y, z; } n;
+};
+
+/* Check merging static meshes offsets indices, keeps mirrored faces in front, splits full batches and moves normals correctly. */
+static void AddStaticMeshBatcherChecks(BenchmarkSuite& suite)
+{
+	typedef StaticMeshBatcher<CheckVertex> Batcher;
+	if (!suite.PassesFilter("StaticMeshBatcher")) return;
+	const std::vector<CheckVertex> triangle = { { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, { { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } } };
+	const std::vector<Batcher::IndexType> triangleIndices = { 0, 1, 2 };
+
+	// A second mesh in the same batch indexes its own vertices past the first meshes.
+	{
+		Batcher batcher;
+		batcher.Add("Material", triangle, triangleIndices, Matrix4x4::Identity());
+		const size_t batch = batcher.Add("Material", triangle, triangleIndices, Matrix4x4::Translation(Vector3D(5.0f, 0.0f, 0.0f)));
+		const std::vector<Batcher::IndexType> expected = { 0, 1, 2, 3, 4, 5 };
+		const bool passed = batch == 0 && batcher.GetBatches().size() == 1 && batcher.GetBatches()[0].indices == expected &&
+			batcher.GetBatches()[0].vertices[3].pos.x == 5.0f;
+		suite.AddCheck("StaticMeshBatcher: indices offset past earlier meshes", passed, "second mesh indices or position wrong");
+	}
+
+	// Mirroring on one axis turns the triangle around so two of its corners are swapped to keep its front face.
+	{
+		Batcher batcher;
+		batcher.Add("Material", triangle, triangleIndices, Matrix4x4::Scaling(Vector3D(-1.0f, 1.0f, 1.0f)));
+		const std::vector<Batcher::IndexType> expected = { 0, 2, 1 };
+		suite.AddCheck("StaticMeshBatcher: mirrored matrix flips winding", batcher.GetBatches()[0].indices == expected, "winding not flipped");
+	}
+
+	// 65536 vertices fill a batch exactly, one more vertex starts a new batch and a mesh over the limit can not be merged.
+	{
+		Batcher batcher;
+		const std::vector<CheckVertex> halfBatch(Batcher::MaxBatchVertices / 2, triangle[0]);
+		const size_t first = batcher.Add("Material", halfBatch, triangleIndices, Matrix4x4::Identity());
+		const size_t second = batcher.Add("Material", halfBatch, triangleIndices, Matrix4x4::Identity());
+		const size_t third = batcher.Add("Material", triangle, triangleIndices, Matrix4x4::Identity());
+		const size_t other = batcher.Add("Other", triangle, triangleIndices, Matrix4x4::Identity());
+		const size_t tooLarge = batcher.Add("Material", std::vector<CheckVertex>(Batcher::MaxBatchVertices + 1, triangle[0]), triangleIndices, Matrix4x4::Identity());
+		const std::vector<Batcher::IndexType> expected = { 0, 1, 2, 32768, 32769, 32770 };
+		const bool passed = first == 0 && second == 0 && third == 1 && other == 2 && tooLarge == Batcher::InvalidBatch &&
+			batcher.GetBatches()[0].vertices.size() == Batcher::MaxBatchVertices && batcher.GetBatches()[0].indices == expected &&
+			batcher.GetBatches()[1].indices == triangleIndices;
+		suite.AddCheck("StaticMeshBatcher: new batch past 65536 vertices", passed, "batches " + std::to_string(first) + ", " + std::to_string(second) + ", " +
+			std::to_string(third) + ", " + std::to_string(other));
+	}
+
+	// Removing the middle of three meshes drops its geometry and moves the last one down, keeping its indices on its own vertices.
+	{
+		Batcher batcher;
+		size_t slots[3];
+		for (size_t i = 0; i < 3; i++) batcher.Add("Material", triangle, triangleIndices, Matrix4x4::Translation(Vector3D((float)i * 5.0f, 0.0f, 0.0f)), &slots[i]);
+		const bool removed = batcher.Remove(0, slots[1]);
+		const bool removedAgain = batcher.Remove(0, slots[1]);
+		const Batcher::Batch& batch = batcher.GetBatches()[0];
+		const std::vector<Batcher::IndexType> expected = { 0, 1, 2, 3, 4, 5 };
+		const bool moved = batch.vertices.size() == 6 && batch.vertices[3].pos.x == 10.0f && batch.indices == expected && batch.meshCount == 2 &&
+			batch.meshes[2].firstVertex == 3 && batch.meshes[2].firstIndex == 3;
+		const bool removedLast = batcher.Remove(0, slots[2]) && batcher.Remove(0, slots[0]) && batch.vertices.empty() && batch.indices.empty() && batch.meshCount == 0;
+		suite.AddCheck("StaticMeshBatcher: removed meshes leave their batch", removed && !removedAgain && moved && removedLast,
+			std::to_string(batch.vertices.size()) + " vertices and " + std::to_string(batch.indices.size()) + " indices left");
+	}
+
+	// A normal at 45 degrees stays perpendicular to its surface when the mesh is stretched along X, instead of following the stretch.
+	{
+		Batcher batcher;
+		std::vector<CheckVertex> slope = triangle;
+		for (CheckVertex& vertex : slope) vertex.n = { 0.70710678f, 0.70710678f, 0.0f };
+		batcher.Add("Material", slope, triangleIndices, Transform(Vector3D(1.0f, 2.0f, 3.0f), Rotator(0.0f), Vector3D(2.0f, 1.0f, 1.0f)).GetTransformAsMatrix());
+		const CheckVertex& vertex = batcher.GetBatches()[0].vertices[0];
+		const Vector3D expected = Vector3D(0.5f, 1.0f, 0.0f).GetNormal();
+		const bool passed = std::abs(vertex.n.x - expected.X) < 1e-4f && std::abs(vertex.n.y - expected.Y) < 1e-4f && std::abs(vertex.n.z) < 1e-4f &&
+			vertex.pos.x == 1.0f && vertex.pos.y == 2.0f && vertex.pos.z == 3.0f;
+		suite.AddCheck("StaticMeshBatcher: normals under non-uniform scale", passed, "normal " + std::to_string(vertex.n.x) + ", " + std::to_string(vertex.n.y) + ", " + std::to_string(vertex.n.z));
+	}
+}
+
+/* Check objects with random tick groups, prerequisites and threads always tick after their prerequisites and end up in the same state
+ * as ticking them one by one in group and registration order, for pools of 1 to 8 threads. */
+static void AddTickManagerChecks(BenchmarkSuite& suite)
+{
+	if (!suite.PassesFilter("TickManager")) return;
+	const size_t objectCount = 2000, frameCount = 10;
+	const float deltaTime = 1.0f / 60.0f;
+
+	// Every prerequisite is registered earlier in the same or an earlier group, so that order is a valid sequential tick order.
+	auto createObjects = [objectCount](std::vector<std::unique_ptr<ScheduledObject>>& objects)
+	{
+		std::mt19937 random(777);
+		for (size_t i = 0; i < objectCount; i++)
+		{
+			TickSettings settings;
+			settings.canEverTick = true;
+			settings.group = (TickGroup)(random() % TickGroupCount);
+			settings.runOnAnyThread = random() % 5 < 3;
+			objects.push_back(std::make_unique<ScheduledObject>("Object" + std::to_string(i), settings, 4));
+			for (size_t prerequisite = 0; i > 0 && prerequisite < 3; prerequisite++)
+			{
+				ScheduledObject* other = objects[random() % i].get();
+				if (other->tickSettings.group <= settings.group) objects.back()->tickPrerequisites.push_back(other);
+			}
+		}
+	};
+
+	// Sequential reference ticked group by group in registration order.
+	std::vector<std::unique_ptr<ScheduledObject>> reference;
+	createObjects(reference);
+	for (size_t frame = 0; frame < frameCount; frame++)
+	{
+		for (size_t group = 0; group < TickGroupCount; group++)
+		{
+			for (auto& object : reference)
+			{
+				if ((size_t)object->tickSettings.group == group) object->Tick(deltaTime);
+			}
+		}
+	}
+
+	for (unsigned int threadCount : { 1u, 2u, 4u, 8u })
+	{
+		WorkerPool pool(threadCount);
+		std::vector<std::unique_ptr<ScheduledObject>> objects;
+		createObjects(objects);
+		size_t warnings = 0, missedTicks = 0, orderErrors = 0, stateErrors = 0;
+		{
+			BasicTickManager<ScheduledObject> ticks;
+			ticks.SetWarningFunction([&warnings](const std::string&) { warnings++; });
+			for (auto& object : objects) ticks.Register(object.get());
+			for (size_t frame = 0; frame < frameCount; frame++)
+			{
+				ticks.Tick(deltaTime, &pool);
+				if (ticks.GetStats().ticked != objectCount) missedTicks++;
+			}
+		}
+		for (size_t i = 0; i < objectCount; i++)
+		{
+			orderErrors += objects[i]->orderErrors;
+			stateErrors += objects[i]->state != reference[i]->state || objects[i]->tickCount != frameCount ? 1 : 0;
+		}
+		suite.AddCheck("TickManager: prerequisites tick first and match sequential, " + std::to_string(threadCount) + " threads",
+			warnings == 0 && missedTicks == 0 && orderErrors == 0 && stateErrors == 0,
+			std::to_string(warnings) + " warnings, " + std::to_string(missedTicks) + " short frames, " + std::to_string(orderErrors) + " out of order, " +
+			std::to_string(stateErrors) + " states differ");
+	}
+}
+
+/* Check FrustumCuller finds exactly the boxes BoundingBox::IntersectsFrustum does for the 100k spatial boxes, with the benchmark
+ * camera and one looking diagonally, and with a count that leaves a tail short of eight boxes. */
+static void AddFrustumCullerChecks(BenchmarkSuite& suite, const SpatialInputs& spatial)
+{
+	if (!suite.PassesFilter("FrustumCuller")) return;
+	const Matrix4x4 diagonalView = Matrix4x4::LookToLH(Vector3D(100.0f, -50.0f, 20.0f), Vector3D(1.0f, 0.5f, -1.0f).GetNormal(), Vector3D(0.0f, 1.0f, 0.0f));
+	const Frustum diagonal(diagonalView * Matrix4x4::PerspectiveFovLH(1.2f, 4.0f / 3.0f, 1.0f, 600.0f));
+
+	// End the partial count on a visible box so the tail has something to find.
+	size_t partialCount = spatial.bounds.size() - 1;
+	while (partialCount > 0 && (partialCount % 8 == 0 || !spatial.bounds[partialCount - 1].IntersectsFrustum(spatial.frustum))) partialCount--;
+	const struct { const char* name; const Frustum& frustum; size_t count; } cases[] =
+	{
+		{ "benchmark camera", spatial.frustum, spatial.bounds.size() },
+		{ "diagonal camera", diagonal, spatial.bounds.size() },
+		{ "benchmark camera, partial last group", spatial.frustum, partialCount }
+	};
+	for (const auto& test : cases)
+	{
+		FrustumCuller culler;
+		const size_t visibleCount = culler.Cull(test.frustum, spatial.bounds.data(), test.count);
+		size_t mismatches = 0, expectedCount = 0, firstMismatch = test.count;
+		for (size_t i = 0; i < test.count; i++)
+		{
+			const bool expected = spatial.bounds[i].IntersectsFrustum(test.frustum);
+			expectedCount += expected ? 1 : 0;
+			if (culler.IsVisible(i) == expected) continue;
+			if (mismatches++ == 0) firstMismatch = i;
+		}
+		const bool passed = mismatches == 0 && visibleCount == expectedCount && culler.GetStats().visible == expectedCount &&
+			culler.GetStats().culled == test.count - expectedCount && expectedCount > 0 && expectedCount < test.count;
+		suite.AddCheck(std::string("FrustumCuller: matches IntersectsFrustum for 100k boxes, ") + test.name, passed,
+			std::to_string(mismatches) + " boxes differ, first at " + std::to_string(firstMismatch) + ", " + std::to_string(visibleCount) +
+			" visible against " + std::to_string(expectedCount));
+	}
+}
+
+/* What a recorded draw was submitted with, pointed to by its packet in place of a renderable. */
+struct RecordedDraw
+{
+	uint32_t shader, texture, mesh;
+	float depth;
+	bool drawn;
+};
+
+/* Check executing shuffled opaque draws through a RecordingRenderBackend draws each once, changes shader, texture and mesh only once
+ * per distinct state and draws each state front to back. Depths are rounded to the precision of the sort key so every depth sorts apart. */
+static void AddRenderQueueChecks(BenchmarkSuite& suite)
+{
+	if (!suite.PassesFilter("RenderQueue")) return;
+	const size_t drawCount = 10000;
+	std::mt19937 random(97531);
+	std::uniform_int_distribution<uint32_t> shader(0, 3);
+	std::uniform_int_distribution<uint32_t> material(0, 499);
+	std::uniform_real_distribution<float> depth(0.1f, 5000.0f);
+	std::vector<RecordedDraw> draws(drawCount);
+	std::vector<std::tuple<uint32_t, uint32_t, uint32_t>> states;
+	for (RecordedDraw& draw : draws)
+	{
+		const uint32_t mesh = material(random);
+		float drawDepth = depth(random);
+		uint32_t depthBits;
+		std::memcpy(&depthBits, &drawDepth, sizeof(depthBits));
+		depthBits &= ~((1u << (32 - RenderQueue::DepthBits)) - 1);
+		std::memcpy(&drawDepth, &depthBits, sizeof(drawDepth));
+		draw = { shader(random), mesh / 2, mesh, drawDepth, false };
+		states.emplace_back(draw.shader, draw.texture, draw.mesh);
+	}
+
+	// Each distinct shader, shader and texture, and full state is switched to exactly once.
+	std::sort(states.begin(), states.end());
+	size_t expectedShaders = 0, expectedTextures = 0, expectedMeshes = 0;
+	for (size_t i = 0; i < states.size(); i++)
+	{
+		const bool first = i == 0;
+		expectedShaders += first || std::get<0>(states[i]) != std::get<0>(states[i - 1]) ? 1 : 0;
+		expectedTextures += first || std::get<0>(states[i]) != std::get<0>(states[i - 1]) || std::get<1>(states[i]) != std::get<1>(states[i - 1]) ? 1 : 0;
+		expectedMeshes += first || states[i] != states[i - 1] ? 1 : 0;
+	}
+
+	std::vector<size_t> order(drawCount);
+	for (size_t i = 0; i < drawCount; i++) order[i] = i;
+	std::shuffle(order.begin(), order.end(), random);
+	RenderQueue queue;
+	for (size_t index : order)
+	{
+		const RecordedDraw& draw = draws[index];
+		queue.Submit(RenderQueue::MakeKey(RenderPass::Opaque, draw.shader, draw.texture, draw.mesh, draw.depth), (const RenderableMesh*)&draw);
+	}
+	queue.Sort();
+	RecordingRenderBackend backend;
+	queue.Execute(backend);
+
+	// Walk the recorded draws by what they were submitted with rather than by their keys.
+	size_t repeats = 0, shaderChanges = 0, textureChanges = 0, meshChanges = 0, depthErrors = 0;
+	const RecordedDraw* last = nullptr;
+	for (const DrawPacket& packet : backend.draws)
+	{
+		RecordedDraw& draw = *(RecordedDraw*)packet.renderable;
+		repeats += draw.drawn ? 1 : 0;
+		draw.drawn = true;
+		const bool newShader = !last || draw.shader != last->shader;
+		const bool newTexture = newShader || draw.texture != last->texture;
+		const bool newMesh = newTexture || draw.mesh != last->mesh;
+		shaderChanges += newShader ? 1 : 0;
+		textureChanges += newTexture ? 1 : 0;
+		meshChanges += newMesh ? 1 : 0;
+		depthErrors += !newMesh && draw.depth < last->depth ? 1 : 0;
+		last = &draw;
+	}
+	const RenderQueueStats& stats = queue.GetStats();
+	const bool passed = backend.draws.size() == drawCount && repeats == 0 && shaderChanges == expectedShaders && textureChanges == expectedTextures &&
+		meshChanges == expectedMeshes && depthErrors == 0 && stats.draws == drawCount && stats.shaderChanges == expectedShaders &&
+		stats.textureChanges == expectedTextures && stats.meshChanges == expectedMeshes;
+	suite.AddCheck("RenderQueue: shuffled opaque draws execute grouped by state and front to back", passed,
+		std::to_string(backend.draws.size()) + " draws, " + std::to_string(repeats) + " repeated, shader/texture/mesh changes " + std::to_string(shaderChanges) + "/" +
+		std::to_string(textureChanges) + "/" + std::to_string(meshChanges) + " recorded, " + std::to_string(stats.shaderChanges) + "/" +
+		std::to_string(stats.textureChanges) + "/" + std::to_string(stats.meshChanges) + " counted against " + std::to_string(expectedShaders) + "/" +
+		std::to_string(expectedTextures) + "/" + std::to_string(expectedMeshes) + ", " + std::to_string(depthErrors) + " out of depth order");
+}
+
+/* Check replaying the binds of two meshes sharing their shaders through a RecordingPipelineDevice only lets the changed binds through,
+ * drops everything when a mesh is drawn twice and counts both once the frame ends. */
+static void AddPipelineStateCacheChecks(BenchmarkSuite& suite)
+{
+	if (!suite.PassesFilter("PipelineStateCache")) return;
+	typedef RecordingPipelineDevice::Call Call;
+	static const uint8_t shaders[3] = {}, sampler = 0, transformBuffer = 0, firstMesh = 0, secondMesh = 0;
+	const void* vertexShader = &shaders[0];
+	const void* pixelShader = &shaders[1];
+	const void* layout = &shaders[2];
+
+	// The binds of a mesh draw, its own buffers and texture plus the shaders, layout and other state every unlit mesh shares.
+	RecordingPipelineDevice device;
+	auto bindMesh = [&](const void* mesh, uint64_t topology)
+	{
+		device.Bind(PipelineBindType::VertexBuffer, 0u, mesh, 32u);
+		device.Bind(PipelineBindType::IndexBuffer, 0u, mesh);
+		device.Bind(PipelineBindType::Topology, 0u, nullptr, topology);
+		device.Bind(PipelineBindType::VertexShader, 0u, vertexShader);
+		device.Bind(PipelineBindType::PixelShader, 0u, pixelShader);
+		device.Bind(PipelineBindType::InputLayout, 0u, layout);
+		device.Bind(PipelineBindType::VertexConstantBuffer, 0u, &transformBuffer);
+		device.Bind(PipelineBindType::PixelShaderResource, 0u, mesh);
+		device.Bind(PipelineBindType::PixelSampler, 0u, &sampler);
+	};
+	bindMesh(&firstMesh, 4u);
+	bindMesh(&firstMesh, 4u);
+	bindMesh(&secondMesh, 2u);
+	device.Bind(PipelineBindType::PixelShaderResource, PipelineStateCache::MaxSlots, &secondMesh);
+	device.cache.EndFrame();
+
+	// The first draw binds everything, drawing it again binds nothing and the second mesh, drawn as lines, only binds its own buffers
+	// and texture and the topology. Slots past the tracked ones always get through.
+	const std::vector<Call> expected =
+	{
+		{ PipelineBindType::VertexBuffer, 0u, &firstMesh, 32u }, { PipelineBindType::IndexBuffer, 0u, &firstMesh, 0u },
+		{ PipelineBindType::Topology, 0u, nullptr, 4u }, { PipelineBindType::VertexShader, 0u, vertexShader, 0u },
+		{ PipelineBindType::PixelShader, 0u, pixelShader, 0u }, { PipelineBindType::InputLayout, 0u, layout, 0u },
+		{ PipelineBindType::VertexConstantBuffer, 0u, &transformBuffer, 0u }, { PipelineBindType::PixelShaderResource, 0u, &firstMesh, 0u },
+		{ PipelineBindType::PixelSampler, 0u, &sampler, 0u },
+		{ PipelineBindType::VertexBuffer, 0u, &secondMesh, 32u }, { PipelineBindType::IndexBuffer, 0u, &secondMesh, 0u },
+		{ PipelineBindType::Topology, 0u, nullptr, 2u }, { PipelineBindType::PixelShaderResource, 0u, &secondMesh, 0u },
+		{ PipelineBindType::PixelShaderResource, PipelineStateCache::MaxSlots, &secondMesh, 0u }
+	};
+	bool callsMatch = device.calls.size() == expected.size();
+	for (size_t i = 0; callsMatch && i < expected.size(); i++)
+	{
+		const Call& call = device.calls[i];
+		callsMatch = call.type == expected[i].type && call.slot == expected[i].slot && call.object == expected[i].object && call.extra == expected[i].extra;
+	}
+	const PipelineBindStats stats = device.cache.GetStats();
+	const PipelineBindStats nextFrame = device.cache.GetFrameStats();
+
+	// Ending the frame forgets what was bound so the next frame binds the second mesh again.
+	device.calls.clear();
+	bindMesh(&secondMesh, 2u);
+	const bool passed = callsMatch && stats.issued == 14 && stats.skipped == 14 && nextFrame.issued == 0 && nextFrame.skipped == 0 && device.calls.size() == 9;
+	suite.AddCheck("PipelineStateCache: two mesh bind replay through RecordingPipelineDevice", passed,
+		std::string(callsMatch ? "calls match" : "calls differ") + ", " + std::to_string(stats.issued) + " issued and " + std::to_string(stats.skipped) +
+		" skipped against 14 and 14, " + std::to_string(device.calls.size()) + " binds after the frame ended against 9");
+}
+
+/* A draw given to the instance batcher check, pointed to by its packet in place of a renderable. Draws only instance with draws of the
+ * same material, standing in for meshes whose ids share key bits. */
+struct BatchedDraw
+{
+	Matrix4x4 model;
+	uint32_t material;
+};
+
+/* Multiply two matrices one float at a time and transpose the result, as a reference for the instance transforms. */
+static void MultiplyTransposed(const Matrix4x4& a, const Matrix4x4& b, float result[16])
+{
+	float left[16], right[16];
+	std::memcpy(left, &a, sizeof(left));
+	std::memcpy(right, &b, sizeof(right));
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			double sum = 0.0;
+			for (int k = 0; k < 4; k++) sum += (double)left[row * 4 + k] * right[k * 4 + column];
+			result[column * 4 + row] = (float)sum;
+		}
+	}
+}
+
+/* Returns if a matrix matches reference floats to within float rounding of their size. */
+static bool MatchesReference(const Matrix4x4& matrix, const float reference[16])
+{
+	float values[16];
+	std::memcpy(values, &matrix, sizeof(values));
+	for (int i = 0; i < 16; i++)
+	{
+		if (std::abs(values[i] - reference[i]) > 1e-4f * std::max(1.0f, std::abs(reference[i]))) return false;
+	}
+	return true;
+}
+
+/* Check InstanceBatcher::Build covers every sorted draw once in order, never batches past MaxInstances or across states and materials,
+ * merges every run it can and builds each instances transforms as (model * view)^T and (model * view * projection)^T. */
+static void AddInstanceBatcherChecks(BenchmarkSuite& suite)
+{
+	if (!suite.PassesFilter("InstanceBatcher")) return;
+
+	// Every shader and mesh pair gets a few draws, one or many, with one state long enough to be split and one with two materials.
+	std::mt19937 random(8642);
+	std::uniform_real_distribution<float> position(-400.0f, 400.0f);
+	std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+	std::uniform_real_distribution<float> scale(0.5f, 3.0f);
+	const uint32_t runLengths[] = { 1, 3, 50, 300 };
+	std::vector<BatchedDraw> draws;
+	std::vector<std::pair<uint32_t, uint32_t>> drawStates;
+	for (uint32_t shader = 0; shader < 3; shader++)
+	{
+		for (uint32_t mesh = 0; mesh < 6; mesh++)
+		{
+			const uint32_t runLength = shader == 1 && mesh == 1 ? 2500 : (shader == 0 && mesh == 0 ? 200 : runLengths[random() % 4]);
+			for (uint32_t i = 0; i < runLength; i++)
+			{
+				const Vector3D location(position(random) + 410.0f, position(random), position(random));
+				const Quat rotation = Quat::FromRotator(Rotator(angle(random), angle(random), angle(random)));
+				draws.push_back({ Matrix4x4::Compose(Vector3D(scale(random), scale(random), scale(random)), rotation, location), shader == 0 && mesh == 0 ? (uint32_t)(random() % 2) : 0u });
+				drawStates.emplace_back(shader, mesh);
+			}
+		}
+	}
+	std::vector<size_t> order(draws.size());
+	for (size_t i = 0; i < order.size(); i++) order[i] = i;
+	std::shuffle(order.begin(), order.end(), random);
+	RenderQueue queue;
+	for (size_t index : order)
+	{
+		const Vector3D location(draws[index].model.Rows[3]);
+		queue.Submit(RenderQueue::MakeKey(RenderPass::Opaque, drawStates[index].first, drawStates[index].second, drawStates[index].second, location.X), (const RenderableMesh*)&draws[index]);
+	}
+	queue.Sort();
+	const Matrix4x4 view = Matrix4x4::LookToLH(Vector3D(0.0f, 10.0f, -20.0f), Vector3D(1.0f, -0.1f, 0.2f).GetNormal(), Vector3D(0.0f, 1.0f, 0.0f));
+	const Matrix4x4 projection = Matrix4x4::PerspectiveFovLH(1.0f, 16.0f / 9.0f, 0.1f, 2000.0f);
+	InstanceBatcher batcher;
+	auto getDraw = [](const DrawPacket& packet) -> const BatchedDraw& { return *(const BatchedDraw*)packet.renderable; };
+	batcher.Build(queue.GetPackets(), view, projection, [&getDraw](const DrawPacket& packet) { return getDraw(packet).model; },
+		[&getDraw](const DrawPacket& first, const DrawPacket& other) { return getDraw(first).material == getDraw(other).material; });
+
+	const std::vector<DrawPacket>& packets = queue.GetPackets();
+	const std::vector<InstanceTransform>& instances = batcher.GetInstances();
+	size_t nextPacket = 0, nextInstance = 0, gaps = 0, oversized = 0, mixed = 0, unmerged = 0, transformErrors = 0, instanceCount = 0, singleCount = 0;
+	const InstanceBatch* last = nullptr;
+	for (const InstanceBatch& batch : batcher.GetBatches())
+	{
+		gaps += batch.firstPacket != nextPacket || batch.count == 0 ? 1 : 0;
+		oversized += batch.count > InstanceBatcher::MaxInstances ? 1 : 0;
+		nextPacket = batch.firstPacket + batch.count;
+		if (nextPacket > packets.size()) break;
+		const DrawPacket& first = packets[batch.firstPacket];
+		for (uint32_t i = 1; i < batch.count; i++)
+		{
+			const DrawPacket& packet = packets[batch.firstPacket + i];
+			mixed += !RenderQueue::IsSameState(first.key, packet.key) || getDraw(first).material != getDraw(packet).material ? 1 : 0;
+		}
+
+		// A batch short of the limit followed by one that could have joined it missed a merge.
+		if (last && last->count < InstanceBatcher::MaxInstances)
+		{
+			const DrawPacket& previous = packets[last->firstPacket];
+			unmerged += RenderQueue::IsSameState(previous.key, first.key) && getDraw(previous).material == getDraw(first).material ? 1 : 0;
+		}
+		last = &batch;
+
+		if (batch.count < InstanceBatcher::MinInstances)
+		{
+			singleCount += batch.count;
+			continue;
+		}
+		gaps += batch.firstInstance != nextInstance ? 1 : 0;
+		nextInstance = batch.firstInstance + batch.count;
+		instanceCount += batch.count;
+		for (uint32_t i = 0; i < batch.count && batch.firstInstance + i < instances.size(); i++)
+		{
+			const Matrix4x4& model = getDraw(packets[batch.firstPacket + i]).model;
+			float modelView[16], modelViewProjection[16];
+			MultiplyTransposed(model, view, modelView);
+			MultiplyTransposed(model * view, projection, modelViewProjection);
+			const InstanceTransform& instance = instances[batch.firstInstance + i];
+			transformErrors += MatchesReference(instance.modelView, modelView) && MatchesReference(instance.modelViewProj, modelViewProjection) ? 0 : 1;
+		}
+	}
+	const InstancingStats& stats = batcher.GetStats();
+	const bool passed = nextPacket == packets.size() && nextInstance == instances.size() && gaps == 0 && oversized == 0 && mixed == 0 && unmerged == 0 &&
+		transformErrors == 0 && stats.instances == instanceCount && stats.singleDraws == singleCount && instanceCount + singleCount == packets.size();
+	suite.AddCheck("InstanceBatcher: batches cover every draw once without mixing states and build each instance transform", passed,
+		std::to_string(nextPacket) + " of " + std::to_string(packets.size()) + " draws covered, " + std::to_string(gaps) + " gaps, " + std::to_string(oversized) +
+		" over the limit, " + std::to_string(mixed) + " mixed, " + std::to_string(unmerged) + " unmerged, " + std::to_string(transformErrors) + " wrong transforms");
+}
+
+int main(int argc, char** argv)
+{
+	// Read the command line options.
+	std::string outputPath, filter;
+	size_t samples = 15;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) outputPath = argv[++i];
+		else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) samples = (size_t)std::strtoul(argv[++i], nullptr, 10);
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) filter = argv[++i];
+		else
+		{
+			std::cerr << "Usage: " << argv[0] << " [--out file.json] [--samples count] [--filter name]" << std::endl;
+			return 1;
+		}
+	}
+
+	// Setup and run every benchmark.
+	BenchmarkInputs inputs;
+	VectorStreamInputs vectorStream;
+	HierarchyInputs hierarchy(inputs);
+	std::vector<std::unique_ptr<ScalingScene>> scalingScenes;
+	scalingScenes.push_back(std::make_unique<ScalingScene>(1000, inputs));
+	scalingScenes.push_back(std::make_unique<ScalingScene>(10000, inputs));
+	std::vector<std::unique_ptr<WorkerPool>> pools;
+	for (unsigned int threadCount : { 1u, 2u, 4u, 8u, 16u }) pools.push_back(std::make_unique<WorkerPool>(threadCount));
+	TickInputs tickInputs;
+	EntityInputs entityInputs(inputs);
+	ChurnInputs churnInputs;
+	SpatialInputs spatialInputs;
+	RenderQueueInputs renderInputs;
+	InstancingInputs instancingInputs;
+	BenchmarkSuite suite("ReeeEngine Math", samples);
+	suite.SetFilter(filter);
+	AddReeeMathBenchmarks(suite, inputs);
+	AddVectorBenchmarks(suite, inputs);
+	AddVectorStreamBenchmarks(suite, vectorStream);
+	AddTransformBenchmarks(suite, inputs);
+	AddHierarchyBenchmarks(suite, hierarchy);
+	AddScalingBenchmarks(suite, scalingScenes, pools);
+	AddTickBenchmarks(suite, tickInputs, pools);
+	AddEntityBenchmarks(suite, entityInputs);
+	AddChurnBenchmarks(suite, churnInputs);
+	AddSpatialBenchmarks(suite, spatialInputs);
+	AddRenderQueueBenchmarks(suite, renderInputs, instancingInputs);
+	AddAccuracyResults(suite);
+	AddStreamingResults(suite);
+	AddAmortizedTickResults(suite);
+	AddEntityStoreChecks(suite);
+	AddStaticMeshBatcherChecks(suite);
+	AddTickManagerChecks(suite);
+	AddFrustumCullerChecks(suite, spatialInputs);
+	AddRenderQueueChecks(suite);
+	AddPipelineStateCacheChecks(suite);
+	AddInstanceBatcherChecks(suite);
+	suite.Run();
+
+	// Report any failed checks.
+	for (const CheckResult& check : suite.GetChecks())
+	{
+		if (!check.passed) std::cerr << "Check failed: " << check.name << " (" << check.detail << ")" << std::endl;
+	}
+	const int exitCode = suite.HasFailedChecks() ? 1 : 0;
+
+	// Write the results.
+	if (outputPath.empty())
+	{
+		suite.WriteJson(std::cout, GetSimdPath());
+		return exitCode;
+	}
+	std::ofstream file(outputPath);
+	if (!file)
+	{
+		std::cerr << "Failed to open " << outputPath << std::endl;
+		return 1;
+	}
+	suite.WriteJson(file, GetSimdPath());
+	return exitCode;
+}
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <ReeeEngine.h>
 #include "..\..\World\GameObjects\StaticMeshObject.h"
 #include "GameObjects\PlayerObject.h"
+#include "GameObjects\PlayerFollowObject.h"
 
 /* Extended application class for this app from the ReeeEngine. */
 class EngineApp : public ReeeEngine::Application
@@ -21,6 +22,7 @@ private:
 	ReeeEngine::Pointer<ReeeEngine::StaticMeshObject> skybox;
 	ReeeEngine::Pointer<ReeeEngine::StaticMeshObject> road;
 	ReeeEngine::Pointer<PlayerObject> player;
+	ReeeEngine::Pointer<PlayerFollowObject> playerFollow;
 
 	/* Ran on engine frame. */
 	virtual void Tick(float deltaTime) override;
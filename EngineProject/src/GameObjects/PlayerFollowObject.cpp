@@ -0,0 +1,49 @@
+#include "PlayerFollowObject.h"
+#include "..\..\World\World.h"
+#include "..\..\World\Components\CameraComponent.h"
+#include "ReeeEngine/Application.h"
+
+PlayerFollowObject::PlayerFollowObject(const std::string& name) : ReeeEngine::GameObject(name)
+{
+	// Ticks once the player has moved.
+	tickSettings.canEverTick = true;
+	tickSettings.group = ReeeEngine::TickGroup::PostUpdate;
+}
+
+PlayerFollowObject::~PlayerFollowObject()
+{
+
+}
+
+void PlayerFollowObject::SetFollowTargets(ReeeEngine::Pointer<PlayerObject> newPlayer, ReeeEngine::Pointer<ReeeEngine::StaticMeshObject> newSkybox)
+{
+	if (player) RemoveTickPrerequisite(player.get());
+	player = newPlayer;
+	skybox = newSkybox;
+	if (player) AddTickPrerequisite(player.get());
+}
+
+void PlayerFollowObject::LevelStart()
+{
+	ReeeEngine::GameObject::LevelStart();
+
+}
+
+void PlayerFollowObject::Tick(float deltaTime)
+{
+	ReeeEngine::GameObject::Tick(deltaTime);
+	if (!player) return;
+
+	// Update the engine light to the front of the car and keep the skybox around it.
+	ReeeEngine::World* world = ReeeEngine::Application::GetWorld();
+	ReeeEngine::Transform playerTransform = player->GetWorldTransform();
+	world->SetLightWorldPosition((playerTransform.GetLocation() + ReeeEngine::Vector3D(0.0f, 2.0f, 0.0f)) + (playerTransform.GetForwardVector() * 15.0f));
+	if (skybox) skybox->SetWorldLocation(playerTransform.GetLocation());
+
+	// Keep the camera gimbal level behind the car while it is being steered.
+	auto& openCVInput = ReeeEngine::Application::GetOpenCVInput();
+	if (openCVInput && openCVInput->IsInitialised())
+	{
+		world->GetActiveCamera().SetWorldLocationAndRotation(playerTransform.GetLocation() + ReeeEngine::Vector3D(0.0f, 2.0f, -5.0f), ReeeEngine::Rotator(8.0f, 0.0f, 0.0f));
+	}
+}
\ No newline at end of file
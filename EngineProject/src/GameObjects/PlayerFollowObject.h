@@ -0,0 +1,29 @@
+#pragma once
+#include "..\..\World\GameObjects\StaticMeshObject.h"
+#include "PlayerObject.h"
+
+/* Moves the light, skybox and camera gimbal along with the player car for the driving game demo.
+ * NOTE: Ticks after the player each frame so everything following it uses the cars position for this frame. */
+class PlayerFollowObject : public ReeeEngine::GameObject
+{
+public:
+
+	/* Constructor and destructor. */
+	PlayerFollowObject(const std::string& name);
+	~PlayerFollowObject();
+
+	/* Set the player to follow and the skybox to keep around it, the player is made a prerequisite of this objects tick. */
+	void SetFollowTargets(ReeeEngine::Pointer<PlayerObject> newPlayer, ReeeEngine::Pointer<ReeeEngine::StaticMeshObject> newSkybox);
+
+	/* Level start function. */
+	virtual void LevelStart() override;
+
+	/* Ticking function. */
+	virtual void Tick(float deltaTime) override;
+
+private:
+
+	// Objects moved along with.
+	ReeeEngine::Pointer<PlayerObject> player;
+	ReeeEngine::Pointer<ReeeEngine::StaticMeshObject> skybox;
+};
\ No newline at end of file
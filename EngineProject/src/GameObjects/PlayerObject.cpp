@@ -1,8 +1,13 @@
 #include "PlayerObject.h"
 #include "..\..\World\Components\MeshComponent.h"
+#include "ReeeEngine/Application.h"
 
 PlayerObject::PlayerObject(const std::string& name) : ReeeEngine::StaticMeshObject(name)
 {
+	// Ticks before everything else to drive and steer the car so anything following it sees where it is this frame.
+	tickSettings.canEverTick = true;
+	tickSettings.group = ReeeEngine::TickGroup::PrePhysics;
+
 	// Setup player mesh.
 	GetStaticMesh().SetStaticMesh("../Assets/PlayerCar", 1.0f, false);
 	GetStaticMesh().SetRelativeRotation(ReeeEngine::Rotator(0.0f, 90.0f, 0.0f));
@@ -25,4 +30,21 @@ void PlayerObject::Tick(float deltaTime)
 
 	// While the game loop is player move the car forward.
 	SetWorldLocation(GetWorldTransform().GetForwardVector() * (driveSpeed * deltaTime), true);
+
+	// Check the OpenCV input and add rotation to the car.
+	auto& openCVInput = ReeeEngine::Application::GetOpenCVInput();
+	if (openCVInput && openCVInput->IsInitialised())
+	{
+		SetWorldRotation(ReeeEngine::Rotator(0.0f, openCVInput->GetHeightDiffernce() * turnSpeed, 0.0f), true);
+
+		// Clamp rotation of car.
+		ReeeEngine::Rotator currPlayerRot = GetWorldRotation();
+		float clampedRot = ReeeEngine::ReeeMath::Clamp(currPlayerRot.Yaw, -20.0f, 20.0f);
+		SetWorldRotation(ReeeEngine::Rotator(currPlayerRot.Pitch, clampedRot, currPlayerRot.Roll));
+	}
+
+	// Clamp the player within the barriers.
+	ReeeEngine::Vector3D currPlayerLoc = GetWorldLocation();
+	float clampedPosition = ReeeEngine::ReeeMath::Clamp(currPlayerLoc.X, -2.0f, 2.0f);
+	SetWorldLocation(ReeeEngine::Vector3D(clampedPosition, currPlayerLoc.Y, currPlayerLoc.Z));
 }
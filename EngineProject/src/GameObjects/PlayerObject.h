@@ -21,5 +21,6 @@ private:
 
 	// Movement variables.
 	float driveSpeed = 15.0f;
+	float turnSpeed = 1.0f;
 };
 
@@ -32,8 +32,9 @@ namespace ReeeEngine
 		// Catch any unhandled exceptions from the engine while running.
 		try
 		{
-			// Run begin first and once.
+			// Run begin first and once, then start the level once the app has spawned its objects.
 			Init();
+			world->LevelStart();
 
 			// Enter infinite loop.
 			while (appRunning)
@@ -79,7 +80,6 @@ namespace ReeeEngine
 		engineWindow = CreateReff<Window>(1280, 720, "Reee Editor");
 		auto delegateDispatcher = BIND_DELEGATE(Application::OnDelegate);
 		engineWindow->SetDelegateBroadcastEvent(delegateDispatcher);
-		world->LevelStart();
 		
 		// Initalise the imgui module.
 		userInterface = new UserInterfaceModule();
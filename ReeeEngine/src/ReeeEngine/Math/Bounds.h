@@ -0,0 +1,610 @@
+#pragma once
+#include "ReeeMath.h"
+#include "VectorRegister.h"
+#include "VectorBatch.h"
+#include "Vector3D.h"
+#include "Matrix4x4.h"
+#include "Frustum.h"
+#include <cstdint>
+
+namespace ReeeEngine
+{
+	struct BoundingSphere;
+
+	/* Axis aligned bounding box declaration.
+	 * NOTE: A default constructed box is empty (min above max) so it can be grown with Expand. */
+	struct alignas(16) BoundingBox
+	{
+	public:
+
+		/* Structure variables. */
+		Vector3D Min;
+		Vector3D Max;
+
+	public:
+
+		/* Default constructor's. */
+		BoundingBox() : Min(BIG_NUMBER), Max(-BIG_NUMBER) {}
+		BoundingBox(const Vector3D& min, const Vector3D& max) : Min(min), Max(max) {}
+
+		/* Create a box from its center and half size. */
+		static BoundingBox FromCenterExtents(const Vector3D& center, const Vector3D& extents)
+		{
+			const VectorRegister centerReg = center.ToRegister();
+			const VectorRegister extentsReg = extents.ToRegister();
+			return BoundingBox(Vector3D(VectorSubtract(centerReg, extentsReg)), Vector3D(VectorAdd(centerReg, extentsReg)));
+		}
+
+		/* Create a box around count positions read with a byte stride. Returns an empty box if there are no positions. */
+		static BoundingBox FromPoints(const float* positions, size_t stride, size_t count)
+		{
+			BoundingBox result;
+			if (!VectorBatch::ComputeBounds(positions, stride, count, result.Min, result.Max)) return BoundingBox();
+			return result;
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Bounding Box Functions				//
+		//////////////////////////////////////////////////////////////
+
+		/* Returns if the box contains anything. */
+		bool IsValid() const
+		{
+			return Min.X <= Max.X && Min.Y <= Max.Y && Min.Z <= Max.Z;
+		}
+
+		/* Returns the center of the box. */
+		Vector3D GetCenter() const
+		{
+			return Vector3D(VectorSetW(VectorMultiply(VectorAdd(Min.ToRegister(), Max.ToRegister()), VectorSetAll(0.5f)), 0.0f));
+		}
+
+		/* Returns the half size of the box. */
+		Vector3D GetExtents() const
+		{
+			return Vector3D(VectorSetW(VectorMultiply(VectorSubtract(Max.ToRegister(), Min.ToRegister()), VectorSetAll(0.5f)), 0.0f));
+		}
+
+		/* Returns the full size of the box. */
+		Vector3D GetSize() const
+		{
+			return Vector3D(VectorSetW(VectorSubtract(Max.ToRegister(), Min.ToRegister()), 0.0f));
+		}
+
+		/* Grow the box to include a point. */
+		void Expand(const Vector3D& point)
+		{
+			const VectorRegister pointReg = point.ToRegister();
+			Min = Vector3D(VectorMin(Min.ToRegister(), pointReg));
+			Max = Vector3D(VectorMax(Max.ToRegister(), pointReg));
+		}
+
+		/* Grow the box to include another box. */
+		void Expand(const BoundingBox& other)
+		{
+			Min = Vector3D(VectorMin(Min.ToRegister(), other.Min.ToRegister()));
+			Max = Vector3D(VectorMax(Max.ToRegister(), other.Max.ToRegister()));
+		}
+
+		/* Returns if a point is inside the box. */
+		bool ContainsPoint(const Vector3D& point) const
+		{
+			return point.X >= Min.X && point.X <= Max.X && point.Y >= Min.Y && point.Y <= Max.Y && point.Z >= Min.Z && point.Z <= Max.Z;
+		}
+
+		/* Returns if this box overlaps another box. */
+		bool Intersects(const BoundingBox& other) const
+		{
+			return Min.X <= other.Max.X && Max.X >= other.Min.X && Min.Y <= other.Max.Y && Max.Y >= other.Min.Y && Min.Z <= other.Max.Z && Max.Z >= other.Min.Z;
+		}
+
+		/* Returns if this box overlaps a sphere. Defined after BoundingSphere. */
+		bool Intersects(const BoundingSphere& sphere) const;
+
+		/* Returns if the box is at least partly inside a frustum. */
+		bool IntersectsFrustum(const Frustum& frustum) const
+		{
+			return frustum.IntersectsBox(GetCenter(), GetExtents());
+		}
+
+		/* Returns the squared distance from a point to the closest point on the box. Zero if the point is inside. */
+		float GetDistanceSquared(const Vector3D& point) const
+		{
+			const VectorRegister pointReg = point.ToRegister();
+			const VectorRegister closest = VectorMin(VectorMax(pointReg, Min.ToRegister()), Max.ToRegister());
+			const VectorRegister offset = VectorSubtract(pointReg, closest);
+			return VectorGetX(VectorDot3(offset, offset));
+		}
+
+		/* Returns the axis aligned box that contains this box after being transformed by a matrix.
+		 * NOTE: Transforms the center and projects the extents onto the absolute matrix rows so it stays tight for rotations. */
+		BoundingBox TransformBy(const Matrix4x4& matrix) const
+		{
+			const VectorRegister extents = GetExtents().ToRegister();
+			VectorRegister newExtents = VectorMultiply(VectorSplatX(extents), VectorAbs(matrix.Rows[0]));
+			newExtents = VectorMultiplyAdd(VectorSplatY(extents), VectorAbs(matrix.Rows[1]), newExtents);
+			newExtents = VectorMultiplyAdd(VectorSplatZ(extents), VectorAbs(matrix.Rows[2]), newExtents);
+			return FromCenterExtents(matrix.TransformPosition(GetCenter()), Vector3D(VectorSetW(newExtents, 0.0f)));
+		}
+
+		/* Returns a string of this box. */
+		std::string ToString() const
+		{
+			std::stringstream stream;
+			stream << "BoundingBox(Min: " << Min.X << ", " << Min.Y << ", " << Min.Z << ", Max: " << Max.X << ", " << Max.Y << ", " << Max.Z << ")";
+			return stream.str();
+		}
+	};
+
+	/* Bounding sphere declaration. */
+	struct alignas(16) BoundingSphere
+	{
+	public:
+
+		/* Structure variables. */
+		Vector3D Center;
+		float Radius;
+
+	public:
+
+		/* Default constructor's. */
+		BoundingSphere() : Center(0.0f), Radius(0.0f) {}
+		BoundingSphere(const Vector3D& center, float radius) : Center(center), Radius(radius) {}
+
+		/* Create the sphere that contains a box. */
+		static BoundingSphere FromBox(const BoundingBox& box)
+		{
+			return BoundingSphere(box.GetCenter(), box.GetExtents().Size());
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Bounding Sphere Functions				//
+		//////////////////////////////////////////////////////////////
+
+		/* Returns if a point is inside the sphere. */
+		bool ContainsPoint(const Vector3D& point) const
+		{
+			const VectorRegister offset = VectorSubtract(point.ToRegister(), Center.ToRegister());
+			return VectorGetX(VectorDot3(offset, offset)) <= Radius * Radius;
+		}
+
+		/* Returns if this sphere overlaps another sphere. */
+		bool Intersects(const BoundingSphere& other) const
+		{
+			const VectorRegister offset = VectorSubtract(other.Center.ToRegister(), Center.ToRegister());
+			const float radiusSum = Radius + other.Radius;
+			return VectorGetX(VectorDot3(offset, offset)) <= radiusSum * radiusSum;
+		}
+
+		/* Returns if this sphere overlaps a box. */
+		bool Intersects(const BoundingBox& box) const
+		{
+			return box.GetDistanceSquared(Center) <= Radius * Radius;
+		}
+
+		/* Returns if the sphere is at least partly inside a frustum. */
+		bool IntersectsFrustum(const Frustum& frustum) const
+		{
+			return frustum.IntersectsSphere(Center, Radius);
+		}
+
+		/* Returns the axis aligned box around this sphere. */
+		BoundingBox GetBoundingBox() const
+		{
+			return BoundingBox::FromCenterExtents(Center, Vector3D(Radius));
+		}
+
+		/* Returns this sphere transformed by a matrix. The radius is scaled by the largest axis scale so it always contains the result. */
+		BoundingSphere TransformBy(const Matrix4x4& matrix) const
+		{
+			const float maxScaleSquared = ReeeMath::Max(VectorGetX(VectorDot3(matrix.Rows[0], matrix.Rows[0])),
+				ReeeMath::Max(VectorGetX(VectorDot3(matrix.Rows[1], matrix.Rows[1])), VectorGetX(VectorDot3(matrix.Rows[2], matrix.Rows[2]))));
+			return BoundingSphere(matrix.TransformPosition(Center), Radius * std::sqrt(maxScaleSquared));
+		}
+	};
+
+	inline bool BoundingBox::Intersects(const BoundingSphere& sphere) const
+	{
+		return GetDistanceSquared(sphere.Center) <= sphere.Radius * sphere.Radius;
+	}
+
+	/* Oriented bounding box declaration made up of a center, three unit axes and the half size along each axis. */
+	struct alignas(16) OrientedBoundingBox
+	{
+	public:
+
+		/* Structure variables. */
+		Vector3D Center;
+		Vector3D Extents;
+		Vector3D Axes[3];
+
+	public:
+
+		/* Default constructor's. */
+		OrientedBoundingBox() : Center(0.0f), Extents(0.0f)
+		{
+			Axes[0] = Vector3D(1.0f, 0.0f, 0.0f);
+			Axes[1] = Vector3D(0.0f, 1.0f, 0.0f);
+			Axes[2] = Vector3D(0.0f, 0.0f, 1.0f);
+		}
+		explicit OrientedBoundingBox(const BoundingBox& box) : OrientedBoundingBox()
+		{
+			Center = box.GetCenter();
+			Extents = box.GetExtents();
+		}
+
+		/* Create the oriented box of an axis aligned box after transforming it by a matrix.
+		 * NOTE: Assumes the matrix has no shear, the result of a Transform always meets this. */
+		OrientedBoundingBox(const BoundingBox& box, const Matrix4x4& matrix) : OrientedBoundingBox(box)
+		{
+			*this = TransformBy(matrix);
+		}
+
+		//////////////////////////////////////////////////////////////
+		//				  Oriented Bounding Box Functions			//
+		//////////////////////////////////////////////////////////////
+
+		/* Returns this box transformed by a matrix. Scale is moved from the axes into the extents. */
+		OrientedBoundingBox TransformBy(const Matrix4x4& matrix) const
+		{
+			OrientedBoundingBox result;
+			result.Center = matrix.TransformPosition(Center);
+			for (int i = 0; i < 3; i++)
+			{
+				const VectorRegister axis = matrix.TransformDirection(Axes[i]).ToRegister();
+				const float axisScale = std::sqrt(VectorGetX(VectorDot3(axis, axis)));
+				result.Axes[i] = axisScale > SMALL_NUMBER ? Vector3D(VectorMultiply(axis, VectorSetAll(1.0f / axisScale))) : Axes[i];
+				(&result.Extents.X)[i] = (&Extents.X)[i] * axisScale;
+			}
+			return result;
+		}
+
+		/* Returns if a point is inside the box. */
+		bool ContainsPoint(const Vector3D& point) const
+		{
+			const VectorRegister offset = VectorSubtract(point.ToRegister(), Center.ToRegister());
+			for (int i = 0; i < 3; i++)
+			{
+				if (std::abs(VectorGetX(VectorDot3(offset, Axes[i].ToRegister()))) > (&Extents.X)[i]) return false;
+			}
+			return true;
+		}
+
+		/* Returns the radius of the box projected onto a direction. */
+		float GetProjectedRadius(const VectorRegister& direction) const
+		{
+			return Extents.X * std::abs(VectorGetX(VectorDot3(Axes[0].ToRegister(), direction)))
+				+ Extents.Y * std::abs(VectorGetX(VectorDot3(Axes[1].ToRegister(), direction)))
+				+ Extents.Z * std::abs(VectorGetX(VectorDot3(Axes[2].ToRegister(), direction)));
+		}
+
+		/* Returns if this box overlaps another oriented box using the separating axis test. */
+		bool Intersects(const OrientedBoundingBox& other) const
+		{
+			// Rotation of the other box in this boxes space and the offset between them.
+			float rotation[3][3], absRotation[3][3];
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					rotation[i][j] = VectorGetX(VectorDot3(Axes[i].ToRegister(), other.Axes[j].ToRegister()));
+					absRotation[i][j] = std::abs(rotation[i][j]) + 1.e-6f;
+				}
+			}
+			const VectorRegister offsetReg = VectorSubtract(other.Center.ToRegister(), Center.ToRegister());
+			const float offset[3] = { VectorGetX(VectorDot3(offsetReg, Axes[0].ToRegister())),
+				VectorGetX(VectorDot3(offsetReg, Axes[1].ToRegister())), VectorGetX(VectorDot3(offsetReg, Axes[2].ToRegister())) };
+			const float* extentsA = &Extents.X;
+			const float* extentsB = &other.Extents.X;
+
+			// This boxes axes.
+			for (int i = 0; i < 3; i++)
+			{
+				const float radiusB = extentsB[0] * absRotation[i][0] + extentsB[1] * absRotation[i][1] + extentsB[2] * absRotation[i][2];
+				if (std::abs(offset[i]) > extentsA[i] + radiusB) return false;
+			}
+
+			// The other boxes axes.
+			for (int j = 0; j < 3; j++)
+			{
+				const float radiusA = extentsA[0] * absRotation[0][j] + extentsA[1] * absRotation[1][j] + extentsA[2] * absRotation[2][j];
+				const float distance = offset[0] * rotation[0][j] + offset[1] * rotation[1][j] + offset[2] * rotation[2][j];
+				if (std::abs(distance) > radiusA + extentsB[j]) return false;
+			}
+
+			// Cross products of each pair of axes.
+			for (int i = 0; i < 3; i++)
+			{
+				const int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+				for (int j = 0; j < 3; j++)
+				{
+					const int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+					const float radiusA = extentsA[i1] * absRotation[i2][j] + extentsA[i2] * absRotation[i1][j];
+					const float radiusB = extentsB[j1] * absRotation[i][j2] + extentsB[j2] * absRotation[i][j1];
+					const float distance = offset[i2] * rotation[i1][j] - offset[i1] * rotation[i2][j];
+					if (std::abs(distance) > radiusA + radiusB) return false;
+				}
+			}
+			return true;
+		}
+
+		/* Returns if this box overlaps an axis aligned box. */
+		bool Intersects(const BoundingBox& box) const
+		{
+			return Intersects(OrientedBoundingBox(box));
+		}
+
+		/* Returns if the box is at least partly inside a frustum. */
+		bool IntersectsFrustum(const Frustum& frustum) const
+		{
+			for (int i = 0; i < Frustum::PlaneCount; i++)
+			{
+				if (frustum.GetPlaneDistance((Frustum::Plane)i, Center) < -GetProjectedRadius(frustum.Planes[i])) return false;
+			}
+			return true;
+		}
+
+		/* Returns the axis aligned box around this box. */
+		BoundingBox GetBoundingBox() const
+		{
+			VectorRegister extents = VectorMultiply(VectorSetAll(Extents.X), VectorAbs(Axes[0].ToRegister()));
+			extents = VectorMultiplyAdd(VectorSetAll(Extents.Y), VectorAbs(Axes[1].ToRegister()), extents);
+			extents = VectorMultiplyAdd(VectorSetAll(Extents.Z), VectorAbs(Axes[2].ToRegister()), extents);
+			return BoundingBox::FromCenterExtents(Center, Vector3D(VectorSetW(extents, 0.0f)));
+		}
+	};
+
+	/* Ray declaration for picking and line of sight queries. The inverse direction is cached for the slab tests. */
+	struct alignas(16) Ray
+	{
+	public:
+
+		/* Structure variables. */
+		Vector3D Origin;
+		Vector3D Direction;
+		Vector3D InvDirection;
+
+	public:
+
+		/* Default constructor's. Direction should be normalized so hit distances are in world units. */
+		Ray() : Origin(0.0f), Direction(1.0f, 0.0f, 0.0f), InvDirection(1.0f, BIG_NUMBER, BIG_NUMBER) {}
+		Ray(const Vector3D& origin, const Vector3D& direction) : Origin(origin), Direction(direction)
+		{
+			// Zero components give an infinite inverse so that slab is either always or never hit.
+			InvDirection = Vector3D(1.0f / direction.X, 1.0f / direction.Y, 1.0f / direction.Z);
+		}
+
+		/* Returns the point at a distance along the ray. */
+		Vector3D GetPoint(float distance) const
+		{
+			return Vector3D(VectorMultiplyAdd(Direction.ToRegister(), VectorSetAll(distance), Origin.ToRegister()));
+		}
+
+		/* Returns if the ray hits a box in front of its origin and the distance to the hit. Zero if the origin is inside. */
+		bool Intersects(const BoundingBox& box, float& outDistance) const
+		{
+			const VectorRegister origin = Origin.ToRegister();
+			const VectorRegister invDirection = InvDirection.ToRegister();
+			const VectorRegister t1 = VectorMultiply(VectorSubtract(box.Min.ToRegister(), origin), invDirection);
+			const VectorRegister t2 = VectorMultiply(VectorSubtract(box.Max.ToRegister(), origin), invDirection);
+			alignas(16) float nearT[4], farT[4];
+			VectorStoreAligned(VectorMin(t1, t2), nearT);
+			VectorStoreAligned(VectorMax(t1, t2), farT);
+			const float entry = ReeeMath::Max(ReeeMath::Max(nearT[0], nearT[1]), ReeeMath::Max(nearT[2], 0.0f));
+			const float exit = ReeeMath::Min(farT[0], ReeeMath::Min(farT[1], farT[2]));
+			outDistance = entry;
+			return entry <= exit;
+		}
+
+		/* Returns if the ray hits a sphere in front of its origin and the distance to the hit. Zero if the origin is inside. */
+		bool Intersects(const BoundingSphere& sphere, float& outDistance) const
+		{
+			const VectorRegister offset = VectorSubtract(Origin.ToRegister(), sphere.Center.ToRegister());
+			const float b = VectorGetX(VectorDot3(offset, Direction.ToRegister()));
+			const float c = VectorGetX(VectorDot3(offset, offset)) - sphere.Radius * sphere.Radius;
+			if (c > 0.0f && b > 0.0f) return false;
+			const float discriminant = b * b - c;
+			if (discriminant < 0.0f) return false;
+			outDistance = ReeeMath::Max(0.0f, -b - std::sqrt(discriminant));
+			return true;
+		}
+	};
+
+	/* Batched bounding volume tests for culling and spatial queries.
+	 * NOTE: The fixed size tests return a bit mask with bit i set when element i passes, the array
+	 *       versions write one byte per element and return how many passed. */
+	class BoundsBatch
+	{
+	public:
+
+		/* Delete Constructors. */
+		BoundsBatch() = delete;
+		BoundsBatch(const BoundsBatch&) = delete;
+		BoundsBatch& operator = (const BoundsBatch&) = delete;
+
+	public:
+
+		//////////////////////////////////////////////////////////////
+		//					  Frustum Culling						//
+		//////////////////////////////////////////////////////////////
+
+		/* Test four boxes against a frustum at once. Bit i is set if boxes[i] is at least partly inside. */
+		static unsigned int IntersectsBoxes4(const Frustum& frustum, const BoundingBox* boxes)
+		{
+			VectorRegister centerX, centerY, centerZ, extentsX, extentsY, extentsZ;
+			LoadBoxes4(boxes, centerX, centerY, centerZ, extentsX, extentsY, extentsZ);
+
+			// A box is outside if it is fully behind any one plane.
+			unsigned int outside = 0;
+			for (int i = 0; i < Frustum::PlaneCount; i++)
+			{
+				const VectorRegister plane = frustum.Planes[i];
+				const VectorRegister absPlane = VectorAbs(plane);
+				VectorRegister distance = VectorMultiplyAdd(VectorSplatX(plane), centerX, VectorSplatW(plane));
+				distance = VectorMultiplyAdd(VectorSplatY(plane), centerY, distance);
+				distance = VectorMultiplyAdd(VectorSplatZ(plane), centerZ, distance);
+				VectorRegister radius = VectorMultiply(VectorSplatX(absPlane), extentsX);
+				radius = VectorMultiplyAdd(VectorSplatY(absPlane), extentsY, radius);
+				radius = VectorMultiplyAdd(VectorSplatZ(absPlane), extentsZ, radius);
+				outside |= VectorMoveMask(VectorCompareLess(VectorAdd(distance, radius), VectorZero()));
+			}
+			return ~outside & 0xFu;
+		}
+
+		/* Test eight boxes against a frustum at once. Bit i is set if boxes[i] is at least partly inside.
+		 * NOTE: AVX2 builds test all eight in one 256 bit register, otherwise this is two four wide tests. */
+		static unsigned int IntersectsBoxes8(const Frustum& frustum, const BoundingBox* boxes)
+		{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+			VectorRegister lowCenter[3], lowExtents[3], highCenter[3], highExtents[3];
+			LoadBoxes4(boxes, lowCenter[0], lowCenter[1], lowCenter[2], lowExtents[0], lowExtents[1], lowExtents[2]);
+			LoadBoxes4(boxes + 4, highCenter[0], highCenter[1], highCenter[2], highExtents[0], highExtents[1], highExtents[2]);
+			BatchRegister center[3], extents[3];
+			for (int axis = 0; axis < 3; axis++)
+			{
+				center[axis] = _mm256_insertf128_ps(_mm256_castps128_ps256(lowCenter[axis]), highCenter[axis], 1);
+				extents[axis] = _mm256_insertf128_ps(_mm256_castps128_ps256(lowExtents[axis]), highExtents[axis], 1);
+			}
+
+			// A box is outside if it is fully behind any one plane.
+			unsigned int outside = 0;
+			for (int i = 0; i < Frustum::PlaneCount; i++)
+			{
+				alignas(16) float plane[4];
+				VectorStoreAligned(frustum.Planes[i], plane);
+				BatchRegister distance = BatchMultiplyAdd(BatchSetAll(plane[0]), center[0], BatchSetAll(plane[3]));
+				distance = BatchMultiplyAdd(BatchSetAll(plane[1]), center[1], distance);
+				distance = BatchMultiplyAdd(BatchSetAll(plane[2]), center[2], distance);
+				BatchRegister radius = BatchMultiply(BatchSetAll(std::abs(plane[0])), extents[0]);
+				radius = BatchMultiplyAdd(BatchSetAll(std::abs(plane[1])), extents[1], radius);
+				radius = BatchMultiplyAdd(BatchSetAll(std::abs(plane[2])), extents[2], radius);
+				outside |= BatchMoveMask(BatchCompareLess(BatchAdd(distance, radius), BatchSetAll(0.0f)));
+			}
+			return ~outside & 0xFFu;
+#else
+			return IntersectsBoxes4(frustum, boxes) | (IntersectsBoxes4(frustum, boxes + 4) << 4);
+#endif
+		}
+
+		/* Test count boxes against a frustum writing 1 for visible and 0 for culled. Returns the number of visible boxes. */
+		static size_t CullBoxes(const Frustum& frustum, const BoundingBox* boxes, size_t count, uint8_t* outVisible)
+		{
+			size_t visibleCount = 0;
+			size_t i = 0;
+			for (; i + 8 <= count; i += 8)
+			{
+				const unsigned int mask = IntersectsBoxes8(frustum, boxes + i);
+				for (size_t lane = 0; lane < 8; lane++) outVisible[i + lane] = (uint8_t)((mask >> lane) & 1u);
+				visibleCount += CountBits(mask);
+			}
+			for (; i < count; i++)
+			{
+				outVisible[i] = boxes[i].IntersectsFrustum(frustum) ? 1 : 0;
+				visibleCount += outVisible[i];
+			}
+			return visibleCount;
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Overlap Queries						//
+		//////////////////////////////////////////////////////////////
+
+		/* Test four spheres against one sphere at once. Bit i is set if spheres[i] overlaps the query sphere. */
+		static unsigned int OverlapSpheres4(const BoundingSphere& sphere, const BoundingSphere* spheres)
+		{
+			VectorRegister x = spheres[0].Center.ToRegister();
+			VectorRegister y = spheres[1].Center.ToRegister();
+			VectorRegister z = spheres[2].Center.ToRegister();
+			VectorRegister unused = spheres[3].Center.ToRegister();
+			VectorTranspose(x, y, z, unused);
+
+			const VectorRegister query = sphere.Center.ToRegister();
+			const VectorRegister offsetX = VectorSubtract(x, VectorSplatX(query));
+			const VectorRegister offsetY = VectorSubtract(y, VectorSplatY(query));
+			const VectorRegister offsetZ = VectorSubtract(z, VectorSplatZ(query));
+			const VectorRegister distanceSquared = VectorMultiplyAdd(offsetX, offsetX, VectorMultiplyAdd(offsetY, offsetY, VectorMultiply(offsetZ, offsetZ)));
+			const VectorRegister radiusSum = VectorAdd(VectorSet(spheres[0].Radius, spheres[1].Radius, spheres[2].Radius, spheres[3].Radius), VectorSetAll(sphere.Radius));
+			return ~VectorMoveMask(VectorCompareGreater(distanceSquared, VectorMultiply(radiusSum, radiusSum))) & 0xFu;
+		}
+
+		/* Test count spheres against one sphere writing 1 for overlapping and 0 otherwise. Returns the number overlapping. */
+		static size_t OverlapSpheres(const BoundingSphere& sphere, const BoundingSphere* spheres, size_t count, uint8_t* outOverlap)
+		{
+			size_t overlapCount = 0;
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				const unsigned int mask = OverlapSpheres4(sphere, spheres + i);
+				for (size_t lane = 0; lane < 4; lane++) outOverlap[i + lane] = (uint8_t)((mask >> lane) & 1u);
+				overlapCount += CountBits(mask);
+			}
+			for (; i < count; i++)
+			{
+				outOverlap[i] = sphere.Intersects(spheres[i]) ? 1 : 0;
+				overlapCount += outOverlap[i];
+			}
+			return overlapCount;
+		}
+
+		/* Slab test a ray against four boxes at once. Bit i is set if the ray hits boxes[i] and outDistances[i] is the hit distance.
+		 * NOTE: A ray travelling exactly along one of a boxes faces may be reported as a miss. */
+		static unsigned int RayIntersectsBoxes4(const Ray& ray, const BoundingBox* boxes, float* outDistances)
+		{
+			VectorRegister minX = boxes[0].Min.ToRegister(), minY = boxes[1].Min.ToRegister(), minZ = boxes[2].Min.ToRegister(), minW = boxes[3].Min.ToRegister();
+			VectorRegister maxX = boxes[0].Max.ToRegister(), maxY = boxes[1].Max.ToRegister(), maxZ = boxes[2].Max.ToRegister(), maxW = boxes[3].Max.ToRegister();
+			VectorTranspose(minX, minY, minZ, minW);
+			VectorTranspose(maxX, maxY, maxZ, maxW);
+
+			const VectorRegister origin = ray.Origin.ToRegister();
+			const VectorRegister invDirection = ray.InvDirection.ToRegister();
+			VectorRegister entry = VectorZero();
+			VectorRegister exit = VectorSetAll(BIG_NUMBER);
+			const VectorRegister mins[3] = { minX, minY, minZ };
+			const VectorRegister maxs[3] = { maxX, maxY, maxZ };
+			const VectorRegister origins[3] = { VectorSplatX(origin), VectorSplatY(origin), VectorSplatZ(origin) };
+			const VectorRegister invDirections[3] = { VectorSplatX(invDirection), VectorSplatY(invDirection), VectorSplatZ(invDirection) };
+			for (int axis = 0; axis < 3; axis++)
+			{
+				const VectorRegister t1 = VectorMultiply(VectorSubtract(mins[axis], origins[axis]), invDirections[axis]);
+				const VectorRegister t2 = VectorMultiply(VectorSubtract(maxs[axis], origins[axis]), invDirections[axis]);
+				entry = VectorMax(entry, VectorMin(t1, t2));
+				exit = VectorMin(exit, VectorMax(t1, t2));
+			}
+			VectorStore(entry, outDistances);
+			return ~VectorMoveMask(VectorCompareGreater(entry, exit)) & 0xFu;
+		}
+
+	private:
+
+		/* Load four boxes as structure of arrays centers and extents. */
+		static void LoadBoxes4(const BoundingBox* boxes, VectorRegister& centerX, VectorRegister& centerY, VectorRegister& centerZ,
+			VectorRegister& extentsX, VectorRegister& extentsY, VectorRegister& extentsZ)
+		{
+			const VectorRegister half = VectorSetAll(0.5f);
+			VectorRegister center[4], extents[4];
+			for (int i = 0; i < 4; i++)
+			{
+				const VectorRegister min = boxes[i].Min.ToRegister();
+				const VectorRegister max = boxes[i].Max.ToRegister();
+				center[i] = VectorMultiply(VectorAdd(min, max), half);
+				extents[i] = VectorMultiply(VectorSubtract(max, min), half);
+			}
+			VectorTranspose(center[0], center[1], center[2], center[3]);
+			VectorTranspose(extents[0], extents[1], extents[2], extents[3]);
+			centerX = center[0];
+			centerY = center[1];
+			centerZ = center[2];
+			extentsX = extents[0];
+			extentsY = extents[1];
+			extentsZ = extents[2];
+		}
+
+		/* Returns the number of set bits in a mask. */
+		static size_t CountBits(unsigned int mask)
+		{
+			size_t count = 0;
+			for (; mask; mask &= mask - 1) count++;
+			return count;
+		}
+	};
+}
\ No newline at end of file
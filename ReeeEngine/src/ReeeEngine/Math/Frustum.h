@@ -0,0 +1,116 @@
+#pragma once
+#include "ReeeMath.h"
+#include "VectorRegister.h"
+#include "Vector3D.h"
+#include "Matrix4x4.h"
+
+namespace ReeeEngine
+{
+	/* View frustum declaration made up of six planes pointing inwards.
+	 * NOTE: Each plane is stored as (normal X, normal Y, normal Z, distance) so a point is inside when dot(normal, point) + distance >= 0. */
+	struct alignas(16) Frustum
+	{
+	public:
+
+		/* Index of each plane within the frustum. */
+		enum Plane
+		{
+			Left = 0,
+			Right,
+			Bottom,
+			Top,
+			Near,
+			Far,
+			PlaneCount
+		};
+
+		/* Structure variables. */
+		VectorRegister Planes[PlaneCount];
+
+	public:
+
+		/* Default constructor's. Default frustum contains everything. */
+		Frustum()
+		{
+			for (int i = 0; i < PlaneCount; i++)
+			{
+				Planes[i] = VectorSet(0.0f, 0.0f, 0.0f, BIG_NUMBER);
+			}
+		}
+		explicit Frustum(const Matrix4x4& viewProjection)
+		{
+			SetFromMatrix(viewProjection);
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Frustum Functions						//
+		//////////////////////////////////////////////////////////////
+
+		/* Extract the planes from a view * projection matrix. Planes end up in the space the matrix transforms from.
+		 * NOTE: Expects a DirectX style projection where clip depth is between 0 and w. */
+		void SetFromMatrix(const Matrix4x4& viewProjection)
+		{
+			// With row vectors each clip coordinate is a dot product with a column so work on the transposed matrix.
+			const Matrix4x4 columns = viewProjection.GetTransposed();
+			Planes[Left] = VectorAdd(columns.Rows[3], columns.Rows[0]);
+			Planes[Right] = VectorSubtract(columns.Rows[3], columns.Rows[0]);
+			Planes[Bottom] = VectorAdd(columns.Rows[3], columns.Rows[1]);
+			Planes[Top] = VectorSubtract(columns.Rows[3], columns.Rows[1]);
+			Planes[Near] = columns.Rows[2];
+			Planes[Far] = VectorSubtract(columns.Rows[3], columns.Rows[2]);
+
+			// Normalize so the plane distances are in world units.
+			for (int i = 0; i < PlaneCount; i++)
+			{
+				const VectorRegister normalSizeSquared = VectorDot3(Planes[i], Planes[i]);
+				if (VectorGetX(normalSizeSquared) > SMALL_NUMBER)
+				{
+					Planes[i] = VectorMultiply(Planes[i], VectorReciprocalSqrt(normalSizeSquared));
+				}
+			}
+		}
+
+		/* Returns the signed distance from a plane to a point. Positive is inside. */
+		float GetPlaneDistance(Plane plane, const Vector3D& point) const
+		{
+			return VectorGetX(VectorDot4(Planes[plane], VectorSetW(point.ToRegister(), 1.0f)));
+		}
+
+		/* Returns if a point is inside the frustum. */
+		bool ContainsPoint(const Vector3D& point) const
+		{
+			const VectorRegister pointReg = VectorSetW(point.ToRegister(), 1.0f);
+			for (int i = 0; i < PlaneCount; i++)
+			{
+				if (VectorGetX(VectorDot4(Planes[i], pointReg)) < 0.0f) return false;
+			}
+			return true;
+		}
+
+		/* Returns if a sphere is at least partly inside the frustum. */
+		bool IntersectsSphere(const Vector3D& center, float radius) const
+		{
+			const VectorRegister centerReg = VectorSetW(center.ToRegister(), 1.0f);
+			for (int i = 0; i < PlaneCount; i++)
+			{
+				if (VectorGetX(VectorDot4(Planes[i], centerReg)) < -radius) return false;
+			}
+			return true;
+		}
+
+		/* Returns if an axis aligned box given by its center and half size is at least partly inside the frustum. */
+		bool IntersectsBox(const Vector3D& center, const Vector3D& extents) const
+		{
+			const VectorRegister centerReg = VectorSetW(center.ToRegister(), 1.0f);
+			const VectorRegister extentsReg = extents.ToRegister();
+			for (int i = 0; i < PlaneCount; i++)
+			{
+				// Project the box onto the plane normal to get its radius along it.
+				const float distance = VectorGetX(VectorDot4(Planes[i], centerReg));
+				const float projectedRadius = VectorGetX(VectorDot3(VectorAbs(Planes[i]), extentsReg));
+				if (distance < -projectedRadius) return false;
+			}
+			return true;
+		}
+	};
+}
\ No newline at end of file
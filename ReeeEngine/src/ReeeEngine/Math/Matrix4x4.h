@@ -0,0 +1,378 @@
+#pragma once
+#include "ReeeMath.h"
+#include "VectorRegister.h"
+#include "Vector3D.h"
+#include "Rotator.h"
+#include "Quat.h"
+
+namespace ReeeEngine
+{
+	/* 4x4 matrix declaration stored as four SIMD row registers.
+	 * NOTE: Uses row vectors (v * M) and the left handed conventions of DirectXMath so A * B applies A then B.
+	 *       The memory layout is the same as a DirectX::XMMATRIX so it can be copied straight into a constant buffer. */
+	struct alignas(16) Matrix4x4
+	{
+	public:
+
+		/* Structure variables. */
+		VectorRegister Rows[4];
+
+	public:
+
+		/* Default constructor's. Default is the identity matrix. */
+		Matrix4x4()
+		{
+			Rows[0] = VectorSet(1.0f, 0.0f, 0.0f, 0.0f);
+			Rows[1] = VectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+			Rows[2] = VectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+			Rows[3] = VectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+		Matrix4x4(const VectorRegister& row0, const VectorRegister& row1, const VectorRegister& row2, const VectorRegister& row3)
+		{
+			Rows[0] = row0;
+			Rows[1] = row1;
+			Rows[2] = row2;
+			Rows[3] = row3;
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Construction Functions				//
+		//////////////////////////////////////////////////////////////
+
+		/* Returns the identity matrix. */
+		static Matrix4x4 Identity()
+		{
+			return Matrix4x4();
+		}
+
+		/* Returns a translation matrix. */
+		static Matrix4x4 Translation(const Vector3D& location)
+		{
+			Matrix4x4 result;
+			result.Rows[3] = VectorSetW(location.ToRegister(), 1.0f);
+			return result;
+		}
+
+		/* Returns a scaling matrix. */
+		static Matrix4x4 Scaling(const Vector3D& scale)
+		{
+			return Matrix4x4(
+				VectorSet(scale.X, 0.0f, 0.0f, 0.0f),
+				VectorSet(0.0f, scale.Y, 0.0f, 0.0f),
+				VectorSet(0.0f, 0.0f, scale.Z, 0.0f),
+				VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		/* Returns a matrix rotating around the X axis by the given radians. */
+		static Matrix4x4 RotationX(float radians)
+		{
+			const float sinAngle = std::sin(radians), cosAngle = std::cos(radians);
+			return Matrix4x4(
+				VectorSet(1.0f, 0.0f, 0.0f, 0.0f),
+				VectorSet(0.0f, cosAngle, sinAngle, 0.0f),
+				VectorSet(0.0f, -sinAngle, cosAngle, 0.0f),
+				VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		/* Returns a matrix rotating around the Y axis by the given radians. */
+		static Matrix4x4 RotationY(float radians)
+		{
+			const float sinAngle = std::sin(radians), cosAngle = std::cos(radians);
+			return Matrix4x4(
+				VectorSet(cosAngle, 0.0f, -sinAngle, 0.0f),
+				VectorSet(0.0f, 1.0f, 0.0f, 0.0f),
+				VectorSet(sinAngle, 0.0f, cosAngle, 0.0f),
+				VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		/* Returns a matrix rotating around the Z axis by the given radians. */
+		static Matrix4x4 RotationZ(float radians)
+		{
+			const float sinAngle = std::sin(radians), cosAngle = std::cos(radians);
+			return Matrix4x4(
+				VectorSet(cosAngle, sinAngle, 0.0f, 0.0f),
+				VectorSet(-sinAngle, cosAngle, 0.0f, 0.0f),
+				VectorSet(0.0f, 0.0f, 1.0f, 0.0f),
+				VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		/* Returns the rotation matrix of a unit quaternion. */
+		static Matrix4x4 Rotation(const Quat& rotation)
+		{
+			const float x = rotation.X, y = rotation.Y, z = rotation.Z, w = rotation.W;
+			const float xx = x * x, yy = y * y, zz = z * z;
+			const float xy = x * y, xz = x * z, yz = y * z;
+			const float wx = w * x, wy = w * y, wz = w * z;
+			return Matrix4x4(
+				VectorSet(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f),
+				VectorSet(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f),
+				VectorSet(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f),
+				VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		/* Returns the rotation matrix of a rotator in degrees. */
+		static Matrix4x4 Rotation(const Rotator& rotation)
+		{
+			return Rotation(Quat::FromRotator(rotation));
+		}
+
+		/* Returns the scale * rotation * translation matrix without doing any matrix multiplies. */
+		static Matrix4x4 Compose(const Vector3D& scale, const Quat& rotation, const Vector3D& location)
+		{
+			Matrix4x4 result = Rotation(rotation);
+			result.Rows[0] = VectorMultiply(result.Rows[0], VectorSetAll(scale.X));
+			result.Rows[1] = VectorMultiply(result.Rows[1], VectorSetAll(scale.Y));
+			result.Rows[2] = VectorMultiply(result.Rows[2], VectorSetAll(scale.Z));
+			result.Rows[3] = VectorSetW(location.ToRegister(), 1.0f);
+			return result;
+		}
+
+		/* Returns a left handed view matrix at a location looking in a given direction. */
+		static Matrix4x4 LookToLH(const Vector3D& eyeLocation, const Vector3D& lookDirection, const Vector3D& upDirection)
+		{
+			// Build the cameras axis.
+			const VectorRegister forward = lookDirection.GetNormal().ToRegister();
+			const VectorRegister right = Vector3D(VectorCross3(upDirection.ToRegister(), forward)).GetNormal().ToRegister();
+			const VectorRegister up = VectorCross3(forward, right);
+
+			// Move the world so the eye sits at the origin.
+			const VectorRegister negativeEye = VectorNegate(eyeLocation.ToRegister());
+			Matrix4x4 result(
+				VectorSetW(right, VectorGetX(VectorDot3(right, negativeEye))),
+				VectorSetW(up, VectorGetX(VectorDot3(up, negativeEye))),
+				VectorSetW(forward, VectorGetX(VectorDot3(forward, negativeEye))),
+				VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+			return result.GetTransposed();
+		}
+
+		/* Returns a left handed view matrix at a location looking at a target location. */
+		static Matrix4x4 LookAtLH(const Vector3D& eyeLocation, const Vector3D& targetLocation, const Vector3D& upDirection)
+		{
+			return LookToLH(eyeLocation, targetLocation - eyeLocation, upDirection);
+		}
+
+		/* Returns a left handed perspective projection matrix mapping depth between 0 and 1. */
+		static Matrix4x4 PerspectiveFovLH(float fovRadians, float aspectRatio, float nearClip, float farClip)
+		{
+			const float height = std::cos(fovRadians * 0.5f) / std::sin(fovRadians * 0.5f);
+			const float width = height / aspectRatio;
+			const float range = farClip / (farClip - nearClip);
+			return Matrix4x4(
+				VectorSet(width, 0.0f, 0.0f, 0.0f),
+				VectorSet(0.0f, height, 0.0f, 0.0f),
+				VectorSet(0.0f, 0.0f, range, 1.0f),
+				VectorSet(0.0f, 0.0f, -range * nearClip, 0.0f));
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Matrix Functions						//
+		//////////////////////////////////////////////////////////////
+
+		/* Returns the matrix as 16 floats in row order. */
+		const float* Data() const
+		{
+			return reinterpret_cast<const float*>(Rows);
+		}
+
+		/* Returns a single element of the matrix. */
+		float Get(int row, int column) const
+		{
+			return Data()[row * 4 + column];
+		}
+
+		/* Returns the transposed matrix. */
+		Matrix4x4 GetTransposed() const
+		{
+			Matrix4x4 result = *this;
+			VectorTranspose(result.Rows[0], result.Rows[1], result.Rows[2], result.Rows[3]);
+			return result;
+		}
+
+		/* Returns the determinant of the matrix. */
+		float GetDeterminant() const
+		{
+			const float* m = Data();
+			const float s0 = m[0] * m[5] - m[4] * m[1], s1 = m[0] * m[6] - m[4] * m[2], s2 = m[0] * m[7] - m[4] * m[3];
+			const float s3 = m[1] * m[6] - m[5] * m[2], s4 = m[1] * m[7] - m[5] * m[3], s5 = m[2] * m[7] - m[6] * m[3];
+			const float c5 = m[10] * m[15] - m[14] * m[11], c4 = m[9] * m[15] - m[13] * m[11], c3 = m[9] * m[14] - m[13] * m[10];
+			const float c2 = m[8] * m[15] - m[12] * m[11], c1 = m[8] * m[14] - m[12] * m[10], c0 = m[8] * m[13] - m[12] * m[9];
+			return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+		}
+
+		/* Returns the inverse of the matrix. If the matrix can not be inverted the identity matrix is returned. */
+		Matrix4x4 GetInverse() const
+		{
+			// Laplace expansion using 2x2 sub determinants of the top and bottom halves.
+			const float* m = Data();
+			const float s0 = m[0] * m[5] - m[4] * m[1], s1 = m[0] * m[6] - m[4] * m[2], s2 = m[0] * m[7] - m[4] * m[3];
+			const float s3 = m[1] * m[6] - m[5] * m[2], s4 = m[1] * m[7] - m[5] * m[3], s5 = m[2] * m[7] - m[6] * m[3];
+			const float c5 = m[10] * m[15] - m[14] * m[11], c4 = m[9] * m[15] - m[13] * m[11], c3 = m[9] * m[14] - m[13] * m[10];
+			const float c2 = m[8] * m[15] - m[12] * m[11], c1 = m[8] * m[14] - m[12] * m[10], c0 = m[8] * m[13] - m[12] * m[9];
+			const float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+			if (std::abs(determinant) < SMALL_NUMBER) return Identity();
+
+			const float invDet = 1.0f / determinant;
+			return Matrix4x4(
+				VectorMultiply(VectorSet(
+					m[5] * c5 - m[6] * c4 + m[7] * c3,
+					-m[1] * c5 + m[2] * c4 - m[3] * c3,
+					m[13] * s5 - m[14] * s4 + m[15] * s3,
+					-m[9] * s5 + m[10] * s4 - m[11] * s3), VectorSetAll(invDet)),
+				VectorMultiply(VectorSet(
+					-m[4] * c5 + m[6] * c2 - m[7] * c1,
+					m[0] * c5 - m[2] * c2 + m[3] * c1,
+					-m[12] * s5 + m[14] * s2 - m[15] * s1,
+					m[8] * s5 - m[10] * s2 + m[11] * s1), VectorSetAll(invDet)),
+				VectorMultiply(VectorSet(
+					m[4] * c4 - m[5] * c2 + m[7] * c0,
+					-m[0] * c4 + m[1] * c2 - m[3] * c0,
+					m[12] * s4 - m[13] * s2 + m[15] * s0,
+					-m[8] * s4 + m[9] * s2 - m[11] * s0), VectorSetAll(invDet)),
+				VectorMultiply(VectorSet(
+					-m[4] * c3 + m[5] * c1 - m[6] * c0,
+					m[0] * c3 - m[1] * c1 + m[2] * c0,
+					-m[12] * s3 + m[13] * s1 - m[14] * s0,
+					m[8] * s3 - m[9] * s1 + m[10] * s0), VectorSetAll(invDet)));
+		}
+
+		/* Returns the location stored in the matrix. */
+		Vector3D GetLocation() const
+		{
+			return Vector3D(VectorSetW(Rows[3], 0.0f));
+		}
+
+		/* Split the matrix back into its scale, rotation and location. Returns false if the scale is too small to recover the rotation. */
+		bool Decompose(Vector3D& outScale, Quat& outRotation, Vector3D& outLocation) const
+		{
+			outLocation = GetLocation();
+
+			// Scale is the length of each basis row, flipped on one axis if the basis is mirrored.
+			float scaleX = VectorGetX(VectorSqrt(VectorDot3(Rows[0], Rows[0])));
+			const float scaleY = VectorGetX(VectorSqrt(VectorDot3(Rows[1], Rows[1])));
+			const float scaleZ = VectorGetX(VectorSqrt(VectorDot3(Rows[2], Rows[2])));
+			if (VectorGetX(VectorDot3(VectorCross3(Rows[0], Rows[1]), Rows[2])) < 0.0f) scaleX = -scaleX;
+			outScale = Vector3D(scaleX, scaleY, scaleZ);
+			if (std::abs(scaleX) < SMALL_NUMBER || scaleY < SMALL_NUMBER || scaleZ < SMALL_NUMBER)
+			{
+				outRotation = Quat::Identity();
+				return false;
+			}
+
+			// Remove the scale from the basis rows.
+			alignas(16) float r0[4], r1[4], r2[4];
+			VectorStoreAligned(VectorMultiply(Rows[0], VectorSetAll(1.0f / scaleX)), r0);
+			VectorStoreAligned(VectorMultiply(Rows[1], VectorSetAll(1.0f / scaleY)), r1);
+			VectorStoreAligned(VectorMultiply(Rows[2], VectorSetAll(1.0f / scaleZ)), r2);
+
+			// Convert the rotation matrix to a quaternion, picking the largest diagonal to stay numerically stable.
+			const float trace = r0[0] + r1[1] + r2[2];
+			if (trace > 0.0f)
+			{
+				const float s = 0.5f / std::sqrt(trace + 1.0f);
+				outRotation = Quat((r1[2] - r2[1]) * s, (r2[0] - r0[2]) * s, (r0[1] - r1[0]) * s, 0.25f / s);
+			}
+			else if (r0[0] > r1[1] && r0[0] > r2[2])
+			{
+				const float s = 2.0f * std::sqrt(1.0f + r0[0] - r1[1] - r2[2]);
+				outRotation = Quat(0.25f * s, (r0[1] + r1[0]) / s, (r2[0] + r0[2]) / s, (r1[2] - r2[1]) / s);
+			}
+			else if (r1[1] > r2[2])
+			{
+				const float s = 2.0f * std::sqrt(1.0f + r1[1] - r0[0] - r2[2]);
+				outRotation = Quat((r0[1] + r1[0]) / s, 0.25f * s, (r1[2] + r2[1]) / s, (r2[0] - r0[2]) / s);
+			}
+			else
+			{
+				const float s = 2.0f * std::sqrt(1.0f + r2[2] - r0[0] - r1[1]);
+				outRotation = Quat((r2[0] + r0[2]) / s, (r1[2] + r2[1]) / s, 0.25f * s, (r0[1] - r1[0]) / s);
+			}
+			outRotation.Normalize();
+			return true;
+		}
+
+		/* Transform a four component register by this matrix (v * M). */
+		VectorRegister TransformVector4(const VectorRegister& vector) const
+		{
+			VectorRegister result = VectorMultiply(VectorSplatX(vector), Rows[0]);
+			result = VectorMultiplyAdd(VectorSplatY(vector), Rows[1], result);
+			result = VectorMultiplyAdd(VectorSplatZ(vector), Rows[2], result);
+			return VectorMultiplyAdd(VectorSplatW(vector), Rows[3], result);
+		}
+
+		/* Transform a location by this matrix. Includes the translation with no perspective divide. */
+		Vector3D TransformPosition(const Vector3D& position) const
+		{
+			const VectorRegister vector = position.ToRegister();
+			VectorRegister result = VectorMultiplyAdd(VectorSplatX(vector), Rows[0], Rows[3]);
+			result = VectorMultiplyAdd(VectorSplatY(vector), Rows[1], result);
+			result = VectorMultiplyAdd(VectorSplatZ(vector), Rows[2], result);
+			return Vector3D(VectorSetW(result, 0.0f));
+		}
+
+		/* Transform a direction by this matrix. Ignores the translation. */
+		Vector3D TransformDirection(const Vector3D& direction) const
+		{
+			const VectorRegister vector = direction.ToRegister();
+			VectorRegister result = VectorMultiply(VectorSplatX(vector), Rows[0]);
+			result = VectorMultiplyAdd(VectorSplatY(vector), Rows[1], result);
+			result = VectorMultiplyAdd(VectorSplatZ(vector), Rows[2], result);
+			return Vector3D(VectorSetW(result, 0.0f));
+		}
+
+		/* Multiply two matrices. The result applies this matrix first and then the other.
+		 * NOTE: AVX2 builds work on two rows at once in 256 bit registers. */
+		inline Matrix4x4 operator*(const Matrix4x4& other) const
+		{
+			Matrix4x4 result;
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+			const __m256 otherRow0 = _mm256_broadcast_ps(&other.Rows[0]);
+			const __m256 otherRow1 = _mm256_broadcast_ps(&other.Rows[1]);
+			const __m256 otherRow2 = _mm256_broadcast_ps(&other.Rows[2]);
+			const __m256 otherRow3 = _mm256_broadcast_ps(&other.Rows[3]);
+			for (int i = 0; i < 4; i += 2)
+			{
+				const __m256 rows = _mm256_loadu_ps(reinterpret_cast<const float*>(&Rows[i]));
+				__m256 product = _mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(0, 0, 0, 0)), otherRow0);
+#if defined(REEE_SIMD_FMA)
+				product = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), otherRow1, product);
+				product = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), otherRow2, product);
+				product = _mm256_fmadd_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), otherRow3, product);
+#else
+				product = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(1, 1, 1, 1)), otherRow1), product);
+				product = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(2, 2, 2, 2)), otherRow2), product);
+				product = _mm256_add_ps(_mm256_mul_ps(_mm256_shuffle_ps(rows, rows, _MM_SHUFFLE(3, 3, 3, 3)), otherRow3), product);
+#endif
+				_mm256_storeu_ps(reinterpret_cast<float*>(&result.Rows[i]), product);
+			}
+#else
+			result.Rows[0] = other.TransformVector4(Rows[0]);
+			result.Rows[1] = other.TransformVector4(Rows[1]);
+			result.Rows[2] = other.TransformVector4(Rows[2]);
+			result.Rows[3] = other.TransformVector4(Rows[3]);
+#endif
+			return result;
+		}
+
+		/* Overrides the multiply equals matrix operator. */
+		inline Matrix4x4& operator*=(const Matrix4x4& other)
+		{
+			*this = *this * other;
+			return *this;
+		}
+
+		/* Returns if every element is equal within a tolerance. */
+		bool IsEqual(const Matrix4x4& other, float tolerance = 1.e-4f) const
+		{
+			const float* a = Data();
+			const float* b = other.Data();
+			for (int i = 0; i < 16; i++)
+			{
+				if (std::abs(a[i] - b[i]) > tolerance) return false;
+			}
+			return true;
+		}
+	};
+
+	/* Ensure the matrix can be copied straight into a shader float4x4. */
+	static_assert(sizeof(Matrix4x4) == 64 && alignof(Matrix4x4) == 16, "Matrix4x4 must match the size and alignment of a float4x4 constant.");
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+#pragma once
+#include "ReeeMath.h"
+#include "VectorRegister.h"
+#include "Vector3D.h"
+#include "Rotator.h"
+
+namespace ReeeEngine
+{
+	/* Quaternion declaration for representing a rotation without gimbal lock.
+	 * NOTE: Stored as (X, Y, Z, W) in one SIMD register, the same layout as a DirectX quaternion. */
+	struct alignas(16) Quat
+	{
+	public:
+
+		/* Structure variables. */
+		float X, Y, Z, W;
+
+	public:
+
+		/* Default constructor's. Default is the identity rotation. */
+		Quat() : X(0.0f), Y(0.0f), Z(0.0f), W(1.0f) {}
+		Quat(float x, float y, float z, float w) : X(x), Y(y), Z(z), W(w) {}
+		explicit Quat(const VectorRegister& quaternion) { VectorStoreAligned(quaternion, &X); }
+
+		//////////////////////////////////////////////////////////////
+		//					  Quaternion Functions					//
+		//////////////////////////////////////////////////////////////
+
+		/* Return the SIMD register holding this quaternion. */
+		VectorRegister ToRegister() const
+		{
+			return VectorLoadAligned(&X);
+		}
+
+		/* Returns the identity quaternion. */
+		static Quat Identity()
+		{
+			return Quat(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+
+		/* Create a quaternion from a rotator in degrees.
+		 * NOTE: Applies roll, then pitch, then yaw. The same order as DirectX's roll pitch yaw functions. */
+		static Quat FromRotator(const Rotator& rotation)
+		{
+			return rotation.ToQuaternion();
+		}
+
+		/* Combine the sine and cosine of half the pitch, yaw and roll into quaternion components.
+		 * NOTE: Works on whole registers so can be used for one rotator or four transposed rotators at once. */
+		static void FromHalfAngleSinCos(const VectorRegister& sinPitch, const VectorRegister& cosPitch, const VectorRegister& sinYaw, const VectorRegister& cosYaw,
+			const VectorRegister& sinRoll, const VectorRegister& cosRoll, VectorRegister& outX, VectorRegister& outY, VectorRegister& outZ, VectorRegister& outW)
+		{
+			const VectorRegister cosYawCosPitch = VectorMultiply(cosYaw, cosPitch);
+			const VectorRegister sinYawSinPitch = VectorMultiply(sinYaw, sinPitch);
+			const VectorRegister cosYawSinPitch = VectorMultiply(cosYaw, sinPitch);
+			const VectorRegister sinYawCosPitch = VectorMultiply(sinYaw, cosPitch);
+			outX = VectorMultiplyAdd(cosYawSinPitch, cosRoll, VectorMultiply(sinYawCosPitch, sinRoll));
+			outY = VectorSubtract(VectorMultiply(sinYawCosPitch, cosRoll), VectorMultiply(cosYawSinPitch, sinRoll));
+			outZ = VectorSubtract(VectorMultiply(cosYawCosPitch, sinRoll), VectorMultiply(sinYawSinPitch, cosRoll));
+			outW = VectorMultiplyAdd(cosYawCosPitch, cosRoll, VectorMultiply(sinYawSinPitch, sinRoll));
+		}
+
+		/* Create a quaternion rotating around a normalized axis by the given angle in radians. */
+		static Quat FromAxisAngle(const Vector3D& axis, float radians)
+		{
+			const float halfAngle = radians * 0.5f;
+			const VectorRegister scaledAxis = VectorMultiply(axis.ToRegister(), VectorSetAll(std::sin(halfAngle)));
+			return Quat(VectorSetW(scaledAxis, std::cos(halfAngle)));
+		}
+
+		/* Convert this unit quaternion back to a rotator in degrees. Inverse of FromRotator. */
+		Rotator ToRotator() const
+		{
+			// Pitch is clamped as float error can push the sine just outside of -1 to 1 when looking straight up or down.
+			const float sinPitch = ReeeMath::Clamp(2.0f * (W * X - Y * Z), -1.0f, 1.0f);
+			const float pitch = std::asin(sinPitch);
+
+			// When looking straight up or down yaw and roll spin around the same axis so put it all into roll.
+			if (std::abs(sinPitch) > 0.99999f)
+			{
+				const float roll = std::atan2(2.0f * (W * Z - X * Y), 1.0f - 2.0f * (Y * Y + Z * Z));
+				return Rotator(pitch, 0.0f, roll).ToDegrees();
+			}
+
+			const float yaw = std::atan2(2.0f * (X * Z + W * Y), 1.0f - 2.0f * (X * X + Y * Y));
+			const float roll = std::atan2(2.0f * (X * Y + W * Z), 1.0f - 2.0f * (X * X + Z * Z));
+			return Rotator(pitch, yaw, roll).ToDegrees();
+		}
+
+		/* Rotate a vector by this quaternion. */
+		Vector3D RotateVector(const Vector3D& vector) const
+		{
+			// v' = v + w * t + q x t where t = 2 * (q x v).
+			const VectorRegister quaternion = ToRegister();
+			const VectorRegister vectorReg = vector.ToRegister();
+			const VectorRegister t = VectorCross3(quaternion, vectorReg);
+			const VectorRegister doubleT = VectorAdd(t, t);
+			const VectorRegister result = VectorMultiplyAdd(VectorSplatW(quaternion), doubleT, VectorAdd(vectorReg, VectorCross3(quaternion, doubleT)));
+			return Vector3D(VectorSetW(result, 0.0f));
+		}
+
+		/* Rotate a vector by the inverse of this quaternion. */
+		Vector3D UnrotateVector(const Vector3D& vector) const
+		{
+			return GetInverse().RotateVector(vector);
+		}
+
+		/* Returns the inverse rotation. NOTE: Assumes the quaternion is normalized... */
+		Quat GetInverse() const
+		{
+			return Quat(-X, -Y, -Z, W);
+		}
+
+		/* Returns the size of the quaternion. */
+		float Size() const
+		{
+			const VectorRegister quaternion = ToRegister();
+			return VectorGetX(VectorSqrt(VectorDot4(quaternion, quaternion)));
+		}
+
+		/* Returns the normalized version of this quaternion, or identity if it is too small to normalize. */
+		Quat GetNormal(float tolerance = SMALL_NUMBER) const
+		{
+			const VectorRegister quaternion = ToRegister();
+			const VectorRegister sizeSquared = VectorDot4(quaternion, quaternion);
+			if (VectorGetX(sizeSquared) > tolerance)
+			{
+				return Quat(VectorMultiply(quaternion, VectorReciprocalSqrt(sizeSquared)));
+			}
+			return Identity();
+		}
+
+		/* Normalize this quaternion. */
+		void Normalize(float tolerance = SMALL_NUMBER)
+		{
+			*this = GetNormal(tolerance);
+		}
+
+		/* Returns if both quaternions represent the same rotation within a tolerance. */
+		bool IsEqual(const Quat& other, float tolerance = 1.e-4f) const
+		{
+			// q and -q are the same rotation.
+			const float dot = VectorGetX(VectorDot4(ToRegister(), other.ToRegister()));
+			return std::abs(dot) >= 1.0f - tolerance;
+		}
+
+		/* Returns a string of this quaternion. */
+		std::string ToString() const
+		{
+			std::stringstream stream;
+			stream << "Quat(X: " << X << ", Y: " << Y << ", Z: " << Z << ", W: " << W << ")";
+			return stream.str();
+		}
+
+		/* Combine two rotations. The result applies this rotation first and then the other rotation.
+		 * NOTE: Same order as multiplying row vector matrices and DirectX's XMQuaternionMultiply. */
+		inline Quat operator*(const Quat& other) const
+		{
+			const VectorRegister first = ToRegister();
+			const VectorRegister second = other.ToRegister();
+			const VectorRegister vectorPart = VectorAdd(VectorMultiplyAdd(VectorSplatW(second), first, VectorMultiply(VectorSplatW(first), second)), VectorCross3(second, first));
+			return Quat(VectorSetW(vectorPart, W * other.W - VectorGetX(VectorDot3(first, second))));
+		}
+
+		/* Override and setup equals operator. */
+		inline bool operator==(const Quat& other) const
+		{
+			return X == other.X && Y == other.Y && Z == other.Z && W == other.W;
+		}
+
+		/* Override and setup not equals operator. */
+		inline bool operator!=(const Quat& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	/* Ensure the quaternion still fills exactly one SIMD register. */
+	static_assert(sizeof(Quat) == 16 && alignof(Quat) == 16, "Quat must match the size and alignment of a VectorRegister.");
+
+	//////////////////////////////////////////////////////////////
+	//				  Rotator To Quaternion						//
+	//////////////////////////////////////////////////////////////
+
+	inline Quat Rotator::ToQuaternion() const
+	{
+		// One sincos of (pitch, yaw, roll) / 2 in radians then splat each lane out.
+		VectorRegister sinHalf, cosHalf;
+		ReeeMath::VectorSinCos(VectorMultiply(ToRegister(), VectorSetAll(PI / 360.0f)), sinHalf, cosHalf);
+		VectorRegister x, y, z, w;
+		Quat::FromHalfAngleSinCos(VectorSplatX(sinHalf), VectorSplatX(cosHalf), VectorSplatY(sinHalf), VectorSplatY(cosHalf),
+			VectorSplatZ(sinHalf), VectorSplatZ(cosHalf), x, y, z, w);
+		VectorTranspose(x, y, z, w);
+		return Quat(x);
+	}
+
+	inline void Rotator::ToQuaternionBatch(const Rotator* rotators, Quat* outQuaternions, size_t count)
+	{
+		const VectorRegister degreesToHalfRadians = VectorSetAll(PI / 360.0f);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			// Transpose four rotators so each register holds one angle of all four.
+			VectorRegister pitch = rotators[i].ToRegister();
+			VectorRegister yaw = rotators[i + 1].ToRegister();
+			VectorRegister roll = rotators[i + 2].ToRegister();
+			VectorRegister unused = rotators[i + 3].ToRegister();
+			VectorTranspose(pitch, yaw, roll, unused);
+
+			VectorRegister sinPitch, cosPitch, sinYaw, cosYaw, sinRoll, cosRoll;
+			ReeeMath::VectorSinCos(VectorMultiply(pitch, degreesToHalfRadians), sinPitch, cosPitch);
+			ReeeMath::VectorSinCos(VectorMultiply(yaw, degreesToHalfRadians), sinYaw, cosYaw);
+			ReeeMath::VectorSinCos(VectorMultiply(roll, degreesToHalfRadians), sinRoll, cosRoll);
+
+			// Combine then transpose back to one quaternion per register.
+			VectorRegister x, y, z, w;
+			Quat::FromHalfAngleSinCos(sinPitch, cosPitch, sinYaw, cosYaw, sinRoll, cosRoll, x, y, z, w);
+			VectorTranspose(x, y, z, w);
+			VectorStoreAligned(x, &outQuaternions[i].X);
+			VectorStoreAligned(y, &outQuaternions[i + 1].X);
+			VectorStoreAligned(z, &outQuaternions[i + 2].X);
+			VectorStoreAligned(w, &outQuaternions[i + 3].X);
+		}
+		for (; i < count; i++)
+		{
+			outQuaternions[i] = rotators[i].ToQuaternion();
+		}
+	}
+}
\ No newline at end of file
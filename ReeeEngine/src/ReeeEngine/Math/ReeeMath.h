@@ -1,7 +1,8 @@
 #pragma once
-#include "../Globals.h"
+#include "VectorRegister.h"
 #include <cmath>
-#include <DirectXMath.h>
+#include <string>
+#include <sstream>
 
 namespace ReeeEngine
 {
@@ -13,7 +14,16 @@ namespace ReeeEngine
 	#define EULERS_NUMBER 2.71828182845904523536f
 	#define GOLDEN_RATIO  1.61803398874989484820f
 
-	/* Will contain any extra classes or structures that are easier to use or not included with DirectXMath.h */
+	/* Measured accuracy of ReeeMath::SinCos, see the math benchmark suite. */
+	#define SINCOS_MAX_ERROR      4.0e-7f
+	#define SINCOS_ACCURATE_RANGE 10000.0f
+
+	/* 2PI split into a part with few enough bits that multiplying it by the quotient is exact, and the remainder. */
+	#define SINCOS_TWO_PI_HIGH 6.28125f
+	#define SINCOS_TWO_PI_LOW  1.9353071795864769e-3f
+
+	/* Will contain any extra math functions that are not part of the vector, rotator or matrix types.
+	 * NOTE: The math headers only depend on the standard library so they compile on any platform. */
 	class ReeeMath
 	{
 	public:
@@ -36,6 +46,7 @@ namespace ReeeEngine
 		 * NOTE: Re-purposed code from Quake that was released through wiki. */
 		static float InvSqrt(float val)
 		{
+#if defined(REEE_SIMD_SSE)
 			const __m128 fOneHalf = _mm_set_ss(0.5f);
 			__m128 y0, x0, x1, x2, fOver2;
 			float temp;
@@ -57,6 +68,82 @@ namespace ReeeEngine
 			// Return the Inverse Square root of the given value.
 			_mm_store_ss(&temp, x2);
 			return temp;
+#else
+			return 1.0f / std::sqrt(val);
+#endif
+		}
+
+		/* Calculate the sine and cosine of an angle in radians at the same time.
+		 * NOTE: Range reduces to [-PI/2, PI/2] with 2PI split in two so the reduction stays exact, then uses an 11 degree sine and 10 degree cosine minimax polynomial.
+		 *       Max absolute error against std::sin/std::cos is SINCOS_MAX_ERROR for angles within +-SINCOS_ACCURATE_RANGE radians,
+		 *       past that the float range reduction loses precision the same way any float sincos does. */
+		static void SinCos(float radians, float& outSin, float& outCos)
+		{
+			// Reduce to [-PI, PI] then mirror into [-PI/2, PI/2] flipping the sign of cosine.
+			const float quotient = std::round(radians * (1.0f / (2.0f * PI)));
+			float y = (radians - quotient * SINCOS_TWO_PI_HIGH) - quotient * SINCOS_TWO_PI_LOW;
+			float cosSign = 1.0f;
+			if (y > PI * 0.5f)
+			{
+				y = PI - y;
+				cosSign = -1.0f;
+			}
+			else if (y < -PI * 0.5f)
+			{
+				y = -PI - y;
+				cosSign = -1.0f;
+			}
+
+			// Evaluate both polynomials.
+			const float y2 = y * y;
+			outSin = y * (1.0f + y2 * (-1.6666667e-1f + y2 * (8.3333310e-3f + y2 * (-1.9840874e-4f + y2 * (2.7525562e-6f + y2 * -2.3889859e-8f)))));
+			outCos = cosSign * (1.0f + y2 * (-0.5f + y2 * (4.1666638e-2f + y2 * (-1.3888378e-3f + y2 * (2.4760495e-5f + y2 * -2.6051615e-7f)))));
+		}
+
+		/* SinCos of four angles at once. Same polynomial and error as the scalar version. */
+		static void VectorSinCos(const VectorRegister& radians, VectorRegister& outSin, VectorRegister& outCos)
+		{
+			// Reduce to [-PI, PI] then mirror into [-PI/2, PI/2] flipping the sign of cosine.
+			const VectorRegister quotient = VectorRound(VectorMultiply(radians, VectorSetAll(1.0f / (2.0f * PI))));
+			VectorRegister y = VectorSubtract(radians, VectorMultiply(quotient, VectorSetAll(SINCOS_TWO_PI_HIGH)));
+			y = VectorSubtract(y, VectorMultiply(quotient, VectorSetAll(SINCOS_TWO_PI_LOW)));
+			const VectorRegister signedPi = VectorSelect(VectorCompareLess(y, VectorZero()), VectorSetAll(-PI), VectorSetAll(PI));
+			const VectorRegister mirror = VectorCompareGreater(VectorAbs(y), VectorSetAll(PI * 0.5f));
+			y = VectorSelect(mirror, VectorSubtract(signedPi, y), y);
+			const VectorRegister cosSign = VectorSelect(mirror, VectorSetAll(-1.0f), VectorSetAll(1.0f));
+
+			// Evaluate both polynomials with horners method.
+			const VectorRegister y2 = VectorMultiply(y, y);
+			VectorRegister sinPoly = VectorMultiplyAdd(y2, VectorSetAll(-2.3889859e-8f), VectorSetAll(2.7525562e-6f));
+			sinPoly = VectorMultiplyAdd(y2, sinPoly, VectorSetAll(-1.9840874e-4f));
+			sinPoly = VectorMultiplyAdd(y2, sinPoly, VectorSetAll(8.3333310e-3f));
+			sinPoly = VectorMultiplyAdd(y2, sinPoly, VectorSetAll(-1.6666667e-1f));
+			sinPoly = VectorMultiplyAdd(y2, sinPoly, VectorSetAll(1.0f));
+			outSin = VectorMultiply(y, sinPoly);
+
+			VectorRegister cosPoly = VectorMultiplyAdd(y2, VectorSetAll(-2.6051615e-7f), VectorSetAll(2.4760495e-5f));
+			cosPoly = VectorMultiplyAdd(y2, cosPoly, VectorSetAll(-1.3888378e-3f));
+			cosPoly = VectorMultiplyAdd(y2, cosPoly, VectorSetAll(4.1666638e-2f));
+			cosPoly = VectorMultiplyAdd(y2, cosPoly, VectorSetAll(-0.5f));
+			cosPoly = VectorMultiplyAdd(y2, cosPoly, VectorSetAll(1.0f));
+			outCos = VectorMultiply(cosSign, cosPoly);
+		}
+
+		/* SinCos of an array of angles in radians, four at a time. Output arrays must hold count floats. */
+		static void SinCosBatch(const float* radians, float* outSin, float* outCos, size_t count)
+		{
+			size_t i = 0;
+			for (; i + 4 <= count; i += 4)
+			{
+				VectorRegister sinResult, cosResult;
+				VectorSinCos(VectorLoad(radians + i), sinResult, cosResult);
+				VectorStore(sinResult, outSin + i);
+				VectorStore(cosResult, outCos + i);
+			}
+			for (; i < count; i++)
+			{
+				SinCos(radians[i], outSin[i], outCos[i]);
+			}
 		}
 
 		/* Convert floating point degrees value to radians. */
@@ -78,10 +165,24 @@ namespace ReeeEngine
 			return (value < min) ? min : (max < value) ? max : value;
 		}
 
+		/* Returns the larger of two values. */
+		template<class T>
+		static T Max(T A, T B)
+		{
+			return (A < B) ? B : A;
+		}
+
+		/* Returns the smaller of two values. */
+		template<class T>
+		static T Min(T A, T B)
+		{
+			return (B < A) ? B : A;
+		}
+
 		/** Return true if value is not infinite and a valid floating point value. */
 		static inline bool IsValid(float value)
 		{
-			return !isnan(value) && isfinite(value);
+			return !std::isnan(value) && std::isfinite(value);
 		}
 
 		/* Absolute function for a float. */
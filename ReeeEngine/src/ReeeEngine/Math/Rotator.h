@@ -1,51 +1,74 @@
 #pragma once
 #include "ReeeMath.h"
+#include "VectorRegister.h"
 
 namespace ReeeEngine
 {
-	/* Rotator declaration. */
-	struct Rotator
+	struct Quat;
+
+	/* Rotator declaration.
+	 * NOTE: Aligned and padded to fill a full SIMD register the same as Vector3D. */
+	struct alignas(16) Rotator
 	{
 	public:
 
 		/* Structure variables. */
 		float Pitch, Yaw, Roll;
 
+	private:
+
+		/* Padding lane so the rotator fills a full register. Not part of the rotators value. */
+		float W;
+
 	public:
 
 		/* Default constructor's. */
-		Rotator() : Pitch(0.0f), Yaw(0.0f), Roll(0.0f) {}
-		Rotator(float val) : Pitch(val), Yaw(val), Roll(val) {}
-		Rotator(float pitch, float yaw, float roll) : Pitch(pitch), Yaw(yaw), Roll(roll) {}
+		Rotator() : Pitch(0.0f), Yaw(0.0f), Roll(0.0f), W(0.0f) {}
+		Rotator(float val) : Pitch(val), Yaw(val), Roll(val), W(0.0f) {}
+		Rotator(float pitch, float yaw, float roll) : Pitch(pitch), Yaw(yaw), Roll(roll), W(0.0f) {}
+		explicit Rotator(const VectorRegister& rotation) { VectorStoreAligned(rotation, &Pitch); }
 
 		//////////////////////////////////////////////////////////////
 		//					  Rotator Functions						//
 		//////////////////////////////////////////////////////////////
 
+		/* Return the SIMD register holding this rotator as (Pitch, Yaw, Roll, 0). */
+		VectorRegister ToRegister() const
+		{
+			return VectorLoadAligned(&Pitch);
+		}
+
 		/* Returns the absolute value of this rotator. */
 		Rotator Abs() const
 		{
-			return Rotator(std::abs(Pitch), std::abs(Yaw), std::abs(Roll));
+			return Rotator(VectorAbs(ToRegister()));
 		}
 
 		/* Returns absolute value of a given rotator. */
 		Rotator Abs(Rotator rotator) const
 		{
-			return Rotator(std::abs(rotator.Pitch), std::abs(rotator.Yaw), std::abs(rotator.Roll));
+			return Rotator(VectorAbs(rotator.ToRegister()));
 		}
 
 		/* Return this rotator in radian values for pitch, yaw and roll. NOTE: Assumes its in degrees... */
 		Rotator ToRadians() const
 		{
-			return Rotator(Pitch * (PI / 180.0f), Yaw * (PI / 180.0f), Roll * (PI / 180.0f));
+			return Rotator(VectorMultiply(ToRegister(), VectorSetAll(PI / 180.0f)));
 		}
 
 		/* Converts this rotator back to degrees. NOTE: Assumes its in radians... */
 		Rotator ToDegrees()
 		{
-			return Rotator((Pitch * 180.0f) / PI, (Yaw * 180.0f) / PI, (Roll * 180.0f) / PI);
+			return Rotator(VectorMultiply(ToRegister(), VectorSetAll(180.0f / PI)));
 		}
 
+		/* Convert this rotator in degrees to a quaternion. Defined in Quat.h.
+		 * NOTE: Uses ReeeMath::VectorSinCos, each component is measured to be within 1e-6 of a double precision conversion. */
+		Quat ToQuaternion() const;
+
+		/* Convert an array of rotators in degrees to quaternions four at a time. Defined in Quat.h. */
+		static void ToQuaternionBatch(const Rotator* rotators, Quat* outQuaternions, size_t count);
+
 		/* Clamp a given angle between 0 and 360 */
 		float ClampAngle(float val) const
 		{
@@ -136,46 +159,40 @@ namespace ReeeEngine
 		/* Override and setup add-equals rotator operator. */
 		Rotator operator+=(const Rotator& otherRotator)
 		{
-			Pitch = Pitch * otherRotator.Pitch;
-			Yaw = Yaw * otherRotator.Yaw;
-			Roll = Roll * otherRotator.Roll;
+			VectorStoreAligned(VectorAdd(ToRegister(), otherRotator.ToRegister()), &Pitch);
 			return *this;
 		}
 
 		/* Override and setup subtract-equals rotator operator. */
 		Rotator operator-=(const Rotator& otherRotator)
 		{
-			Pitch = Pitch - otherRotator.Pitch;
-			Yaw = Yaw - otherRotator.Yaw;
-			Roll = Roll - otherRotator.Roll;
+			VectorStoreAligned(VectorSubtract(ToRegister(), otherRotator.ToRegister()), &Pitch);
 			return *this;
 		}
 
 		/* Override and setup multiply-equals rotator operator. */
 		Rotator operator*=(const Rotator& otherRotator)
 		{
-			Pitch = Pitch * otherRotator.Pitch;
-			Yaw = Yaw * otherRotator.Yaw;
-			Roll = Roll * otherRotator.Roll;
+			VectorStoreAligned(VectorMultiply(ToRegister(), otherRotator.ToRegister()), &Pitch);
 			return *this;
 		}
 
 		/* Override and setup add by rotator operator. */
 		Rotator operator+(const Rotator& otherRotator) const
 		{
-			return Rotator(Pitch + otherRotator.Pitch, Yaw + otherRotator.Yaw, Roll + otherRotator.Roll);
+			return Rotator(VectorAdd(ToRegister(), otherRotator.ToRegister()));
 		}
 
 		/* Override and setup subtract by rotator operator. */
 		Rotator operator-(const Rotator& otherRotator) const
 		{
-			return Rotator(Pitch - otherRotator.Pitch, Yaw - otherRotator.Yaw, Roll - otherRotator.Roll);
+			return Rotator(VectorSubtract(ToRegister(), otherRotator.ToRegister()));
 		}
 
 		/* Override and setup multiply by rotator operator. */
 		Rotator operator*(const Rotator& otherRotator) const
 		{
-			return Rotator(Pitch * otherRotator.Pitch, Yaw * otherRotator.Yaw, Roll * otherRotator.Roll);
+			return Rotator(VectorMultiply(ToRegister(), otherRotator.ToRegister()));
 		}
 
 		/* Override and setup add by value operator. */
@@ -193,15 +210,13 @@ namespace ReeeEngine
 		/* Override and setup multiply by value operator. */
 		Rotator operator*(float val) const
 		{
-			return Rotator(Pitch * val, Yaw * val, Roll * val);
+			return Rotator(VectorMultiply(ToRegister(), VectorSetAll(val)));
 		}
 
 		/* Override and setup multiply-equals value operator. */
 		Rotator operator*=(float val)
 		{
-			Pitch = Pitch * val; 
-			Yaw = Yaw * val; 
-			Roll = Roll * val;
+			VectorStoreAligned(VectorMultiply(ToRegister(), VectorSetAll(val)), &Pitch);
 			return *this;
 		}
 
@@ -223,4 +238,7 @@ namespace ReeeEngine
 			return *this;
 		}
 	};
+
+	/* Ensure the rotator still fills exactly one SIMD register. */
+	static_assert(sizeof(Rotator) == 16 && alignof(Rotator) == 16, "Rotator must match the size and alignment of a VectorRegister.");
 }
\ No newline at end of file
@@ -1,25 +1,41 @@
 #pragma once
 #include "Vector3D.h"
 #include "Rotator.h"
+#include "Quat.h"
+#include "Matrix4x4.h"
 #include "ReeeMath.h"
 
 namespace ReeeEngine
 {
-	/* Transform struct declaration for holding the location, rotation and scale of something. */
-	struct Transform
+	/* Transform struct declaration for holding the location, rotation and scale of something.
+	 * NOTE: The rotation is also cached as a quaternion and the matrix is only rebuilt when the transform changes.
+	 *       Transforms made from quaternions only derive their euler rotator when it is first asked for. */
+	struct alignas(16) Transform
 	{
 	private:
 
 		/* Structure variables. */
 		Vector3D currLocation;
 		Vector3D currScale;
-		Rotator currRotation;
+		mutable Rotator currRotation;
+
+		// Quaternion of the current rotation. This is the source of truth, currRotation is derived from it.
+		Quat currQuaternion;
+
+		// If currRotation still needs to be derived from currQuaternion.
+		mutable bool rotatorDirty;
+
+		// Cached scale * rotation * translation matrix. Only valid while matrixDirty is false.
+		mutable Matrix4x4 cachedMatrix;
+		mutable bool matrixDirty;
 
 	public:
 
 		/* Default constructor's. */
-		Transform() : currLocation(Vector3D(0.0f)), currRotation(Rotator(0.0f)), currScale(Vector3D(1.0f)) {}
-		Transform(Vector3D location, Rotator rotation, Vector3D scale) : currLocation(location), currRotation(rotation), currScale(scale) {}
+		Transform() : currLocation(Vector3D(0.0f)), currScale(Vector3D(1.0f)), currRotation(Rotator(0.0f)),
+			currQuaternion(Quat::Identity()), rotatorDirty(false), cachedMatrix(Matrix4x4::Identity()), matrixDirty(false) {}
+		Transform(Vector3D location, Rotator rotation, Vector3D scale) : currLocation(location), currScale(scale), currRotation(rotation),
+			currQuaternion(Quat::FromRotator(rotation)), rotatorDirty(false), cachedMatrix(), matrixDirty(true) {}
 
 		/* Get location of transform. */
 		Vector3D GetLocation() const
@@ -30,9 +46,20 @@ namespace ReeeEngine
 		/* Get rotation of transform. */
 		Rotator GetRotation() const
 		{
+			if (rotatorDirty)
+			{
+				currRotation = currQuaternion.ToRotator();
+				rotatorDirty = false;
+			}
 			return currRotation;
 		}
 
+		/* Get the cached quaternion of the transforms rotation. */
+		Quat GetQuaternion() const
+		{
+			return currQuaternion;
+		}
+
 		/* Get scale of transform. */
 		Vector3D GetScale() const
 		{
@@ -43,85 +70,133 @@ namespace ReeeEngine
 		void SetLocation(const Vector3D& newLocation)
 		{
 			currLocation = newLocation;
+			matrixDirty = true;
 		}
 
 		/* Set rotation of transform. */
 		void SetRotation(const Rotator& newRotation)
 		{
+			if (!rotatorDirty && newRotation == currRotation) return;
 			currRotation = newRotation;
+			currQuaternion = Quat::FromRotator(newRotation);
+			rotatorDirty = false;
+			matrixDirty = true;
+		}
+
+		/* Set rotation of transform from a quaternion. The rotator is derived from it. */
+		void SetQuaternion(const Quat& newQuaternion)
+		{
+			currQuaternion = newQuaternion;
+			rotatorDirty = true;
+			matrixDirty = true;
 		}
 
 		/* Set scale of transform. */
 		void SetScale(const Vector3D& newScale)
 		{
 			currScale = newScale;
+			matrixDirty = true;
+		}
+
+		/* Transform a location by this transform. Applies scale, then rotation, then translation. */
+		Vector3D TransformPosition(const Vector3D& position) const
+		{
+			return currQuaternion.RotateVector(position * currScale) + currLocation;
+		}
+
+		/* Transform a world location into the local space of this transform. Inverse of TransformPosition. */
+		Vector3D InverseTransformPosition(const Vector3D& position) const
+		{
+			return currQuaternion.UnrotateVector(position - currLocation) / GetSafeScale(currScale);
+		}
+
+		/* Returns this transform applied on top of a parent transform, e.g. a relative transform into world space.
+		 * NOTE: Scale is multiplied per axis so a non uniform parent scale with a rotated child is approximated like most engines do. */
+		Transform GetComposed(const Transform& parent) const
+		{
+			Transform result;
+			result.currLocation = parent.TransformPosition(currLocation);
+			result.currQuaternion = (currQuaternion * parent.currQuaternion).GetNormal();
+			result.rotatorDirty = true;
+			result.currScale = currScale * parent.currScale;
+			result.matrixDirty = true;
+			return result;
+		}
+
+		/* Returns this transform relative to a parent transform. Inverse of GetComposed. */
+		Transform GetRelativeTo(const Transform& parent) const
+		{
+			Transform result;
+			result.currLocation = parent.InverseTransformPosition(currLocation);
+			result.currQuaternion = (currQuaternion * parent.currQuaternion.GetInverse()).GetNormal();
+			result.rotatorDirty = true;
+			result.currScale = currScale / GetSafeScale(parent.currScale);
+			result.matrixDirty = true;
+			return result;
 		}
 
 		/* Get the transforms up vector while taking world rotation into account. */
-		Vector3D GetUpVector()
+		Vector3D GetUpVector() const
 		{
 			// Calculate and return the up vector based off rotation.
 			return TransformVector(Vector3D(0.0f, 1.0f, 0.0f));
 		}
 
 		/* Get the transforms forward vector while taking world rotation into account. */
-		Vector3D GetForwardVector()
+		Vector3D GetForwardVector() const
 		{
 			// Calculate and return the forward vector based off rotation.
 			return TransformVector(Vector3D(0.0f, 0.0f, 1.0f));
 		}
 
 		/* Get the transforms right vector while taking world rotation into account. */
-		Vector3D GetRightVector()
+		Vector3D GetRightVector() const
 		{
 			// Calculate and return the right vector based off rotation.
 			return TransformVector(Vector3D(1.0f, 0.0f, 0.0f));
 		}
 
-		Vector3D TransformVector(const Vector3D& vector)
+		/* Rotate a given vector by this transforms rotation using the cached quaternion. */
+		Vector3D TransformVector(const Vector3D& vector) const
 		{
-			// Calculate and return the vector based off rotation.
-			DirectX::XMVECTOR baseVector = DirectX::XMLoadFloat3(&vector.ToFloat3());
-			Rotator rotation = currRotation.ToRadians();
-			DirectX::XMVECTOR rotationVec = DirectX::XMQuaternionRotationRollPitchYaw(rotation.Pitch, rotation.Yaw, rotation.Roll);
-			DirectX::XMVECTOR rotatedVec = DirectX::XMVector3Rotate(baseVector, rotationVec);
-
-			// Get readable vector as Vector3D and return.
-			DirectX::XMFLOAT3 readableVector;
-			DirectX::XMStoreFloat3(&readableVector, rotatedVec);
-			return Vector3D(readableVector.x, readableVector.y, readableVector.z);
+			return currQuaternion.RotateVector(vector);
 		}
 
-		/* Get the DirectX transform from this vector for performing matrix calculations. */
-		DirectX::XMMATRIX GetTransformAsMatrix()
+		/* Get the matrix of this transform for performing matrix calculations.
+		 * NOTE: Only rebuilt if the location, rotation or scale has changed since the last call. */
+		const Matrix4x4& GetTransformAsMatrix() const
 		{
-			Rotator rotRad = currRotation.ToRadians();
-			return DirectX::XMMatrixScaling(currScale.X, currScale.Y, currScale.Z) * DirectX::XMMatrixRotationRollPitchYaw(rotRad.Pitch, rotRad.Yaw, rotRad.Roll) *
-				DirectX::XMMatrixTranslation(currLocation.X, currLocation.Y, currLocation.Z);
+			if (matrixDirty)
+			{
+				cachedMatrix = Matrix4x4::Compose(currScale, currQuaternion, currLocation);
+				matrixDirty = false;
+			}
+			return cachedMatrix;
 		}
 
 		/* Setup this transform from a given matrix transform. */
-		void SetTransformFromMatrix(const DirectX::XMMATRIX& newMatrix)
-		{
-			// Get vector values for location rotation and scale from the given matrix.
-			DirectX::XMVECTOR loc, rot, scal;
-			DirectX::XMMatrixDecompose(&loc, &rot, &scal, newMatrix);
-			
-			// Update location values.
-			DirectX::XMFLOAT4 location;
-			DirectX::XMStoreFloat4(&location, loc);
-			currLocation = Vector3D(location.x, location.y, location.z);
-
-			// Update rotation values convert back to degrees before updating values.
-			DirectX::XMFLOAT4 rotation;
-			DirectX::XMStoreFloat4(&rotation, rot);
-			Rotator currRotationRad = Rotator(rotation.x, rotation.y, rotation.z);
-			currRotation = currRotationRad.ToDegrees();
-
-			// Update scale values.
-			DirectX::XMFLOAT4 scale;
-			DirectX::XMStoreFloat4(&scale, scal);
-			currScale = Vector3D(scale.x, scale.y, scale.z);
+		void SetTransformFromMatrix(const Matrix4x4& newMatrix)
+		{
+			// Get the location, rotation and scale from the given matrix.
+			Quat newRotation;
+			newMatrix.Decompose(currScale, newRotation, currLocation);
+
+			// Keep the decomposed quaternion as the source of truth and only derive the euler rotator from it.
+			currQuaternion = newRotation;
+			rotatorDirty = true;
+
+			// The given matrix is already the matrix of this transform.
+			cachedMatrix = newMatrix;
+			matrixDirty = false;
+		}
+
+	private:
+
+		/* Returns a scale that is safe to divide by, zero axes are treated as one. */
+		static Vector3D GetSafeScale(const Vector3D& scale)
+		{
+			return Vector3D(ReeeMath::Abs(scale.X) > SMALL_NUMBER ? scale.X : 1.0f, ReeeMath::Abs(scale.Y) > SMALL_NUMBER ? scale.Y : 1.0f,
+				ReeeMath::Abs(scale.Z) > SMALL_NUMBER ? scale.Z : 1.0f);
 		}
 	};
 }
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 #include "ReeeMath.h"
+#include "VectorRegister.h"
 
 namespace ReeeEngine
 {
-	/* 2D Vector deceleration. */
-	struct Vector2D
+	/* 2D Vector deceleration.
+	 * NOTE: Aligned to 8 bytes so X and Y can be moved in and out of the low half of a SIMD register in one load/store. */
+	struct alignas(8) Vector2D
 	{
 	public:
 
@@ -19,6 +21,7 @@ namespace ReeeEngine
 		Vector2D(int val) : X((float)val), Y((float)val) {}
 		Vector2D(float x, float y) : X(x), Y(y) {}
 		Vector2D(int x, int y) : X((float)x), Y((float)y) {}
+		explicit Vector2D(const VectorRegister& vector) { VectorStoreFloat2(vector, &X); }
 
 		////////////////////////////////////////////////
 		/* Functions to help work with the FVector2D. */
@@ -31,16 +34,24 @@ namespace ReeeEngine
 			Y = newX;
 		}
 
+		/* Return the SIMD register holding this vector as (X, Y, 0, 0). */
+		VectorRegister ToRegister() const
+		{
+			return VectorLoadFloat2(&X);
+		}
+
 		/* Returns the size of the vector. (Length.) */
 		float Size() const
 		{
-			return std::sqrt(X * X + Y * Y);
+			const VectorRegister vector = ToRegister();
+			return VectorGetX(VectorSqrt(VectorDot2(vector, vector)));
 		}
 
 		/* Returns the size of the vector squared. (Length squared) */
 		float SizeSquared() const
 		{
-			return X * X + Y * Y;
+			const VectorRegister vector = ToRegister();
+			return VectorGetX(VectorDot2(vector, vector));
 		}
 
 		/* @Param tolerance, the tolerance to check from 0.
@@ -103,11 +114,11 @@ namespace ReeeEngine
 		/* Returns the normal of the given 2D Vector. */
 		Vector2D GetNormal(float tolerance = 0.0f) const
 		{
-			const float vectorSizeSquared = SizeSquared();
-			if (vectorSizeSquared > tolerance)
+			const VectorRegister vector = ToRegister();
+			const VectorRegister vectorSizeSquared = VectorDot2(vector, vector);
+			if (VectorGetX(vectorSizeSquared) > tolerance)
 			{
-				const float scale = ReeeMath::InvSqrt(vectorSizeSquared);
-				return Vector2D(X * scale, Y * scale);
+				return Vector2D(VectorMultiply(vector, VectorReciprocalSqrt(vectorSizeSquared)));
 			}
 			return Vector2D(0.0f, 0.0f);
 		}
@@ -115,16 +126,7 @@ namespace ReeeEngine
 		/* Normalize the 2D vector. */
 		void Normalize(float tolerance = 0.0f)
 		{
-			const float vectorSizeSquared = SizeSquared();
-			if (vectorSizeSquared > tolerance)
-			{
-				const float scale = ReeeMath::InvSqrt(vectorSizeSquared);
-				X *= scale;
-				Y *= scale;
-				return;
-			}
-			X = 0.0f;
-			Y = 0.0f;
+			*this = GetNormal(tolerance);
 		}
 
 		/* Returns the clamp the vector between a min and max value across all axis. */
@@ -202,7 +204,7 @@ namespace ReeeEngine
 		/* Override the operator for mod. */
 		inline float operator|(const Vector2D& otherVector) const
 		{
-			return X * otherVector.X + Y * otherVector.Y;
+			return VectorGetX(VectorDot2(ToRegister(), otherVector.ToRegister()));
 		}
 
 		/* Override the power operator. */
@@ -295,4 +297,7 @@ namespace ReeeEngine
 			return *this;
 		}
 	};
+
+	/* Ensure the vector can still be moved as a single 64 bit value. */
+	static_assert(sizeof(Vector2D) == 8 && alignof(Vector2D) == 8, "Vector2D must stay packed into 8 bytes.");
 }
\ No newline at end of file
@@ -1,22 +1,30 @@
 #pragma once
 #include "ReeeMath.h"
+#include "VectorRegister.h"
 
 namespace ReeeEngine
 {
-	/* 3D Vector deceleration. */
-	struct Vector3D
+	/* 3D Vector deceleration.
+	 * NOTE: Aligned and padded to fill a full SIMD register so it can be loaded/stored in one instruction. */
+	struct alignas(16) Vector3D
 	{
 	public:
 
 		/* Structure variables. */
 		float X, Y, Z;
 
+	private:
+
+		/* Padding lane so the vector fills a full register. Not part of the vectors value. */
+		float W;
+
 	public:
 
 		/* Default constructor's. */
-		Vector3D() : X(0.0f), Y(0.0f), Z(0.0f) {}
-		Vector3D(float val) : X(val), Y(val), Z(val) {}
-		Vector3D(float x, float y, float z) : X(x), Y(y), Z(z) {}
+		Vector3D() : X(0.0f), Y(0.0f), Z(0.0f), W(0.0f) {}
+		Vector3D(float val) : X(val), Y(val), Z(val), W(0.0f) {}
+		Vector3D(float x, float y, float z) : X(x), Y(y), Z(z), W(0.0f) {}
+		explicit Vector3D(const VectorRegister& vector) { VectorStoreAligned(vector, &X); }
 
 		////////////////////////////////////////////////
 		/* Functions to help work with the FVector3D. */
@@ -26,23 +34,30 @@ namespace ReeeEngine
 		void Set(float newX, float newY, float newZ)
 		{
 			X = newX;
-			Y = newX;
+			Y = newY;
 			Z = newZ;
 		}
 
+		/* Return the SIMD register holding this vector. */
+		VectorRegister ToRegister() const
+		{
+			return VectorLoadAligned(&X);
+		}
+
 		/* Distance between this vector and other vector. */
 		float Distance(Vector3D& otherVector)
 		{
-			return Abs(Vector3D(X - otherVector.X, Y - otherVector.Y, Z - otherVector.Z)).Size();
+			return (*this - otherVector).Size();
 		}
 
 		/* Returns the size of the vector. */
 		float Size() const
 		{
-			return std::sqrt(X * X + Y * Y + Z * Z);
+			return std::sqrt(SizeSquared());
 		}
 
-		/* Returns the size of the vector squared. */
+		/* Returns the size of the vector squared. Float results are worked out from the components as a register dot product
+		 * costs more than it saves once its result has to be moved back out of the register. */
 		float SizeSquared() const
 		{
 			return X * X + Y * Y + Z * Z;
@@ -105,36 +120,25 @@ namespace ReeeEngine
 		/* Returns absolute value of a vector 2d. */
 		Vector3D Abs(Vector3D vector)
 		{
-			return Vector3D(std::abs(vector.X), std::abs(vector.Y), std::abs(vector.Z));
+			return Vector3D(VectorAbs(vector.ToRegister()));
 		}
 
 		/* Returns the normal of the given 3D Vector. */
 		Vector3D GetNormal(float tolerance = 0.0f) const
 		{
-			const float vectorSizeSquared = SizeSquared();
-			if (vectorSizeSquared > tolerance)
+			const VectorRegister vector = ToRegister();
+			const VectorRegister vectorSizeSquared = VectorDot3(vector, vector);
+			if (VectorGetX(vectorSizeSquared) > tolerance)
 			{
-				const float scale = ReeeMath::InvSqrt(vectorSizeSquared);
-				return Vector3D(X * scale, Y * scale, Z * scale);
+				return Vector3D(VectorMultiply(vector, VectorReciprocalSqrt(vectorSizeSquared)));
 			}
 			return Vector3D(0.0f, 0.0f, 0.0f);
 		}
 
-		/* Normalize the 2D vector. */
+		/* Normalize the 3D vector. */
 		void Normalize(float tolerance = 0.0f)
 		{
-			const float vectorSizeSquared = SizeSquared();
-			if (vectorSizeSquared > tolerance)
-			{
-				const float scale = ReeeMath::InvSqrt(vectorSizeSquared);
-				X *= scale;
-				Y *= scale;
-				Z *= scale;
-				return;
-			}
-			X = 0.0f;
-			Y = 0.0f;
-			Z = 0.0f;
+			*this = GetNormal(tolerance);
 		}
 
 		/* Returns the clamp the vector between a min and max value across all axis. */
@@ -146,7 +150,7 @@ namespace ReeeEngine
 		/* Returns the absolute value of this vector. */
 		Vector3D Abs()
 		{
-			return Vector3D(std::abs(X), std::abs(Y), std::abs(Z));
+			return Vector3D(VectorAbs(ToRegister()));
 		}
 
 		/* Returns world up vector. */
@@ -175,12 +179,6 @@ namespace ReeeEngine
 			return stream.str();
 		}
 
-		/* Return DirectX based XMFloat3 vector from this vector. */
-		DirectX::XMFLOAT3 ToFloat3() const
-		{
-			return { X, Y, Z };
-		}
-
 		/* Override and setup equals operator. */
 		inline bool operator==(const Vector3D& otherVector) const
 		{
@@ -198,19 +196,19 @@ namespace ReeeEngine
 		/* Override and setup add operator. */
 		inline Vector3D operator+(const Vector3D& otherVector) const
 		{
-			return Vector3D(X + otherVector.X, Y + otherVector.Y, Z + otherVector.Z);
+			return Vector3D(VectorAdd(ToRegister(), otherVector.ToRegister()));
 		}
 
 		/* Override and setup subtract operator. */
 		inline Vector3D operator-(const Vector3D& otherVector) const
 		{
-			return Vector3D(X - otherVector.X, Y - otherVector.Y, Z - otherVector.Z);
+			return Vector3D(VectorSubtract(ToRegister(), otherVector.ToRegister()));
 		}
 
 		/* Override and setup negate operator. */
 		inline Vector3D operator-() const
 		{
-			return Vector3D(-X, -Y, -Z);
+			return Vector3D(VectorNegate(ToRegister()));
 		}
 
 		/* Override and setup divide operator. */
@@ -222,7 +220,7 @@ namespace ReeeEngine
 		/* Override and setup multiplication operator. */
 		inline Vector3D operator*(const Vector3D& otherVector) const
 		{
-			return Vector3D(X * otherVector.X, Y * otherVector.Y, Z * otherVector.Z);
+			return Vector3D(VectorMultiply(ToRegister(), otherVector.ToRegister()));
 		}
 
 		/* Override the operator for mod. */
@@ -234,19 +232,19 @@ namespace ReeeEngine
 		/* Override the power operator. */
 		inline Vector3D operator^(const Vector3D& otherVector) const
 		{
-			return Vector3D(Y * otherVector.Z - Z * otherVector.Y, Z * otherVector.X - X * otherVector.Z, X * otherVector.Y - Y * otherVector.X);
+			return Vector3D(VectorCross3(ToRegister(), otherVector.ToRegister()));
 		}
 
 		/* Override the subtract float operator. */
 		inline Vector3D operator-(float number) const
 		{
-			return Vector3D(X - number, Y - number, Z - number);
+			return Vector3D(VectorSubtract(ToRegister(), VectorSetAll(number)));
 		}
 
 		/* Override the add float operator. */
 		inline Vector3D operator+(float number) const
 		{
-			return Vector3D(X + number, Y + number, Z + number);
+			return Vector3D(VectorAdd(ToRegister(), VectorSetAll(number)));
 		}
 
 		/* Override less than operator. */
@@ -276,46 +274,35 @@ namespace ReeeEngine
 		/* Overrides the plus equals operator. */
 		inline Vector3D operator+=(const Vector3D& otherVector)
 		{
-			X += otherVector.X;
-			Y += otherVector.Y;
-			Z += otherVector.Z;
+			VectorStoreAligned(VectorAdd(ToRegister(), otherVector.ToRegister()), &X);
 			return *this;
 		}
 
 		/* Overrides the subtract equals operator. */
 		inline Vector3D operator-=(const Vector3D& otherVector)
 		{
-			X -= otherVector.X;
-			Y -= otherVector.Y;
-			Z -= otherVector.Z;
+			VectorStoreAligned(VectorSubtract(ToRegister(), otherVector.ToRegister()), &X);
 			return *this;
 		}
 
 		/* Overrides the multiply equals float operator. */
 		inline Vector3D operator*=(float number)
 		{
-			X *= number;
-			Y *= number;
-			Z *= number;
+			VectorStoreAligned(VectorMultiply(ToRegister(), VectorSetAll(number)), &X);
 			return *this;
 		}
 
 		/* Overrides the divide equals float operator. */
 		inline Vector3D operator/=(float number)
 		{
-			const float div = 1.f / number;
-			X *= div;
-			Y *= div;
-			Z *= div;
+			VectorStoreAligned(VectorMultiply(ToRegister(), VectorSetAll(1.f / number)), &X);
 			return *this;
 		}
 
 		/* Overrides the multiply equals 3D vector operator. */
 		inline Vector3D operator*=(const Vector3D& otherVector)
 		{
-			X *= otherVector.X;
-			Y *= otherVector.Y;
-			Z *= otherVector.Z;
+			VectorStoreAligned(VectorMultiply(ToRegister(), otherVector.ToRegister()), &X);
 			return *this;
 		}
 
@@ -328,4 +315,7 @@ namespace ReeeEngine
 			return *this;
 		}
 	};
+
+	/* Ensure the vector still fills exactly one SIMD register. */
+	static_assert(sizeof(Vector3D) == 16 && alignof(Vector3D) == 16, "Vector3D must match the size and alignment of a VectorRegister.");
 }
\ No newline at end of file
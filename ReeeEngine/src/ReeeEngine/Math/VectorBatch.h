@@ -0,0 +1,530 @@
+#pragma once
+#include "ReeeMath.h"
+#include "VectorRegister.h"
+#include "Vector3D.h"
+#include "Matrix4x4.h"
+#include "../Threading/ParallelFor.h"
+#include <cstdint>
+
+namespace ReeeEngine
+{
+	/* Register type used by the batch kernels. Holds the same component of 8 vectors on AVX2, 4 on SSE/NEON and 1 without SIMD. */
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+	typedef __m256 BatchRegister;
+	constexpr size_t BatchWidth = 8;
+#elif defined(REEE_SIMD_SSE)
+	typedef __m128 BatchRegister;
+	constexpr size_t BatchWidth = 4;
+#elif defined(REEE_SIMD_NEON)
+	typedef float32x4_t BatchRegister;
+	constexpr size_t BatchWidth = 4;
+#else
+	typedef float BatchRegister;
+	constexpr size_t BatchWidth = 1;
+#endif
+
+	//////////////////////////////////////////////////////////////
+	//					  Batch Register Functions				//
+	//////////////////////////////////////////////////////////////
+
+	/* Set every lane to the same value. */
+	inline BatchRegister BatchSetAll(float value)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_set1_ps(value);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_set1_ps(value);
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(value);
+#else
+		return value;
+#endif
+	}
+
+	/* Load BatchWidth floats from any address. */
+	inline BatchRegister BatchLoad(const float* source)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_loadu_ps(source);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_loadu_ps(source);
+#elif defined(REEE_SIMD_NEON)
+		return vld1q_f32(source);
+#else
+		return *source;
+#endif
+	}
+
+	/* Store BatchWidth floats to any address. */
+	inline void BatchStore(const BatchRegister& value, float* destination)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		_mm256_storeu_ps(destination, value);
+#elif defined(REEE_SIMD_SSE)
+		_mm_storeu_ps(destination, value);
+#elif defined(REEE_SIMD_NEON)
+		vst1q_f32(destination, value);
+#else
+		*destination = value;
+#endif
+	}
+
+	/* Per lane A + B. */
+	inline BatchRegister BatchAdd(const BatchRegister& A, const BatchRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_add_ps(A, B);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_add_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vaddq_f32(A, B);
+#else
+		return A + B;
+#endif
+	}
+
+	/* Per lane A - B. */
+	inline BatchRegister BatchSubtract(const BatchRegister& A, const BatchRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_sub_ps(A, B);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_sub_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vsubq_f32(A, B);
+#else
+		return A - B;
+#endif
+	}
+
+	/* Per lane A * B. */
+	inline BatchRegister BatchMultiply(const BatchRegister& A, const BatchRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_mul_ps(A, B);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_mul_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vmulq_f32(A, B);
+#else
+		return A * B;
+#endif
+	}
+
+	/* Per lane (A * B) + C. */
+	inline BatchRegister BatchMultiplyAdd(const BatchRegister& A, const BatchRegister& B, const BatchRegister& C)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_FMA)
+		return _mm256_fmadd_ps(A, B, C);
+#elif defined(REEE_SIMD_NEON)
+		return vmlaq_f32(C, A, B);
+#else
+		return BatchAdd(BatchMultiply(A, B), C);
+#endif
+	}
+
+	/* Per lane minimum. */
+	inline BatchRegister BatchMin(const BatchRegister& A, const BatchRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_min_ps(A, B);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_min_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vminq_f32(A, B);
+#else
+		return A < B ? A : B;
+#endif
+	}
+
+	/* Per lane maximum. */
+	inline BatchRegister BatchMax(const BatchRegister& A, const BatchRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_max_ps(A, B);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_max_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vmaxq_f32(A, B);
+#else
+		return A > B ? A : B;
+#endif
+	}
+
+	/* Per lane absolute value. */
+	inline BatchRegister BatchAbs(const BatchRegister& A)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), A);
+#elif defined(REEE_SIMD_SSE) || defined(REEE_SIMD_NEON)
+		return VectorAbs(A);
+#else
+		return std::abs(A);
+#endif
+	}
+
+	/* Per lane A < B. Returns a mask to be used with BatchMoveMask. */
+	inline BatchRegister BatchCompareLess(const BatchRegister& A, const BatchRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return _mm256_cmp_ps(A, B, _CMP_LT_OQ);
+#elif defined(REEE_SIMD_SSE) || defined(REEE_SIMD_NEON)
+		return VectorCompareLess(A, B);
+#else
+		return A < B ? 1.0f : 0.0f;
+#endif
+	}
+
+	/* Returns one bit per lane of a compare mask, lane 0 in bit 0. */
+	inline unsigned int BatchMoveMask(const BatchRegister& mask)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		return (unsigned int)_mm256_movemask_ps(mask);
+#elif defined(REEE_SIMD_SSE) || defined(REEE_SIMD_NEON)
+		return VectorMoveMask(mask);
+#else
+		return mask != 0.0f ? 1u : 0u;
+#endif
+	}
+
+	/* Per lane 1 / sqrt(A). Uses the hardware estimate followed by one Newton-Raphson step (~22 bits of precision). */
+	inline BatchRegister BatchReciprocalSqrt(const BatchRegister& A)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_AVX2)
+		const __m256 estimate = _mm256_rsqrt_ps(A);
+		const __m256 halfA = _mm256_mul_ps(A, _mm256_set1_ps(0.5f));
+		return _mm256_mul_ps(estimate, _mm256_sub_ps(_mm256_set1_ps(1.5f), _mm256_mul_ps(halfA, _mm256_mul_ps(estimate, estimate))));
+#elif defined(REEE_SIMD_SSE) || defined(REEE_SIMD_NEON)
+		return VectorReciprocalSqrt(A);
+#else
+		return 1.0f / std::sqrt(A);
+#endif
+	}
+
+	/* Normalize BatchWidth vectors held as separate X, Y and Z registers. Zero length vectors stay zero. */
+	inline void BatchNormalize3(BatchRegister& x, BatchRegister& y, BatchRegister& z)
+	{
+		const BatchRegister sizeSquared = BatchMultiplyAdd(x, x, BatchMultiplyAdd(y, y, BatchMultiply(z, z)));
+		const BatchRegister invSize = BatchReciprocalSqrt(BatchMax(sizeSquared, BatchSetAll(1.e-30f)));
+		x = BatchMultiply(x, invSize);
+		y = BatchMultiply(y, invSize);
+		z = BatchMultiply(z, invSize);
+	}
+
+	/* Batched structure of arrays kernels for processing large sets of vectors at once, e.g. mesh vertices.
+	 * NOTE: The strided functions take a byte stride so they can read/write vectors straight out of vertex structs,
+	 *       vectors are gathered into BatchWidth sized SoA blocks so all of the math is done on full registers.
+	 *       Inputs larger than ParallelBatchSize are split across threads. */
+	class VectorBatch
+	{
+	public:
+
+		/* Delete Constructors. */
+		VectorBatch() = delete;
+		VectorBatch(const VectorBatch&) = delete;
+		VectorBatch& operator = (const VectorBatch&) = delete;
+
+		// Minimum number of vectors each thread is given when splitting up large inputs.
+		static constexpr size_t ParallelBatchSize = 4096;
+
+	public:
+
+		//////////////////////////////////////////////////////////////
+		//					  Structure Of Arrays					//
+		//////////////////////////////////////////////////////////////
+
+		/* Transform count positions stored as separate X, Y and Z arrays in place (includes translation). */
+		static void TransformPositionsSoA(const Matrix4x4& matrix, float* x, float* y, float* z, size_t count)
+		{
+			const BatchMatrix batchMatrix(matrix, true);
+			ParallelFor(count, ParallelBatchSize, [&](size_t begin, size_t end)
+			{
+				size_t i = begin;
+				for (; i + BatchWidth <= end; i += BatchWidth)
+				{
+					batchMatrix.Transform(x + i, y + i, z + i);
+				}
+				for (; i < end; i++)
+				{
+					batchMatrix.TransformSingle(x[i], y[i], z[i]);
+				}
+			});
+		}
+
+		/* Transform count normals stored as separate X, Y and Z arrays in place. Uses the inverse transpose so non uniform scale is handled. */
+		static void TransformNormalsSoA(const Matrix4x4& matrix, float* x, float* y, float* z, size_t count)
+		{
+			const BatchMatrix batchMatrix(GetNormalMatrix(matrix), false);
+			ParallelFor(count, ParallelBatchSize, [&](size_t begin, size_t end)
+			{
+				size_t i = begin;
+				for (; i + BatchWidth <= end; i += BatchWidth)
+				{
+					batchMatrix.Transform(x + i, y + i, z + i, true);
+				}
+				for (; i < end; i++)
+				{
+					batchMatrix.TransformSingle(x[i], y[i], z[i], true);
+				}
+			});
+		}
+
+		//////////////////////////////////////////////////////////////
+		//					  Strided Arrays						//
+		//////////////////////////////////////////////////////////////
+
+		/* Transform count positions read from source and written to destination, both can be the same array.
+		 * Strides are in bytes between each vector, e.g. sizeof(Vertex). */
+		static void TransformPositions(const Matrix4x4& matrix, const float* source, size_t sourceStride, float* destination, size_t destinationStride, size_t count)
+		{
+			const BatchMatrix batchMatrix(matrix, true);
+			ParallelFor(count, ParallelBatchSize, [&](size_t begin, size_t end)
+			{
+				TransformStridedRange(batchMatrix, false, source, sourceStride, destination, destinationStride, begin, end);
+			});
+		}
+
+		/* Transform count positions in place. */
+		static void TransformPositions(const Matrix4x4& matrix, float* positions, size_t stride, size_t count)
+		{
+			TransformPositions(matrix, positions, stride, positions, stride, count);
+		}
+
+		/* Transform and renormalize count normals read from source and written to destination, both can be the same array. */
+		static void TransformNormals(const Matrix4x4& matrix, const float* source, size_t sourceStride, float* destination, size_t destinationStride, size_t count)
+		{
+			const BatchMatrix batchMatrix(GetNormalMatrix(matrix), false);
+			ParallelFor(count, ParallelBatchSize, [&](size_t begin, size_t end)
+			{
+				TransformStridedRange(batchMatrix, true, source, sourceStride, destination, destinationStride, begin, end);
+			});
+		}
+
+		/* Transform and renormalize count normals in place. */
+		static void TransformNormals(const Matrix4x4& matrix, float* normals, size_t stride, size_t count)
+		{
+			TransformNormals(matrix, normals, stride, normals, stride, count);
+		}
+
+		/* Compute the normalized face normal of every triangle in an index list into separate X, Y and Z arrays of indexCount / 3 floats.
+		 * NOTE: Winding is the same as the rest of the engine, normal = (p1 - p0) x (p2 - p0). */
+		static void ComputeFaceNormals(const float* positions, size_t stride, const unsigned short* indices, size_t indexCount, float* normalX, float* normalY, float* normalZ)
+		{
+			const size_t triangleCount = indexCount / 3;
+			ParallelFor(triangleCount, ParallelBatchSize, [&](size_t begin, size_t end)
+			{
+				alignas(32) float p[9][BatchWidth];
+				for (size_t i = begin; i < end; i += BatchWidth)
+				{
+					// Gather the three corners of each triangle in the block, padding the last block with the final triangle.
+					const size_t blockSize = std::min(BatchWidth, end - i);
+					for (size_t lane = 0; lane < BatchWidth; lane++)
+					{
+						const size_t triangle = i + std::min(lane, blockSize - 1);
+						for (size_t corner = 0; corner < 3; corner++)
+						{
+							const float* vertex = GetStrided(positions, stride, indices[triangle * 3 + corner]);
+							p[corner * 3][lane] = vertex[0];
+							p[corner * 3 + 1][lane] = vertex[1];
+							p[corner * 3 + 2][lane] = vertex[2];
+						}
+					}
+
+					// Cross the two edges of every triangle at once.
+					const BatchRegister p0x = BatchLoad(p[0]), p0y = BatchLoad(p[1]), p0z = BatchLoad(p[2]);
+					const BatchRegister e1x = BatchSubtract(BatchLoad(p[3]), p0x), e1y = BatchSubtract(BatchLoad(p[4]), p0y), e1z = BatchSubtract(BatchLoad(p[5]), p0z);
+					const BatchRegister e2x = BatchSubtract(BatchLoad(p[6]), p0x), e2y = BatchSubtract(BatchLoad(p[7]), p0y), e2z = BatchSubtract(BatchLoad(p[8]), p0z);
+					BatchRegister nx = BatchSubtract(BatchMultiply(e1y, e2z), BatchMultiply(e1z, e2y));
+					BatchRegister ny = BatchSubtract(BatchMultiply(e1z, e2x), BatchMultiply(e1x, e2z));
+					BatchRegister nz = BatchSubtract(BatchMultiply(e1x, e2y), BatchMultiply(e1y, e2x));
+					BatchNormalize3(nx, ny, nz);
+
+					// Write out the block.
+					if (blockSize == BatchWidth)
+					{
+						BatchStore(nx, normalX + i);
+						BatchStore(ny, normalY + i);
+						BatchStore(nz, normalZ + i);
+					}
+					else
+					{
+						BatchStore(nx, p[0]);
+						BatchStore(ny, p[1]);
+						BatchStore(nz, p[2]);
+						for (size_t lane = 0; lane < blockSize; lane++)
+						{
+							normalX[i + lane] = p[0][lane];
+							normalY[i + lane] = p[1][lane];
+							normalZ[i + lane] = p[2][lane];
+						}
+					}
+				}
+			});
+		}
+
+		/* Compute the axis aligned bounds of count positions. Returns false and zero bounds if there are no positions. */
+		static bool ComputeBounds(const float* positions, size_t stride, size_t count, Vector3D& outMin, Vector3D& outMax)
+		{
+			if (count == 0)
+			{
+				outMin = outMax = Vector3D(0.0f);
+				return false;
+			}
+
+			// Split into one chunk per thread, each chunk writes its own bounds which are then merged on this thread.
+			const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(GetParallelThreadCount(), count / ParallelBatchSize));
+			const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+			std::vector<Vector3D> chunkMin(chunkCount, Vector3D(BIG_NUMBER));
+			std::vector<Vector3D> chunkMax(chunkCount, Vector3D(-BIG_NUMBER));
+			ParallelFor(chunkCount, 1, [&](size_t firstChunk, size_t lastChunk)
+			{
+				for (size_t chunk = firstChunk; chunk < lastChunk; chunk++)
+				{
+					const size_t begin = chunk * chunkSize;
+					const size_t end = std::min(count, begin + chunkSize);
+					BatchRegister minX = BatchSetAll(BIG_NUMBER), minY = minX, minZ = minX;
+					BatchRegister maxX = BatchSetAll(-BIG_NUMBER), maxY = maxX, maxZ = maxX;
+					alignas(32) float x[BatchWidth], y[BatchWidth], z[BatchWidth];
+					for (size_t i = begin; i < end; i += BatchWidth)
+					{
+						// Pad a partial block with its first vector so it can not change the result.
+						const size_t blockSize = GatherBlock(positions, stride, i, end, x, y, z);
+						for (size_t lane = blockSize; lane < BatchWidth; lane++)
+						{
+							x[lane] = x[0]; y[lane] = y[0]; z[lane] = z[0];
+						}
+						const BatchRegister bx = BatchLoad(x), by = BatchLoad(y), bz = BatchLoad(z);
+						minX = BatchMin(minX, bx); minY = BatchMin(minY, by); minZ = BatchMin(minZ, bz);
+						maxX = BatchMax(maxX, bx); maxY = BatchMax(maxY, by); maxZ = BatchMax(maxZ, bz);
+					}
+
+					// Reduce the lanes down to a single min and max.
+					alignas(32) float lanes[6][BatchWidth];
+					BatchStore(minX, lanes[0]); BatchStore(minY, lanes[1]); BatchStore(minZ, lanes[2]);
+					BatchStore(maxX, lanes[3]); BatchStore(maxY, lanes[4]); BatchStore(maxZ, lanes[5]);
+					VectorRegister laneMin = VectorSet(lanes[0][0], lanes[1][0], lanes[2][0], 0.0f);
+					VectorRegister laneMax = VectorSet(lanes[3][0], lanes[4][0], lanes[5][0], 0.0f);
+					for (size_t lane = 1; lane < BatchWidth; lane++)
+					{
+						laneMin = VectorMin(laneMin, VectorSet(lanes[0][lane], lanes[1][lane], lanes[2][lane], 0.0f));
+						laneMax = VectorMax(laneMax, VectorSet(lanes[3][lane], lanes[4][lane], lanes[5][lane], 0.0f));
+					}
+					chunkMin[chunk] = Vector3D(laneMin);
+					chunkMax[chunk] = Vector3D(laneMax);
+				}
+			});
+
+			// Merge the chunks.
+			VectorRegister finalMin = chunkMin[0].ToRegister();
+			VectorRegister finalMax = chunkMax[0].ToRegister();
+			for (size_t i = 1; i < chunkCount; i++)
+			{
+				finalMin = VectorMin(finalMin, chunkMin[i].ToRegister());
+				finalMax = VectorMax(finalMax, chunkMax[i].ToRegister());
+			}
+			outMin = Vector3D(finalMin);
+			outMax = Vector3D(finalMax);
+			return true;
+		}
+
+	private:
+
+		/* Matrix with each used element broadcast into its own batch register. */
+		struct BatchMatrix
+		{
+			BatchRegister M[4][3];
+
+			BatchMatrix(const Matrix4x4& matrix, bool includeTranslation)
+			{
+				for (int row = 0; row < 4; row++)
+				{
+					for (int column = 0; column < 3; column++)
+					{
+						M[row][column] = BatchSetAll((row < 3 || includeTranslation) ? matrix.Get(row, column) : 0.0f);
+					}
+				}
+			}
+
+			/* Transform BatchWidth vectors in place, optionally normalizing the result. */
+			void Transform(float* x, float* y, float* z, bool normalize = false) const
+			{
+				const BatchRegister px = BatchLoad(x), py = BatchLoad(y), pz = BatchLoad(z);
+				BatchRegister rx = BatchMultiplyAdd(px, M[0][0], BatchMultiplyAdd(py, M[1][0], BatchMultiplyAdd(pz, M[2][0], M[3][0])));
+				BatchRegister ry = BatchMultiplyAdd(px, M[0][1], BatchMultiplyAdd(py, M[1][1], BatchMultiplyAdd(pz, M[2][1], M[3][1])));
+				BatchRegister rz = BatchMultiplyAdd(px, M[0][2], BatchMultiplyAdd(py, M[1][2], BatchMultiplyAdd(pz, M[2][2], M[3][2])));
+				if (normalize) BatchNormalize3(rx, ry, rz);
+				BatchStore(rx, x);
+				BatchStore(ry, y);
+				BatchStore(rz, z);
+			}
+
+			/* Transform one vector in place for the tail of a contiguous array. */
+			void TransformSingle(float& x, float& y, float& z, bool normalize = false) const
+			{
+				alignas(32) float bx[BatchWidth] = { x }, by[BatchWidth] = { y }, bz[BatchWidth] = { z };
+				Transform(bx, by, bz, normalize);
+				x = bx[0];
+				y = by[0];
+				z = bz[0];
+			}
+		};
+
+		/* Returns the matrix used to transform normals, the cofactor matrix of the upper 3x3. This is the inverse transpose scaled
+		 * by the determinant, normals are renormalized afterwards so it never needs dividing out and tiny scales still rotate.
+		 * NOTE: Only the sign of the determinant is applied so mirrored matrices still flip their normals like the inverse transpose. */
+		static Matrix4x4 GetNormalMatrix(const Matrix4x4& matrix)
+		{
+			const Vector3D row0(matrix.Rows[0]), row1(matrix.Rows[1]), row2(matrix.Rows[2]);
+			Vector3D cofactor0 = row1 ^ row2, cofactor1 = row2 ^ row0, cofactor2 = row0 ^ row1;
+			if ((row0 | cofactor0) < 0.0f)
+			{
+				cofactor0 = cofactor0 * -1.0f;
+				cofactor1 = cofactor1 * -1.0f;
+				cofactor2 = cofactor2 * -1.0f;
+			}
+			return Matrix4x4(cofactor0.ToRegister(), cofactor1.ToRegister(), cofactor2.ToRegister(), VectorSet(0.0f, 0.0f, 0.0f, 1.0f));
+		}
+
+		/* Returns the address of a vector inside a strided array. */
+		static const float* GetStrided(const float* base, size_t stride, size_t index)
+		{
+			return reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(base) + index * stride);
+		}
+		static float* GetStrided(float* base, size_t stride, size_t index)
+		{
+			return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(base) + index * stride);
+		}
+
+		/* Gather up to BatchWidth strided vectors starting at index into SoA arrays. Returns how many were read. */
+		static size_t GatherBlock(const float* source, size_t stride, size_t index, size_t end, float* x, float* y, float* z)
+		{
+			const size_t blockSize = std::min(BatchWidth, end - index);
+			for (size_t lane = 0; lane < blockSize; lane++)
+			{
+				const float* vector = GetStrided(source, stride, index + lane);
+				x[lane] = vector[0];
+				y[lane] = vector[1];
+				z[lane] = vector[2];
+			}
+			return blockSize;
+		}
+
+		/* Transform a range of a strided array block by block. */
+		static void TransformStridedRange(const BatchMatrix& batchMatrix, bool normalize, const float* source, size_t sourceStride, float* destination, size_t destinationStride, size_t begin, size_t end)
+		{
+			alignas(32) float x[BatchWidth] = {}, y[BatchWidth] = {}, z[BatchWidth] = {};
+			for (size_t i = begin; i < end; i += BatchWidth)
+			{
+				const size_t blockSize = GatherBlock(source, sourceStride, i, end, x, y, z);
+				batchMatrix.Transform(x, y, z, normalize);
+				for (size_t lane = 0; lane < blockSize; lane++)
+				{
+					float* vector = GetStrided(destination, destinationStride, i + lane);
+					vector[0] = x[lane];
+					vector[1] = y[lane];
+					vector[2] = z[lane];
+				}
+			}
+		}
+	};
+}
\ No newline at end of file
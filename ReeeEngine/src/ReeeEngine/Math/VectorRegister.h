@@ -0,0 +1,557 @@
+#pragma once
+
+/* Work out which SIMD instruction set the compiler has been told it can use.
+ * NOTE: x64 always has SSE2 so that is the default on windows, ARM uses NEON and anything else falls back to plain floats.
+ *       Define REEE_NO_SIMD to force the plain float path when debugging. */
+#if defined(__AVX2__) && !defined(REEE_NO_SIMD)
+	#define REEE_SIMD_AVX2 1
+#endif
+#if (defined(__AVX__) || defined(__SSE4_1__)) && !defined(REEE_NO_SIMD)
+	#define REEE_SIMD_SSE4 1
+#endif
+#if defined(REEE_SIMD_AVX2) && (defined(_MSC_VER) || defined(__FMA__))
+	#define REEE_SIMD_FMA 1
+#endif
+#if defined(REEE_NO_SIMD)
+	#define REEE_SIMD_SCALAR 1
+#elif defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define REEE_SIMD_SSE 1
+	#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+	#define REEE_SIMD_NEON 1
+	#include <arm_neon.h>
+#else
+	#define REEE_SIMD_SCALAR 1
+#endif
+#include <cmath>
+
+namespace ReeeEngine
+{
+	/* Four float wide SIMD lane used as the storage/working type for the engines math structures. */
+#if defined(REEE_SIMD_SSE)
+	typedef __m128 VectorRegister;
+#elif defined(REEE_SIMD_NEON)
+	typedef float32x4_t VectorRegister;
+#else
+	struct alignas(16) VectorRegister
+	{
+		float V[4];
+	};
+#endif
+
+	//////////////////////////////////////////////////////////////
+	//					  Load/Store Functions					//
+	//////////////////////////////////////////////////////////////
+
+	/* Create a register from four floats. */
+	inline VectorRegister VectorSet(float x, float y, float z, float w)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_setr_ps(x, y, z, w);
+#elif defined(REEE_SIMD_NEON)
+		const float values[4] = { x, y, z, w };
+		return vld1q_f32(values);
+#else
+		return { { x, y, z, w } };
+#endif
+	}
+
+	/* Create a register with the same value in every lane. */
+	inline VectorRegister VectorSetAll(float value)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_set1_ps(value);
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(value);
+#else
+		return { { value, value, value, value } };
+#endif
+	}
+
+	/* Create a register with every lane set to zero. */
+	inline VectorRegister VectorZero()
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_setzero_ps();
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(0.0f);
+#else
+		return { { 0.0f, 0.0f, 0.0f, 0.0f } };
+#endif
+	}
+
+	/* Load four floats from a 16 byte aligned address. */
+	inline VectorRegister VectorLoadAligned(const float* source)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_load_ps(source);
+#elif defined(REEE_SIMD_NEON)
+		return vld1q_f32(source);
+#else
+		return { { source[0], source[1], source[2], source[3] } };
+#endif
+	}
+
+	/* Load four floats from any address. */
+	inline VectorRegister VectorLoad(const float* source)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_loadu_ps(source);
+#elif defined(REEE_SIMD_NEON)
+		return vld1q_f32(source);
+#else
+		return { { source[0], source[1], source[2], source[3] } };
+#endif
+	}
+
+	/* Load two floats into X and Y with Z and W cleared to zero. */
+	inline VectorRegister VectorLoadFloat2(const float* source)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(source)));
+#elif defined(REEE_SIMD_NEON)
+		return vcombine_f32(vld1_f32(source), vdup_n_f32(0.0f));
+#else
+		return { { source[0], source[1], 0.0f, 0.0f } };
+#endif
+	}
+
+	/* Load three floats into X, Y and Z with W cleared to zero. */
+	inline VectorRegister VectorLoadFloat3(const float* source)
+	{
+		return VectorSet(source[0], source[1], source[2], 0.0f);
+	}
+
+	/* Store four floats to a 16 byte aligned address. */
+	inline void VectorStoreAligned(const VectorRegister& vector, float* destination)
+	{
+#if defined(REEE_SIMD_SSE)
+		_mm_store_ps(destination, vector);
+#elif defined(REEE_SIMD_NEON)
+		vst1q_f32(destination, vector);
+#else
+		destination[0] = vector.V[0]; destination[1] = vector.V[1];
+		destination[2] = vector.V[2]; destination[3] = vector.V[3];
+#endif
+	}
+
+	/* Store four floats to any address. */
+	inline void VectorStore(const VectorRegister& vector, float* destination)
+	{
+#if defined(REEE_SIMD_SSE)
+		_mm_storeu_ps(destination, vector);
+#else
+		VectorStoreAligned(vector, destination);
+#endif
+	}
+
+	/* Store the X and Y lanes to any address. */
+	inline void VectorStoreFloat2(const VectorRegister& vector, float* destination)
+	{
+#if defined(REEE_SIMD_SSE)
+		_mm_store_sd(reinterpret_cast<double*>(destination), _mm_castps_pd(vector));
+#elif defined(REEE_SIMD_NEON)
+		vst1_f32(destination, vget_low_f32(vector));
+#else
+		destination[0] = vector.V[0]; destination[1] = vector.V[1];
+#endif
+	}
+
+	/* Store the X, Y and Z lanes to any address. */
+	inline void VectorStoreFloat3(const VectorRegister& vector, float* destination)
+	{
+		alignas(16) float values[4];
+		VectorStoreAligned(vector, values);
+		destination[0] = values[0]; destination[1] = values[1]; destination[2] = values[2];
+	}
+
+	/* Return the X lane of a register. */
+	inline float VectorGetX(const VectorRegister& vector)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_cvtss_f32(vector);
+#elif defined(REEE_SIMD_NEON)
+		return vgetq_lane_f32(vector, 0);
+#else
+		return vector.V[0];
+#endif
+	}
+
+	/* Replicate the X lane into every lane. */
+	inline VectorRegister VectorSplatX(const VectorRegister& vector)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(0, 0, 0, 0));
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(vgetq_lane_f32(vector, 0));
+#else
+		return VectorSetAll(vector.V[0]);
+#endif
+	}
+
+	/* Replicate the Y lane into every lane. */
+	inline VectorRegister VectorSplatY(const VectorRegister& vector)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(1, 1, 1, 1));
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(vgetq_lane_f32(vector, 1));
+#else
+		return VectorSetAll(vector.V[1]);
+#endif
+	}
+
+	/* Replicate the Z lane into every lane. */
+	inline VectorRegister VectorSplatZ(const VectorRegister& vector)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(2, 2, 2, 2));
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(vgetq_lane_f32(vector, 2));
+#else
+		return VectorSetAll(vector.V[2]);
+#endif
+	}
+
+	/* Replicate the W lane into every lane. */
+	inline VectorRegister VectorSplatW(const VectorRegister& vector)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3));
+#elif defined(REEE_SIMD_NEON)
+		return vdupq_n_f32(vgetq_lane_f32(vector, 3));
+#else
+		return VectorSetAll(vector.V[3]);
+#endif
+	}
+
+	/* Return the vector with its W lane replaced by the given value. */
+	inline VectorRegister VectorSetW(const VectorRegister& vector, float w)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_SSE4)
+		return _mm_insert_ps(vector, _mm_set_ss(w), 0x30);
+#elif defined(REEE_SIMD_NEON)
+		return vsetq_lane_f32(w, vector, 3);
+#else
+		alignas(16) float values[4];
+		VectorStoreAligned(vector, values);
+		values[3] = w;
+		return VectorLoadAligned(values);
+#endif
+	}
+
+	//////////////////////////////////////////////////////////////
+	//					  Arithmetic Functions					//
+	//////////////////////////////////////////////////////////////
+
+	/* Per lane A + B. */
+	inline VectorRegister VectorAdd(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_add_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vaddq_f32(A, B);
+#else
+		return { { A.V[0] + B.V[0], A.V[1] + B.V[1], A.V[2] + B.V[2], A.V[3] + B.V[3] } };
+#endif
+	}
+
+	/* Per lane A - B. */
+	inline VectorRegister VectorSubtract(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_sub_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vsubq_f32(A, B);
+#else
+		return { { A.V[0] - B.V[0], A.V[1] - B.V[1], A.V[2] - B.V[2], A.V[3] - B.V[3] } };
+#endif
+	}
+
+	/* Per lane A * B. */
+	inline VectorRegister VectorMultiply(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_mul_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vmulq_f32(A, B);
+#else
+		return { { A.V[0] * B.V[0], A.V[1] * B.V[1], A.V[2] * B.V[2], A.V[3] * B.V[3] } };
+#endif
+	}
+
+	/* Per lane A / B. */
+	inline VectorRegister VectorDivide(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_div_ps(A, B);
+#elif defined(REEE_SIMD_NEON) && defined(__aarch64__)
+		return vdivq_f32(A, B);
+#elif defined(REEE_SIMD_NEON)
+		VectorRegister reciprocal = vrecpeq_f32(B);
+		reciprocal = vmulq_f32(vrecpsq_f32(B, reciprocal), reciprocal);
+		reciprocal = vmulq_f32(vrecpsq_f32(B, reciprocal), reciprocal);
+		return vmulq_f32(A, reciprocal);
+#else
+		return { { A.V[0] / B.V[0], A.V[1] / B.V[1], A.V[2] / B.V[2], A.V[3] / B.V[3] } };
+#endif
+	}
+
+	/* Per lane (A * B) + C. */
+	inline VectorRegister VectorMultiplyAdd(const VectorRegister& A, const VectorRegister& B, const VectorRegister& C)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_FMA)
+		return _mm_fmadd_ps(A, B, C);
+#elif defined(REEE_SIMD_NEON)
+		return vmlaq_f32(C, A, B);
+#else
+		return VectorAdd(VectorMultiply(A, B), C);
+#endif
+	}
+
+	/* Per lane -A. */
+	inline VectorRegister VectorNegate(const VectorRegister& A)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_sub_ps(_mm_setzero_ps(), A);
+#elif defined(REEE_SIMD_NEON)
+		return vnegq_f32(A);
+#else
+		return { { -A.V[0], -A.V[1], -A.V[2], -A.V[3] } };
+#endif
+	}
+
+	/* Per lane absolute value. */
+	inline VectorRegister VectorAbs(const VectorRegister& A)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_andnot_ps(_mm_set1_ps(-0.0f), A);
+#elif defined(REEE_SIMD_NEON)
+		return vabsq_f32(A);
+#else
+		return { { std::abs(A.V[0]), std::abs(A.V[1]), std::abs(A.V[2]), std::abs(A.V[3]) } };
+#endif
+	}
+
+	/* Per lane minimum. */
+	inline VectorRegister VectorMin(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_min_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vminq_f32(A, B);
+#else
+		VectorRegister result;
+		for (int i = 0; i < 4; i++) result.V[i] = A.V[i] < B.V[i] ? A.V[i] : B.V[i];
+		return result;
+#endif
+	}
+
+	/* Per lane maximum. */
+	inline VectorRegister VectorMax(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_max_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vmaxq_f32(A, B);
+#else
+		VectorRegister result;
+		for (int i = 0; i < 4; i++) result.V[i] = A.V[i] > B.V[i] ? A.V[i] : B.V[i];
+		return result;
+#endif
+	}
+
+	/* Per lane round to the nearest whole number. */
+	inline VectorRegister VectorRound(const VectorRegister& A)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_SSE4)
+		return _mm_round_ps(A, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_cvtepi32_ps(_mm_cvtps_epi32(A));
+#elif defined(REEE_SIMD_NEON) && defined(__aarch64__)
+		return vrndnq_f32(A);
+#else
+		alignas(16) float values[4];
+		VectorStoreAligned(A, values);
+		return VectorSet(std::round(values[0]), std::round(values[1]), std::round(values[2]), std::round(values[3]));
+#endif
+	}
+
+	/* Per lane A > B. Returns a mask to be used with VectorSelect. */
+	inline VectorRegister VectorCompareGreater(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_cmpgt_ps(A, B);
+#elif defined(REEE_SIMD_NEON)
+		return vreinterpretq_f32_u32(vcgtq_f32(A, B));
+#else
+		VectorRegister result;
+		for (int i = 0; i < 4; i++) result.V[i] = A.V[i] > B.V[i] ? 1.0f : 0.0f;
+		return result;
+#endif
+	}
+
+	/* Per lane A < B. Returns a mask to be used with VectorSelect. */
+	inline VectorRegister VectorCompareLess(const VectorRegister& A, const VectorRegister& B)
+	{
+		return VectorCompareGreater(B, A);
+	}
+
+	/* Per lane mask ? A : B, where mask comes from one of the compare functions. */
+	inline VectorRegister VectorSelect(const VectorRegister& mask, const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_SSE4)
+		return _mm_blendv_ps(B, A, mask);
+#elif defined(REEE_SIMD_SSE)
+		return _mm_or_ps(_mm_and_ps(mask, A), _mm_andnot_ps(mask, B));
+#elif defined(REEE_SIMD_NEON)
+		return vbslq_f32(vreinterpretq_u32_f32(mask), A, B);
+#else
+		VectorRegister result;
+		for (int i = 0; i < 4; i++) result.V[i] = mask.V[i] != 0.0f ? A.V[i] : B.V[i];
+		return result;
+#endif
+	}
+
+	/* Returns one bit per lane of a compare mask, X in bit 0 through to W in bit 3. */
+	inline unsigned int VectorMoveMask(const VectorRegister& mask)
+	{
+#if defined(REEE_SIMD_SSE)
+		return (unsigned int)_mm_movemask_ps(mask);
+#elif defined(REEE_SIMD_NEON)
+		const uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(mask), 31);
+		return vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1) | (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3);
+#else
+		unsigned int result = 0;
+		for (int i = 0; i < 4; i++) result |= (mask.V[i] != 0.0f ? 1u : 0u) << i;
+		return result;
+#endif
+	}
+
+	/* Per lane square root. */
+	inline VectorRegister VectorSqrt(const VectorRegister& A)
+	{
+#if defined(REEE_SIMD_SSE)
+		return _mm_sqrt_ps(A);
+#elif defined(REEE_SIMD_NEON) && defined(__aarch64__)
+		return vsqrtq_f32(A);
+#else
+		alignas(16) float values[4];
+		VectorStoreAligned(A, values);
+		return VectorSet(std::sqrt(values[0]), std::sqrt(values[1]), std::sqrt(values[2]), std::sqrt(values[3]));
+#endif
+	}
+
+	/* Per lane 1 / sqrt(A). Uses the hardware estimate followed by one Newton-Raphson step (~22 bits of precision). */
+	inline VectorRegister VectorReciprocalSqrt(const VectorRegister& A)
+	{
+#if defined(REEE_SIMD_SSE)
+		const __m128 estimate = _mm_rsqrt_ps(A);
+		const __m128 halfA = _mm_mul_ps(A, _mm_set1_ps(0.5f));
+		const __m128 estimateSquared = _mm_mul_ps(estimate, estimate);
+		return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(halfA, estimateSquared)));
+#elif defined(REEE_SIMD_NEON)
+		float32x4_t estimate = vrsqrteq_f32(A);
+		estimate = vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(A, estimate), estimate));
+		return vmulq_f32(estimate, vrsqrtsq_f32(vmulq_f32(A, estimate), estimate));
+#else
+		return { { 1.0f / std::sqrt(A.V[0]), 1.0f / std::sqrt(A.V[1]), 1.0f / std::sqrt(A.V[2]), 1.0f / std::sqrt(A.V[3]) } };
+#endif
+	}
+
+	//////////////////////////////////////////////////////////////
+	//					  Geometric Functions					//
+	//////////////////////////////////////////////////////////////
+
+	/* Dot product of the X and Y lanes replicated into every lane. */
+	inline VectorRegister VectorDot2(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_SSE4)
+		return _mm_dp_ps(A, B, 0x3F);
+#elif defined(REEE_SIMD_SSE)
+		const __m128 product = _mm_mul_ps(A, B);
+		const __m128 sum = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+		return _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(0, 0, 0, 0));
+#elif defined(REEE_SIMD_NEON)
+		const float32x2_t product = vmul_f32(vget_low_f32(A), vget_low_f32(B));
+		return vdupq_lane_f32(vpadd_f32(product, product), 0);
+#else
+		return VectorSetAll(A.V[0] * B.V[0] + A.V[1] * B.V[1]);
+#endif
+	}
+
+	/* Dot product of the X, Y and Z lanes replicated into every lane. W is ignored. */
+	inline VectorRegister VectorDot3(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_SSE4)
+		return _mm_dp_ps(A, B, 0x7F);
+#elif defined(REEE_SIMD_SSE)
+		const __m128 product = _mm_mul_ps(A, B);
+		__m128 sum = _mm_add_ss(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 1, 1, 1)));
+		sum = _mm_add_ss(sum, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 2, 2, 2)));
+		return _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(0, 0, 0, 0));
+#elif defined(REEE_SIMD_NEON)
+		const float32x4_t product = vsetq_lane_f32(0.0f, vmulq_f32(A, B), 3);
+		const float32x2_t pairs = vadd_f32(vget_low_f32(product), vget_high_f32(product));
+		return vdupq_lane_f32(vpadd_f32(pairs, pairs), 0);
+#else
+		return VectorSetAll(A.V[0] * B.V[0] + A.V[1] * B.V[1] + A.V[2] * B.V[2]);
+#endif
+	}
+
+	/* Dot product of all four lanes replicated into every lane. */
+	inline VectorRegister VectorDot4(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE) && defined(REEE_SIMD_SSE4)
+		return _mm_dp_ps(A, B, 0xFF);
+#elif defined(REEE_SIMD_SSE)
+		const __m128 product = _mm_mul_ps(A, B);
+		const __m128 swapped = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_add_ps(swapped, _mm_shuffle_ps(swapped, swapped, _MM_SHUFFLE(1, 0, 3, 2)));
+#elif defined(REEE_SIMD_NEON)
+		const float32x4_t product = vmulq_f32(A, B);
+		const float32x2_t pairs = vadd_f32(vget_low_f32(product), vget_high_f32(product));
+		return vdupq_lane_f32(vpadd_f32(pairs, pairs), 0);
+#else
+		return VectorSetAll(A.V[0] * B.V[0] + A.V[1] * B.V[1] + A.V[2] * B.V[2] + A.V[3] * B.V[3]);
+#endif
+	}
+
+	/* Cross product of the X, Y and Z lanes. W of the result is zero. */
+	inline VectorRegister VectorCross3(const VectorRegister& A, const VectorRegister& B)
+	{
+#if defined(REEE_SIMD_SSE)
+		const __m128 aYZX = _mm_shuffle_ps(A, A, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 bYZX = _mm_shuffle_ps(B, B, _MM_SHUFFLE(3, 0, 2, 1));
+		const __m128 result = _mm_sub_ps(_mm_mul_ps(A, bYZX), _mm_mul_ps(aYZX, B));
+		return _mm_and_ps(_mm_shuffle_ps(result, result, _MM_SHUFFLE(3, 0, 2, 1)), _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+#else
+		alignas(16) float a[4];
+		alignas(16) float b[4];
+		VectorStoreAligned(A, a);
+		VectorStoreAligned(B, b);
+		return VectorSet(a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0], 0.0f);
+#endif
+	}
+
+	/* Transpose four registers in place so rows become columns. */
+	inline void VectorTranspose(VectorRegister& row0, VectorRegister& row1, VectorRegister& row2, VectorRegister& row3)
+	{
+#if defined(REEE_SIMD_SSE)
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+#elif defined(REEE_SIMD_NEON)
+		const float32x4x2_t row01 = vtrnq_f32(row0, row1);
+		const float32x4x2_t row23 = vtrnq_f32(row2, row3);
+		row0 = vcombine_f32(vget_low_f32(row01.val[0]), vget_low_f32(row23.val[0]));
+		row1 = vcombine_f32(vget_low_f32(row01.val[1]), vget_low_f32(row23.val[1]));
+		row2 = vcombine_f32(vget_high_f32(row01.val[0]), vget_high_f32(row23.val[0]));
+		row3 = vcombine_f32(vget_high_f32(row01.val[1]), vget_high_f32(row23.val[1]));
+#else
+		const VectorRegister a = row0, b = row1, c = row2, d = row3;
+		row0 = { { a.V[0], b.V[0], c.V[0], d.V[0] } };
+		row1 = { { a.V[1], b.V[1], c.V[1], d.V[1] } };
+		row2 = { { a.V[2], b.V[2], c.V[2], d.V[2] } };
+		row3 = { { a.V[3], b.V[3], c.V[3], d.V[3] } };
+#endif
+	}
+}
\ No newline at end of file
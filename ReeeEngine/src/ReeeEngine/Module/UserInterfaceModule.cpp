@@ -1,6 +1,7 @@
 #include "UserInterfaceModule.h"
 #include "../Application.h"
 #include "../ReeeLog.h"
+#include "../World/World.h"
 #include "../../imgui/imgui_impl_win32.h"
 #include "../../imgui/imgui_impl_dx11.h"
 
@@ -86,6 +87,18 @@ namespace ReeeEngine
 		//{
 		//	ImGui::ShowDemoWindow(&show_demo_window);
 		//}
+
+		// Show what the worlds last tick got through, e.g. to tune the amortized tick budget.
+		World* world = Application::GetWorld();
+		if (world)
+		{
+			const TickStats& ticks = world->GetTickStats();
+			ImGui::Begin("Tick Stats");
+			ImGui::Text("Ticked: %u  Skipped: %u", ticks.ticked, ticks.skipped);
+			ImGui::Text("Amortized: %u  Deferred: %u", ticks.amortized, ticks.deferred);
+			ImGui::Text("Amortized time: %.1f / %.1f us", ticks.amortizedMicroseconds, world->GetAmortizedTickBudget());
+			ImGui::End();
+		}
 	}
 
 	void UserInterfaceModule::EndFrame()
@@ -68,6 +68,7 @@ namespace ReeeEngine
 		using ConstantBuffer<C>::constantBuffer;
 		using ConstantBuffer<C>::slot;
 		using ContextData::GetContext;
+		using ContextData::ShouldBind;
 
 	public:
 
@@ -75,7 +76,7 @@ namespace ReeeEngine
 		using ConstantBuffer<C>::ConstantBuffer;
 		virtual void Add(Graphics& graphics) noexcept override
 		{
-			GetContext(graphics)->VSSetConstantBuffers(slot, 1u, constantBuffer.GetAddressOf());
+			if (ShouldBind(graphics, PipelineBindType::VertexConstantBuffer, slot, constantBuffer.Get())) GetContext(graphics)->VSSetConstantBuffers(slot, 1u, constantBuffer.GetAddressOf());
 		}
 	};
 
@@ -86,6 +87,7 @@ namespace ReeeEngine
 		using ConstantBuffer<C>::constantBuffer;
 		using ConstantBuffer<C>::slot;
 		using ContextData::GetContext;
+		using ContextData::ShouldBind;
 
 	public:
 
@@ -93,7 +95,7 @@ namespace ReeeEngine
 		using ConstantBuffer<C>::ConstantBuffer;
 		virtual void Add(Graphics& graphics) noexcept override
 		{
-			GetContext(graphics)->PSSetConstantBuffers(slot, 1u, constantBuffer.GetAddressOf());
+			if (ShouldBind(graphics, PipelineBindType::PixelConstantBuffer, slot, constantBuffer.Get())) GetContext(graphics)->PSSetConstantBuffers(slot, 1u, constantBuffer.GetAddressOf());
 		}
 	};
 }
\ No newline at end of file
@@ -11,4 +11,9 @@ namespace ReeeEngine
 	{
 		return graphics.device.Get();
 	}
+
+	bool ContextData::ShouldBind(Graphics& graphics, PipelineBindType type, UINT slot, const void* object, uint64_t extra) noexcept
+	{
+		return graphics.stateCache.Bind(type, slot, object, extra);
+	}
 }
\ No newline at end of file
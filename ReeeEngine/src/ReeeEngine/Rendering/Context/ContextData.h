@@ -17,5 +17,8 @@ namespace ReeeEngine
 		/* Getters and setters for returning components of graphics to its children. */
 		static ID3D11DeviceContext* GetContext(Graphics& graphics) noexcept;
 		static ID3D11Device* GetDevice(Graphics& graphics) noexcept;
+
+		/* Returns if an object should be bound to a slot of the pipeline, false if it is already bound there so the bind can be skipped. */
+		static bool ShouldBind(Graphics& graphics, PipelineBindType type, UINT slot, const void* object, uint64_t extra = 0) noexcept;
 	};
 }
\ No newline at end of file
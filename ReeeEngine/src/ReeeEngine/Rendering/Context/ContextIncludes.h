@@ -2,6 +2,7 @@
 
 #include "ConstantBuffer.h"
 #include "IndexData.h"
+#include "InstanceData.h"
 #include "InputLayout.h"
 #include "PixelShader.h"
 #include "VertexShader.h"
@@ -24,7 +24,7 @@ namespace ReeeEngine
 
 	void IndexData::Add(Graphics& graphics) noexcept
 	{
-		GetContext(graphics)->IASetIndexBuffer(indexData.Get(), DXGI_FORMAT_R16_UINT, 0u);
+		if (ShouldBind(graphics, PipelineBindType::IndexBuffer, 0u, indexData.Get())) GetContext(graphics)->IASetIndexBuffer(indexData.Get(), DXGI_FORMAT_R16_UINT, 0u);
 	}
 
 	UINT IndexData::GetNum() const noexcept
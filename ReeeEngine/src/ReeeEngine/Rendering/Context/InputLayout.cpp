@@ -12,6 +12,6 @@ namespace ReeeEngine
 
 	void InputLayout::Add(Graphics& graphics) noexcept
 	{
-		GetContext(graphics)->IASetInputLayout(inputLayout.Get());
+		if (ShouldBind(graphics, PipelineBindType::InputLayout, 0u, inputLayout.Get())) GetContext(graphics)->IASetInputLayout(inputLayout.Get());
 	}
 }
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "InstanceData.h"
+#include <cassert>
+
+namespace ReeeEngine
+{
+	InstanceData::InstanceData(Graphics& graphics, UINT maxInstances) : maxInstances(maxInstances)
+	{
+		// Create a buffer the CPU rewrites every instanced draw.
+		D3D11_BUFFER_DESC newBuffer = {};
+		newBuffer.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		newBuffer.Usage = D3D11_USAGE_DYNAMIC;
+		newBuffer.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		newBuffer.MiscFlags = 0u;
+		newBuffer.ByteWidth = UINT(sizeof(InstanceTransform) * maxInstances);
+		newBuffer.StructureByteStride = sizeof(InstanceTransform);
+		HRESULT result = GetDevice(graphics)->CreateBuffer(&newBuffer, nullptr, &instanceBuffer);
+		LOG_DX_ERROR(result);
+	}
+
+	void InstanceData::Update(Graphics& graphics, const InstanceTransform* instances, UINT count) noexcept
+	{
+		// Discard the last draws instances and copy in the new ones.
+		assert("More instances than the instance buffer can hold" && count <= maxInstances);
+		D3D11_MAPPED_SUBRESOURCE msr;
+		HRESULT result = GetContext(graphics)->Map(instanceBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &msr);
+		LOG_DX_ERROR(result);
+		memcpy(msr.pData, instances, sizeof(InstanceTransform) * count);
+		GetContext(graphics)->Unmap(instanceBuffer.Get(), 0u);
+	}
+
+	void InstanceData::Add(Graphics& graphics) noexcept
+	{
+		const UINT stride = sizeof(InstanceTransform);
+		const UINT offset = 0u;
+		if (ShouldBind(graphics, PipelineBindType::VertexBuffer, 1u, instanceBuffer.Get(), stride)) GetContext(graphics)->IASetVertexBuffers(1u, 1u, instanceBuffer.GetAddressOf(), &stride, &offset);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include "ContextData.h"
+#include "../Renderables/InstanceBatcher.h"
+
+namespace ReeeEngine
+{
+	/* Per instance vertex buffer of instance transforms, refilled for each instanced draw and bound next to a meshes vertices. */
+	class InstanceData : public ContextData
+	{
+	public:
+
+		/* Create a dynamic vertex buffer big enough for the most instances an instanced draw can have. */
+		InstanceData(Graphics& graphics, UINT maxInstances = InstanceBatcher::MaxInstances);
+
+		/* Copy the transforms of the next instanced draw into the buffer. */
+		void Update(Graphics& graphics, const InstanceTransform* instances, UINT count) noexcept;
+
+		/* Add the buffer to the second vertex buffer slot of the context. */
+		virtual void Add(Graphics& graphics) noexcept override;
+
+	protected:
+
+		UINT maxInstances;// Number of instances the buffer can hold.
+		Microsoft::WRL::ComPtr<ID3D11Buffer> instanceBuffer;// Pointer to the instance buffer.
+	};
+}
\ No newline at end of file
@@ -17,6 +17,6 @@ namespace ReeeEngine
 	void PixelShader::Add(Graphics& graphics) noexcept
 	{
 		// Set contexts current pixel shader.
-		GetContext(graphics)->PSSetShader(pixelShader.Get(), nullptr, 0u);
+		if (ShouldBind(graphics, PipelineBindType::PixelShader, 0u, pixelShader.Get())) GetContext(graphics)->PSSetShader(pixelShader.Get(), nullptr, 0u);
 	}
 }
\ No newline at end of file
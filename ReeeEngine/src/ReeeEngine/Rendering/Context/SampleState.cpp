@@ -19,6 +19,6 @@ namespace ReeeEngine
 	void SampleState::Add(Graphics& graphics) noexcept
 	{
 		// Add sampler to rendering pipeline.
-		GetContext(graphics)->PSSetSamplers(0, 1, sampler.GetAddressOf());
+		if (ShouldBind(graphics, PipelineBindType::PixelSampler, 0u, sampler.Get())) GetContext(graphics)->PSSetSamplers(0, 1, sampler.GetAddressOf());
 	}
 }
\ No newline at end of file
@@ -44,6 +44,6 @@ namespace ReeeEngine
 	void Texture::Add(Graphics& graphics) noexcept
 	{
 		// Add the texture to the graphics pipeline.
-		GetContext(graphics)->PSSetShaderResources(0u, 1u, texture.GetAddressOf());
+		if (ShouldBind(graphics, PipelineBindType::PixelShaderResource, 0u, texture.Get())) GetContext(graphics)->PSSetShaderResources(0u, 1u, texture.GetAddressOf());
 	}
 }
\ No newline at end of file
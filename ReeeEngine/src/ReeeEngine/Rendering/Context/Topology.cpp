@@ -9,6 +9,6 @@ namespace ReeeEngine
 
 	void Topology::Add(Graphics& graphics) noexcept
 	{
-		GetContext(graphics)->IASetPrimitiveTopology(type);
+		if (ShouldBind(graphics, PipelineBindType::Topology, 0u, nullptr, (uint64_t)type)) GetContext(graphics)->IASetPrimitiveTopology(type);
 	}
 }
\ No newline at end of file
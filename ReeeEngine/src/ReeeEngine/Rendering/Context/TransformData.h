@@ -1,17 +1,20 @@
 #pragma once
 #include "ConstantBuffer.h"
 #include "../Renderables/RenderableMesh.h"
-#include <DirectXMath.h>
+#include "../../Math/Matrix4x4.h"
 
 namespace ReeeEngine
 {
 	/* Model transform constant value for shaders. */
 	struct MeshTransform
 	{
-		DirectX::XMMATRIX modelView;
-		DirectX::XMMATRIX modelViewProj;
+		Matrix4x4 modelView;
+		Matrix4x4 modelViewProj;
 	};
 
+	/* Must match the two float4x4's in the vertex shaders transform cbuffer. */
+	static_assert(sizeof(MeshTransform) == 128, "MeshTransform no longer matches the shader constant buffer layout.");
+
 	/* Transform data for any context data being passed into the rendering pipeline. */
 	class TransformData : public ContextData
 	{
@@ -5,6 +5,6 @@ namespace ReeeEngine
 	void VertextData::Add(Graphics& graphics) noexcept
 	{
 		const UINT offset = 0u;
-		GetContext(graphics)->IASetVertexBuffers(0u, 1u, vertexBuffer.GetAddressOf(), &stride, &offset);
+		if (ShouldBind(graphics, PipelineBindType::VertexBuffer, 0u, vertexBuffer.Get(), stride)) GetContext(graphics)->IASetVertexBuffers(0u, 1u, vertexBuffer.GetAddressOf(), &stride, &offset);
 	}
 }
@@ -14,7 +14,7 @@ namespace ReeeEngine
 	void VertexShader::Add(Graphics& graphics) noexcept
 	{
 		// Set contexts current vertex shader.
-		GetContext(graphics)->VSSetShader(vertexShader.Get(), nullptr, 0u);
+		if (ShouldBind(graphics, PipelineBindType::VertexShader, 0u, vertexShader.Get())) GetContext(graphics)->VSSetShader(vertexShader.Get(), nullptr, 0u);
 	}
 
 	ID3DBlob* VertexShader::GetBytecode() const noexcept
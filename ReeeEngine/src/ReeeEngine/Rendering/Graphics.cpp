@@ -189,6 +189,9 @@ namespace ReeeEngine
 		// Catch any errors when presenting the swap chain.
 		HRESULT result = swapChain->Present(1u, 0u);
 		LOG_DX_ERROR(result);
+
+		// Keep the bind counters of this frame and forget what is bound, the user interface binds its own state at the end of each frame.
+		stateCache.EndFrame();
 	}
 
 	void Graphics::ClearRenderBuffer(float r, float g, float b) noexcept
@@ -203,6 +206,11 @@ namespace ReeeEngine
 	{
 		context->DrawIndexed(numberOfIndex, 0u, 0u);
 	}
+
+	void Graphics::DrawInstanced(UINT numberOfIndex, UINT numberOfInstances)
+	{
+		context->DrawIndexedInstanced(numberOfIndex, numberOfInstances, 0u, 0, 0u);
+	}
 }
 
 
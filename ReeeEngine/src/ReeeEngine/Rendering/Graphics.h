@@ -4,8 +4,10 @@
 #include "../Math/ReeeMath.h"
 #include "../Math/Vector2D.h"
 #include "DXErrors/dxerr.h"
+#include "PipelineStateCache.h"
 #include <d3d11.h>
 #include <d3dcompiler.h>
+#include <DirectXMath.h>
 #include <vector>
 #include <wrl.h>
 #include <memory>
@@ -72,12 +74,22 @@ namespace ReeeEngine
 		/* Draw any context data binded to the rendering pipeline. */
 		void Draw(UINT numberOfIndex);
 
+		/* Draw the binded context data once per instance in the binded instance buffer. */
+		void DrawInstanced(UINT numberOfIndex, UINT numberOfInstances);
+
 		/* Device getter. */
 		ID3D11Device* GetDevice() { return device.Get(); }
 
-		/* Context getter. */
+		/* Context getter.
+		 * NOTE: Anything binding through the context directly outside of a frames end should call InvalidatePipelineState after. */
 		ID3D11DeviceContext* GetContext() { return context.Get(); }
 
+		/* Forget the pipeline state the context data last bound so each is bound again on its next use. */
+		void InvalidatePipelineState() noexcept { stateCache.Invalidate(); }
+
+		/* Returns the counters of the binds issued to the context and the redundant ones skipped in the last presented frame. */
+		const PipelineBindStats& GetBindStats() const { return stateCache.GetStats(); }
+
 	private:
 
 		/* Save viewport size. */
@@ -90,5 +102,8 @@ namespace ReeeEngine
 		Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
 		Microsoft::WRL::ComPtr<ID3D11RenderTargetView> renderTarget;
 		Microsoft::WRL::ComPtr<ID3D11DepthStencilView> depthStencil;
+
+		/* What the context data has bound to the pipeline, so binding the same thing again is skipped. */
+		PipelineStateCache stateCache;
 	};
 }
\ No newline at end of file
@@ -18,17 +18,17 @@ namespace ReeeEngine
 
 	void PointLight::SetPosition(const Vector3D& newPosition) noexcept
 	{
-		pointLightSetting.pos = newPosition.ToFloat3();
+		pointLightSetting.pos = { newPosition.X, newPosition.Y, newPosition.Z };
 	}
 
 	void PointLight::SetAmbientColor(const Vector3D& newColor) noexcept
 	{
-		pointLightSetting.ambientColor = newColor.ToFloat3();
+		pointLightSetting.ambientColor = { newColor.X, newColor.Y, newColor.Z };
 	}
 
 	void PointLight::SetDiffuseColor(const Vector3D& newColor) noexcept
 	{
-		pointLightSetting.diffuseColor = newColor.ToFloat3();
+		pointLightSetting.diffuseColor = { newColor.X, newColor.Y, newColor.Z };
 	}
 
 	void PointLight::SetIntensity(const float newIntensity) noexcept
@@ -43,11 +43,11 @@ namespace ReeeEngine
 		pointLightSetting.attQuad = newAttQuad;
 	}
 
-	void PointLight::Add(Graphics& graphics, const DirectX::XMMATRIX& matrix) const noexcept
+	void PointLight::Add(Graphics& graphics, const Matrix4x4& matrix) const noexcept
 	{
 		auto settings = pointLightSetting;
-		const auto posVector = DirectX::XMLoadFloat3(&pointLightSetting.pos);
-		DirectX::XMStoreFloat3(&settings.pos, DirectX::XMVector3Transform(posVector, matrix));
+		const Vector3D viewPosition = matrix.TransformPosition(Vector3D(pointLightSetting.pos.x, pointLightSetting.pos.y, pointLightSetting.pos.z));
+		settings.pos = { viewPosition.X, viewPosition.Y, viewPosition.Z };
 		constantBuffer.Update(graphics, settings);
 		constantBuffer.Add(graphics);
 	}
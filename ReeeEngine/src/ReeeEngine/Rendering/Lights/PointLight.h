@@ -2,6 +2,7 @@
 #include "../../Globals.h"
 #include "../Context/ConstantBuffer.h"
 #include "../../Math/Vector3D.h"
+#include "../../Math/Matrix4x4.h"
 
 namespace ReeeEngine
 {
@@ -21,7 +22,7 @@ namespace ReeeEngine
 		void SetAttenuation(const float newAttConst, const float newAttLin, const float newAttQuad) noexcept;
 
 		/* Add light data to the rendering pipeline using the constant buffer. */
-		void Add(Graphics& graphics, const DirectX::XMMATRIX& matrix) const noexcept;
+		void Add(Graphics& graphics, const Matrix4x4& matrix) const noexcept;
 
 	private:
 
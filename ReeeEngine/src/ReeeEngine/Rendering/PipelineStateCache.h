@@ -0,0 +1,128 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace ReeeEngine
+{
+	/* Kinds of pipeline state the state cache tracks, each with its own slots. */
+	enum class PipelineBindType : uint8_t
+	{
+		VertexShader,
+		PixelShader,
+		InputLayout,
+		Topology,
+		VertexBuffer,
+		IndexBuffer,
+		VertexConstantBuffer,
+		PixelConstantBuffer,
+		PixelShaderResource,
+		PixelSampler,
+		Count
+	};
+
+	/* Counters of the pipeline binds asked for in a frame. */
+	struct PipelineBindStats
+	{
+		// Binds that changed the pipeline so were sent to the device.
+		uint32_t issued = 0;
+
+		// Binds of what was already bound that were dropped.
+		uint32_t skipped = 0;
+	};
+
+	/* Keeps what is bound to each slot of the pipeline so binding the same shader, layout, buffer, texture or sampler again can be
+	 * dropped before it reaches the device context.
+	 * NOTE: Objects are compared by address so the cache has to be invalidated whenever something else may have changed the pipeline,
+	 * e.g. the user interface drawing at the end of the frame, and before an address could be reused by a new object. */
+	class PipelineStateCache
+	{
+	public:
+
+		// Slots tracked for each kind of state, binds to higher slots are always issued.
+		static constexpr uint32_t MaxSlots = 16;
+
+		/* Returns if an object should be bound to a slot, false if the slot already holds it with the same extra settings
+		 * (e.g. a vertex buffers stride or the topology type when there is no object). */
+		bool Bind(PipelineBindType type, uint32_t slot, const void* object, uint64_t extra = 0)
+		{
+			if (slot >= MaxSlots)
+			{
+				frame.issued++;
+				return true;
+			}
+			BoundState& state = bound[(size_t)type][slot];
+			if (state.valid && state.object == object && state.extra == extra)
+			{
+				frame.skipped++;
+				return false;
+			}
+			state.object = object;
+			state.extra = extra;
+			state.valid = true;
+			frame.issued++;
+			return true;
+		}
+
+		/* Forget everything bound so the next bind of each slot is issued. */
+		void Invalidate()
+		{
+			for (auto& slots : bound)
+			{
+				for (BoundState& state : slots) state.valid = false;
+			}
+		}
+
+		/* Keep the counters of the frame that ended and start counting the next, invalidating the cache as the frame may end with
+		 * binds made around it. */
+		void EndFrame()
+		{
+			lastFrame = frame;
+			frame = PipelineBindStats();
+			Invalidate();
+		}
+
+		/* Returns the counters of the last ended frame and of the frame so far. */
+		const PipelineBindStats& GetStats() const { return lastFrame; }
+		const PipelineBindStats& GetFrameStats() const { return frame; }
+
+	private:
+
+		/* What is bound to a slot and if it is known. */
+		struct BoundState
+		{
+			const void* object = nullptr;
+			uint64_t extra = 0;
+			bool valid = false;
+		};
+
+		// What is bound to every tracked slot of each kind of state.
+		BoundState bound[(size_t)PipelineBindType::Count][MaxSlots];
+
+		// Counters of the frame so far and the last ended frame.
+		PipelineBindStats frame;
+		PipelineBindStats lastFrame;
+	};
+
+	/* Pipeline device keeping the binds that get through a state cache, to check the cache without a graphics device. */
+	struct RecordingPipelineDevice
+	{
+		/* A bind that reached the device. */
+		struct Call
+		{
+			PipelineBindType type;
+			uint32_t slot;
+			const void* object;
+			uint64_t extra;
+		};
+
+		// State cache binds go through and the binds that got through in order.
+		PipelineStateCache cache;
+		std::vector<Call> calls;
+
+		void Bind(PipelineBindType type, uint32_t slot, const void* object, uint64_t extra = 0)
+		{
+			if (cache.Bind(type, slot, object, extra)) calls.push_back({ type, slot, object, extra });
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+namespace ReeeEngine
+{
+	// Define classes used.
+	class RenderableMesh;
+
+	/* Passes the render queue draws in order, opaque draws first. */
+	enum class RenderPass : uint8_t
+	{
+		Opaque = 0,
+		Transparent = 1
+	};
+
+	/* A draw gathered for the render queue, the sort key and the renderable to draw. */
+	struct DrawPacket
+	{
+		// Pass, shader, texture, mesh and depth of the draw packed so sorting the key sorts the draws, see RenderQueue::MakeKey.
+		uint64_t key;
+
+		// Renderable to draw.
+		const RenderableMesh* renderable;
+	};
+
+	/* Counters of the last executed render queue. */
+	struct RenderQueueStats
+	{
+		// Draws executed.
+		uint32_t draws = 0;
+
+		// Draws using a different shader, texture or mesh to the draw before them.
+		uint32_t shaderChanges = 0;
+		uint32_t textureChanges = 0;
+		uint32_t meshChanges = 0;
+	};
+
+	/* Draws gathered over a frame and sorted by their keys before they are executed, so draws sharing a shader, texture and mesh
+	 * are drawn one after the other and opaque draws go front to back.
+	 * NOTE: Has no graphics device of its own, execute is given a backend that does the drawing so the order can be recorded without one. */
+	class RenderQueue
+	{
+	public:
+
+		// Bits of the sort key given to each part of a draw, highest first. Shaders, textures and meshes with ids past their bits share a value.
+		static constexpr uint32_t PassBits = 8;
+		static constexpr uint32_t ShaderBits = 8;
+		static constexpr uint32_t TextureBits = 16;
+		static constexpr uint32_t MeshBits = 16;
+		static constexpr uint32_t DepthBits = 16;
+
+		/* Pack a draw into a sort key. Opaque keys are pass, shader, texture, mesh then depth so state is grouped and each group is drawn
+		 * front to back, transparent keys are pass then depth far to near so they blend in the right order. */
+		static uint64_t MakeKey(RenderPass pass, uint32_t shader, uint32_t texture, uint32_t mesh, float depth)
+		{
+			const uint64_t state = ((uint64_t)(shader & Mask(ShaderBits)) << (TextureBits + MeshBits)) |
+				((uint64_t)(texture & Mask(TextureBits)) << MeshBits) | (uint64_t)(mesh & Mask(MeshBits));
+			uint64_t key = (uint64_t)pass << (64 - PassBits);
+			if (pass == RenderPass::Opaque) key |= (state << DepthBits) | QuantizeDepth(depth);
+			else key |= ((uint64_t)(Mask(DepthBits) - QuantizeDepth(depth)) << (ShaderBits + TextureBits + MeshBits)) | state;
+			return key;
+		}
+
+		/* Read the shader, texture and mesh back out of a sort key. */
+		static uint32_t GetShader(uint64_t key) { return (uint32_t)(GetState(key) >> (TextureBits + MeshBits)) & Mask(ShaderBits); }
+		static uint32_t GetTexture(uint64_t key) { return (uint32_t)(GetState(key) >> MeshBits) & Mask(TextureBits); }
+		static uint32_t GetMesh(uint64_t key) { return (uint32_t)GetState(key) & Mask(MeshBits); }
+		static RenderPass GetPass(uint64_t key) { return (RenderPass)(key >> (64 - PassBits)); }
+
+		/* Returns if two keys are in the same pass with the same shader, texture and mesh, no matter their depth. */
+		static bool IsSameState(uint64_t a, uint64_t b) { return GetPass(a) == GetPass(b) && GetState(a) == GetState(b); }
+
+		/* Remove every draw ready to gather the next frame. */
+		void Clear()
+		{
+			packets.clear();
+		}
+
+		/* Add a draw to the queue. */
+		void Submit(uint64_t key, const RenderableMesh* renderable)
+		{
+			packets.push_back({ key, renderable });
+		}
+
+		/* Sort the draws by their keys with a stable radix sort a byte at a time, skipping the bytes every key shares. */
+		void Sort()
+		{
+			const size_t count = packets.size();
+			if (count < 2) return;
+			sortBuffer.resize(count);
+			DrawPacket* source = packets.data();
+			DrawPacket* destination = sortBuffer.data();
+
+			// Count each value of every byte in one read of the keys, moving draws does not change the counts.
+			byteCounts.assign(8 * 256, 0);
+			for (size_t i = 0; i < count; i++)
+			{
+				const uint64_t key = source[i].key;
+				for (uint32_t byte = 0; byte < 8; byte++) byteCounts[byte * 256 + ((key >> (byte * 8)) & 0xFF)]++;
+			}
+			for (uint32_t byte = 0; byte < 8; byte++)
+			{
+				// Skip the byte if every key has the same value for it.
+				const uint32_t shift = byte * 8;
+				uint32_t* offsets = &byteCounts[byte * 256];
+				if (offsets[(source[0].key >> shift) & 0xFF] == count) continue;
+
+				// Turn the counts into where each value starts then move the draws across in order.
+				uint32_t start = 0;
+				for (uint32_t value = 0; value < 256; value++)
+				{
+					const uint32_t valueCount = offsets[value];
+					offsets[value] = start;
+					start += valueCount;
+				}
+				for (size_t i = 0; i < count; i++) destination[offsets[(source[i].key >> shift) & 0xFF]++] = source[i];
+				std::swap(source, destination);
+			}
+			if (source != packets.data()) std::memcpy(packets.data(), source, count * sizeof(DrawPacket));
+		}
+
+		/* Give every draw to the backend in the queues order and count the state changes between them. The backend is anything
+		 * callable with a const DrawPacket&, e.g. one rendering the renderable or one recording the order for checking. */
+		template<class Backend>
+		void Execute(Backend&& backend)
+		{
+			CountStateChanges();
+			for (const DrawPacket& packet : packets) backend(packet);
+		}
+
+		/* Count the draws and the state changes between them in their current order into the stats.
+		 * NOTE: Done by Execute, only needed when the draws are drawn some other way e.g. batched into instanced draws. */
+		void CountStateChanges()
+		{
+			stats = RenderQueueStats();
+			uint64_t lastState = 0;
+			for (size_t i = 0; i < packets.size(); i++)
+			{
+				const uint64_t state = GetState(packets[i].key);
+				const uint64_t changed = i == 0 ? ~0ull : state ^ lastState;
+				stats.shaderChanges += (changed >> (TextureBits + MeshBits)) & Mask(ShaderBits) ? 1 : 0;
+				stats.textureChanges += (changed >> MeshBits) & Mask(TextureBits) ? 1 : 0;
+				stats.meshChanges += changed & Mask(MeshBits) ? 1 : 0;
+				lastState = state;
+			}
+			stats.draws = (uint32_t)packets.size();
+		}
+
+		/* Returns the draws gathered, in sorted order after Sort. */
+		const std::vector<DrawPacket>& GetPackets() const { return packets; }
+		size_t Size() const { return packets.size(); }
+
+		/* Returns the counters of the last Execute or CountStateChanges. */
+		const RenderQueueStats& GetStats() const { return stats; }
+
+	private:
+
+		/* Returns a mask of the lowest bits. */
+		static constexpr uint32_t Mask(uint32_t bits) { return (uint32_t)((1ull << bits) - 1); }
+
+		/* Turn a depth into the top bits of its float, which keep the order of positive floats. Depths behind the camera are 0. */
+		static uint64_t QuantizeDepth(float depth)
+		{
+			if (!(depth > 0.0f)) return 0;
+			uint32_t bits;
+			std::memcpy(&bits, &depth, sizeof(bits));
+			return bits >> (32 - DepthBits);
+		}
+
+		/* Returns the shader, texture and mesh of a key wherever the pass put them. */
+		static uint64_t GetState(uint64_t key)
+		{
+			const uint64_t stateMask = (1ull << (ShaderBits + TextureBits + MeshBits)) - 1;
+			return GetPass(key) == RenderPass::Opaque ? (key >> DepthBits) & stateMask : key & stateMask;
+		}
+
+	private:
+
+		// Draws gathered this frame, the buffer they are sorted through and the count of each value of each key byte.
+		std::vector<DrawPacket> packets;
+		std::vector<DrawPacket> sortBuffer;
+		std::vector<uint32_t> byteCounts;
+
+		// Counters of the last Execute or CountStateChanges.
+		RenderQueueStats stats;
+	};
+
+	/* Render queue backend keeping the order draws were given to it in, to check a queue without a graphics device. */
+	struct RecordingRenderBackend
+	{
+		// Draws in the order they were executed.
+		std::vector<DrawPacket> draws;
+
+		void operator()(const DrawPacket& packet) { draws.push_back(packet); }
+	};
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include "../../Math/Bounds.h"
+#include "../../Math/Frustum.h"
+#include "../../Math/Matrix4x4.h"
+#include <vector>
+#include <cstdint>
+
+namespace ReeeEngine
+{
+	/* Counters of the bounds tested by the last cull. */
+	struct CullingStats
+	{
+		// Bounds at least partly inside the frustum.
+		uint32_t visible = 0;
+
+		// Bounds fully outside the frustum.
+		uint32_t culled = 0;
+	};
+
+	/* Tests world space bounds against a camera frustum eight at a time and keeps which of them are visible, so draws can skip
+	 * everything off screen before it is submitted to the graphics device.
+	 * NOTE: Only uses the math layer so culling can be ran and checked without a graphics device. */
+	class FrustumCuller
+	{
+	public:
+
+		/* Test count bounds against a frustum. Returns the number of visible bounds. */
+		size_t Cull(const Frustum& frustum, const BoundingBox* bounds, size_t count)
+		{
+			visibility.resize(count);
+			const size_t visibleCount = count > 0 ? BoundsBatch::CullBoxes(frustum, bounds, count, visibility.data()) : 0;
+			stats.visible = (uint32_t)visibleCount;
+			stats.culled = (uint32_t)(count - visibleCount);
+			return visibleCount;
+		}
+
+		/* Test count bounds against the frustum of a view * projection matrix. Returns the number of visible bounds. */
+		size_t Cull(const Matrix4x4& viewProjection, const BoundingBox* bounds, size_t count)
+		{
+			return Cull(Frustum(viewProjection), bounds, count);
+		}
+
+		/* Returns if the bounds at an index were visible in the last cull. */
+		bool IsVisible(size_t index) const
+		{
+			return index < visibility.size() && visibility[index] != 0;
+		}
+
+		/* Returns one byte per bounds of the last cull, 1 for visible and 0 for culled. */
+		const std::vector<uint8_t>& GetVisibility() const
+		{
+			return visibility;
+		}
+
+		/* Returns the counters of the last cull. */
+		const CullingStats& GetStats() const
+		{
+			return stats;
+		}
+
+	private:
+
+		// If each bounds of the last cull was visible.
+		std::vector<uint8_t> visibility;
+
+		// Counters of the last cull.
+		CullingStats stats;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#pragma once
+#include "../RenderQueue.h"
+#include "../../Math/Matrix4x4.h"
+#include "../../Threading/ParallelFor.h"
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+namespace ReeeEngine
+{
+	/* Per instance transform read by the instanced vertex shader, transposed like the transform constant buffer. */
+	struct InstanceTransform
+	{
+		Matrix4x4 modelView;
+		Matrix4x4 modelViewProj;
+	};
+
+	/* Must match the eight float4 rows of the instanced vertex shaders per instance input. */
+	static_assert(sizeof(InstanceTransform) == 128, "InstanceTransform no longer matches the instanced vertex shader input layout.");
+
+	/* A run of draws in a sorted render queue drawn with one draw call. Runs of one draw are drawn as normal, longer runs are
+	 * drawn instanced from count transforms starting at firstInstance. */
+	struct InstanceBatch
+	{
+		uint32_t firstPacket;
+		uint32_t count;
+		uint32_t firstInstance;
+	};
+
+	/* Counters of the last built batches. */
+	struct InstancingStats
+	{
+		// Draws made for the runs of instances and the draws they replaced.
+		uint32_t instancedDraws = 0;
+		uint32_t instances = 0;
+
+		// Draws with nothing to be instanced with.
+		uint32_t singleDraws = 0;
+	};
+
+	/* Collapses runs of draws in a sorted render queue that share a mesh and material into instanced draws, building the transform
+	 * of every instance on the CPU each frame.
+	 * NOTE: Only uses the render queue and math layer so batches can be built and checked without a graphics device. */
+	class InstanceBatcher
+	{
+	public:
+
+		// Fewest draws worth drawing instanced and the most drawn by one instanced draw, the size of the instance buffer.
+		static constexpr uint32_t MinInstances = 2;
+		static constexpr uint32_t MaxInstances = 1024;
+
+		// Instances given to each thread when building the transforms.
+		static constexpr size_t ParallelBatchSize = 1024;
+
+		/* Split sorted draws into batches. Draws with the same shader, texture and mesh in their keys are batched together as long as
+		 * canInstance(first, other) agrees, as key ids can be shared past the bits they are given. The transforms of the instances are
+		 * built from getTransform(packet), the model matrix of a draw. */
+		template<class GetTransform, class CanInstance>
+		void Build(const std::vector<DrawPacket>& packets, const Matrix4x4& view, const Matrix4x4& projection, GetTransform&& getTransform, CanInstance&& canInstance)
+		{
+			batches.clear();
+			instancePackets.clear();
+			stats = InstancingStats();
+			const size_t count = packets.size();
+			for (size_t first = 0; first < count;)
+			{
+				// Find how many of the following draws can be drawn with the first.
+				const DrawPacket& firstPacket = packets[first];
+				const size_t last = std::min(count, first + MaxInstances);
+				size_t end = first + 1;
+				while (end < last && RenderQueue::IsSameState(firstPacket.key, packets[end].key) && canInstance(firstPacket, packets[end]))
+				{
+					end++;
+				}
+
+				// Short runs are drawn as they are.
+				const uint32_t runCount = (uint32_t)(end - first);
+				if (runCount < MinInstances)
+				{
+					for (size_t i = first; i < end; i++) batches.push_back({ (uint32_t)i, 1u, 0u });
+					stats.singleDraws += runCount;
+				}
+				else
+				{
+					const size_t firstInstance = instancePackets.size();
+					batches.push_back({ (uint32_t)first, runCount, (uint32_t)firstInstance });
+					instancePackets.resize(firstInstance + runCount);
+					for (uint32_t i = 0; i < runCount; i++) instancePackets[firstInstance + i] = (uint32_t)first + i;
+					stats.instancedDraws++;
+					stats.instances += runCount;
+				}
+				first = end;
+			}
+
+			// Build every instances transforms across threads. The matrices and arrays are copied locally first so writing the
+			// transforms can't look like it changes them, which would reload them for every instance.
+			instances.resize(instancePackets.size());
+			ParallelFor(instancePackets.size(), ParallelBatchSize, [&](size_t begin, size_t end)
+			{
+				const Matrix4x4 localView = view;
+				const Matrix4x4 localProjection = projection;
+				const DrawPacket* source = packets.data();
+				const uint32_t* sourceIndices = instancePackets.data();
+				InstanceTransform* destination = instances.data();
+				for (size_t i = begin; i < end; i++)
+				{
+					const Matrix4x4 modelView = getTransform(source[sourceIndices[i]]) * localView;
+					destination[i].modelView = modelView.GetTransposed();
+					destination[i].modelViewProj = (modelView * localProjection).GetTransposed();
+				}
+			});
+		}
+
+		/* Returns the batches covering every draw in order and the transforms of the instanced ones. */
+		const std::vector<InstanceBatch>& GetBatches() const { return batches; }
+		const std::vector<InstanceTransform>& GetInstances() const { return instances; }
+
+		/* Returns the counters of the last Build. */
+		const InstancingStats& GetStats() const { return stats; }
+
+	private:
+
+		// Batches of the last build, the draw each instance came from and their transforms.
+		std::vector<InstanceBatch> batches;
+		std::vector<uint32_t> instancePackets;
+		std::vector<InstanceTransform> instances;
+
+		// Counters of the last build.
+		InstancingStats stats;
+	};
+}
\ No newline at end of file
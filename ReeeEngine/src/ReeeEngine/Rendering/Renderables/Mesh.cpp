@@ -7,66 +7,134 @@
 #include "../AssetTypes/TextureAsset.h"
 #include "../Context/Texture.h"
 #include "../Context/SampleState.h"
+#include "../../Math/VectorBatch.h"
+#include "../../Threading/ParallelFor.h"
+#include <unordered_map>
 
 namespace ReeeEngine
 {
-	Mesh::Mesh(Graphics& graphics, const std::string& filePath, float importScale, bool lit)
+	namespace
 	{
-		// If not yet intialised add the index data.
-		if (!IsInitialised())
+		// Ids given to each shader, texture and geometry by name and the next id for geometry without a name.
+		std::unordered_map<std::string, uint32_t> shaderIds;
+		std::unordered_map<std::string, uint32_t> textureIds;
+		std::unordered_map<std::string, uint32_t> geometryIds;
+		uint32_t nextGeometryId = 0;
+
+		// Context data every instanced mesh draw shares, the instanced vertex shader with its input layout, the topology and the instance buffer.
+		Refference<VertexShader> instancedVertexShader;
+		Refference<InputLayout> instancedInputLayout;
+		Refference<Topology> instancedTopology;
+		Refference<InstanceData> instanceData;
+
+		/* Returns the id of a name, giving it the next id if it has not been seen before. */
+		uint32_t GetNameId(std::unordered_map<std::string, uint32_t>& ids, const std::string& name)
 		{
-			AddStaticData(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+			return ids.emplace(name, (uint32_t)ids.size()).first->second;
 		}
+	}
 
+	Mesh::Mesh(Graphics& graphics, const std::string& filePath, float importScale, bool lit)
+	{
+		std::vector<Vertex> vertices;
+		std::vector<unsigned short> indices;
+		LoadGeometry(filePath, importScale, vertices, indices);
+		Setup(graphics, filePath, vertices, indices, lit, filePath + "|" + std::to_string(importScale));
+	}
+
+	Mesh::Mesh(Graphics& graphics, const std::string& filePath, const std::vector<Vertex>& vertices, const std::vector<unsigned short>& indices, bool lit,
+		const std::string& geometryName)
+	{
+		Setup(graphics, filePath, vertices, indices, lit, geometryName);
+	}
+
+	void Mesh::LoadGeometry(const std::string& filePath, float importScale, std::vector<Vertex>& outVertices, std::vector<unsigned short>& outIndices)
+	{
 		// Use assimp to read the model.
-		// NOTE: Currently only setup to load root mesh and texture...
+		// NOTE: Currently only setup to load root mesh...
 		Assimp::Importer imp;
 		const auto loadedModel = imp.ReadFile(filePath + ".obj", aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
 		const auto loadedMesh = loadedModel->mMeshes[0];
 
-		// Create triangle list for the loaded model.
-		std::vector<Vertex> vertices;
-		vertices.reserve(loadedMesh->mNumVertices);
-		for (unsigned int i = 0; i < loadedMesh->mNumVertices; i++)
+		// Create triangle list for the loaded model. Positions are scaled in batches, normals and texture coordinates are copied across threads.
+		const size_t vertexCount = loadedMesh->mNumVertices;
+		outVertices.assign(vertexCount, Vertex());
+		VectorBatch::TransformPositions(Matrix4x4::Scaling(Vector3D(importScale)), &loadedMesh->mVertices[0].x, sizeof(aiVector3D), &outVertices[0].pos.x, sizeof(Vertex), vertexCount);
+		const aiVector3D* normals = loadedMesh->mNormals;
+		const aiVector3D* texCoords = loadedMesh->mTextureCoords[0];
+		ParallelFor(vertexCount, VectorBatch::ParallelBatchSize, [&](size_t begin, size_t end)
 		{
-			vertices.push_back({
-				{ loadedMesh->mVertices[i].x * importScale, loadedMesh->mVertices[i].y * importScale, loadedMesh->mVertices[i].z * importScale },
-				*reinterpret_cast<DirectX::XMFLOAT3*>(&loadedMesh->mNormals[i]),
-				*reinterpret_cast<DirectX::XMFLOAT2*>(&loadedMesh->mTextureCoords[0][i])
-				});
-		}
+			for (size_t i = begin; i < end; i++)
+			{
+				if (normals) outVertices[i].n = { normals[i].x, normals[i].y, normals[i].z };
+				if (texCoords) outVertices[i].tex = { texCoords[i].x, texCoords[i].y };
+			}
+		});
 
 		// Create index list of the loaded model.
-		std::vector<unsigned short> indices;
-		indices.reserve(loadedMesh->mNumFaces * 3);
+		outIndices.clear();
+		outIndices.reserve(loadedMesh->mNumFaces * 3);
 		for (unsigned int i = 0; i < loadedMesh->mNumFaces; i++)
 		{
 			const auto& face = loadedMesh->mFaces[i];
 			assert(face.mNumIndices == 3);
-			indices.push_back(face.mIndices[0]);
-			indices.push_back(face.mIndices[1]);
-			indices.push_back(face.mIndices[2]);
+			outIndices.push_back(face.mIndices[0]);
+			outIndices.push_back(face.mIndices[1]);
+			outIndices.push_back(face.mIndices[2]);
 		}
+	}
+
+	BoundingBox Mesh::ComputeBounds(const std::vector<Vertex>& vertices)
+	{
+		if (vertices.empty()) return BoundingBox(Vector3D(0.0f), Vector3D(0.0f));
+		return BoundingBox::FromPoints(&vertices[0].pos.x, sizeof(Vertex), vertices.size());
+	}
 
-		// Create and bind texture if a material exists.
-		// Currently just loads parents mesh material as its the only model loaded.
-		if (loadedMesh->mMaterialIndex >= 0)
+	void Mesh::Setup(Graphics& graphics, const std::string& filePath, const std::vector<Vertex>& vertices, const std::vector<unsigned short>& indices, bool lit,
+		const std::string& geometryName)
+	{
+		// Keep the bounds of the vertices so the mesh can be culled and the ids of what it is drawn with so its draws can be sorted.
+		// NOTE: Named geometry ids are given out of the same range as unnamed ones so the two never collide.
+		bounds = ComputeBounds(vertices);
+		shaderId = GetNameId(shaderIds, lit ? "LitTexture" : "Phong");
+		textureId = GetNameId(textureIds, filePath);
+		if (geometryName.empty()) geometryId = nextGeometryId++;
+		else
 		{
-			using namespace std::string_literals;
-			auto& material = *loadedModel->mMaterials[0];
-			TextureAsset* newTextureAsset = new TextureAsset();
-			bool loaded = newTextureAsset->Load(filePath + ".png");
-			if (loaded)
-			{
-				AddData(std::make_unique<Texture>(graphics, newTextureAsset));
-				AddData(std::make_unique<SampleState>(graphics));
-			}
-			else REEE_LOG(Warning, "Failed to load texture for model. No texure or sampler state binded to the pipeline...");
+			const auto found = geometryIds.emplace(geometryName, nextGeometryId);
+			if (found.second) nextGeometryId++;
+			geometryId = found.first->second;
 		}
 
+		// If not yet intialised add the index data.
+		if (!IsInitialised())
+		{
+			AddStaticData(std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST));
+		}
+
+		// Add context data that instanced draws of this mesh bind as well.
+		const auto addInstancedData = [this](Refference<ContextData> data)
+		{
+			instancedData.push_back(data.get());
+			AddData(std::move(data));
+		};
+
+		// Create and bind the models texture if it has one.
+		TextureAsset* newTextureAsset = new TextureAsset();
+		bool loaded = newTextureAsset->Load(filePath + ".png");
+		if (loaded)
+		{
+			addInstancedData(std::make_unique<Texture>(graphics, newTextureAsset));
+			addInstancedData(std::make_unique<SampleState>(graphics));
+		}
+		else REEE_LOG(Warning, "Failed to load texture for model. No texure or sampler state binded to the pipeline...");
+
 		// Bind index and vertices to rendering pipeline.
-		AddData(std::make_unique<VertextData>(graphics, vertices));
-		AddIndexData(std::make_unique<IndexData>(graphics, indices));
+		addInstancedData(std::make_unique<VertextData>(graphics, vertices));
+		auto newIndexData = std::make_unique<IndexData>(graphics, indices);
+		instancedData.push_back(newIndexData.get());
+		indexCount = newIndexData->GetNum();
+		AddIndexData(std::move(newIndexData));
 
 		// Create vertex shader to use.
 		auto pvs = lit ? std::make_unique<VertexShader>(graphics, L"../bin/Debug-x64/ReeeEngine/LitTextureVS.cso") :
@@ -75,7 +143,7 @@ namespace ReeeEngine
 		AddData(std::move(pvs));
 
 		// Create pixel shader to use.
-		AddData(lit ? std::make_unique<PixelShader>(graphics, L"../bin/Debug-x64/ReeeEngine/LitTexturePS.cso") :
+		addInstancedData(lit ? std::make_unique<PixelShader>(graphics, L"../bin/Debug-x64/ReeeEngine/LitTexturePS.cso") :
 			std::make_unique<PixelShader>(graphics, L"../bin/Debug-x64/ReeeEngine/PhongPS.cso"));
 
 		// Create topology and input layout.
@@ -87,6 +155,24 @@ namespace ReeeEngine
 		};
 		AddData(std::make_unique<InputLayout>(graphics, ied, pvsbc));
 
+		// If not yet created create the instanced draws shader, which reads the transforms of each instance from a second vertex buffer.
+		if (!instancedVertexShader)
+		{
+			instancedVertexShader = std::make_unique<VertexShader>(graphics, L"../bin/Debug-x64/ReeeEngine/InstancedVS.cso");
+			std::vector<D3D11_INPUT_ELEMENT_DESC> instancedIed = ied;
+			for (UINT row = 0; row < 4; row++)
+			{
+				instancedIed.push_back({ "InstanceModelView", row, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, row * 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 });
+			}
+			for (UINT row = 0; row < 4; row++)
+			{
+				instancedIed.push_back({ "InstanceModelViewProj", row, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, 64 + row * 16, D3D11_INPUT_PER_INSTANCE_DATA, 1 });
+			}
+			instancedInputLayout = std::make_unique<InputLayout>(graphics, instancedIed, instancedVertexShader->GetBytecode());
+			instancedTopology = std::make_unique<Topology>(graphics, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			instanceData = std::make_unique<InstanceData>(graphics);
+		}
+
 		// Create pixel shader constant buffer.
 		struct PSMaterialConstant
 		{
@@ -94,9 +180,32 @@ namespace ReeeEngine
 			float specularPower = 30.0f;
 			float padding[2];
 		} pmc;
-		AddData(std::make_unique<PixelConstantBuffer<PSMaterialConstant>>(graphics, pmc, 1u));
+		addInstancedData(std::make_unique<PixelConstantBuffer<PSMaterialConstant>>(graphics, pmc, 1u));
 
 		// Add transform data to the context.
 		AddData(std::make_unique<TransformData>(graphics, *this));
 	}
+
+	bool Mesh::CanInstanceWith(const RenderableMesh& other) const noexcept
+	{
+		const Mesh* otherMesh = dynamic_cast<const Mesh*>(&other);
+		return otherMesh && otherMesh->shaderId == shaderId && otherMesh->textureId == textureId && otherMesh->geometryId == geometryId;
+	}
+
+	void Mesh::RenderInstanced(Graphics& graphics, const InstanceTransform* instances, UINT count) const noexcept
+	{
+		// Bind this meshes buffers, texture and pixel shader with the shared instanced vertex shader in place of its own.
+		for (ContextData* data : instancedData)
+		{
+			data->Add(graphics);
+		}
+		instancedTopology->Add(graphics);
+		instancedVertexShader->Add(graphics);
+		instancedInputLayout->Add(graphics);
+
+		// Fill the instance buffer with the transforms of this draw and draw every instance.
+		instanceData->Update(graphics, instances, count);
+		instanceData->Add(graphics);
+		graphics.DrawInstanced(indexCount, count);
+	}
 }
\ No newline at end of file
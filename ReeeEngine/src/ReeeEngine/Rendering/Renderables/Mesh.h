@@ -1,5 +1,6 @@
 #pragma once
 #include "Renderable.h"
+#include "../../Math/Bounds.h"
 
 namespace ReeeEngine
 {
@@ -10,6 +11,49 @@ namespace ReeeEngine
 
 		/* Mesh constructor from a given file. */
 		Mesh(Graphics& graphics, const std::string& filePath, float importScale = 1.0f, bool lit = false);
+
+		/* Mesh constructor from already loaded geometry, textured with the texture of the given file, e.g. merged static meshes.
+		 * NOTE: Meshes given the same geometry name share a geometry id, meshes without one get their own. */
+		Mesh(Graphics& graphics, const std::string& filePath, const std::vector<Vertex>& vertices, const std::vector<unsigned short>& indices, bool lit = false,
+			const std::string& geometryName = "");
+
+		/* Load the vertices and indices of a files root mesh without creating anything on the graphics device. */
+		static void LoadGeometry(const std::string& filePath, float importScale, std::vector<Vertex>& outVertices, std::vector<unsigned short>& outIndices);
+
+		/* Returns the box around a list of vertices, a point at the origin if there are none. */
+		static BoundingBox ComputeBounds(const std::vector<Vertex>& vertices);
+
+		/* Returns the bounds of the meshes vertices in its own space, found when it was created. */
+		const BoundingBox& GetBounds() const { return bounds; }
+
+		/* Ids of the shaders, texture and geometry the mesh is drawn with, the same between meshes sharing them so draws can be sorted by them. */
+		uint32_t GetShaderId() const { return shaderId; }
+		uint32_t GetTextureId() const { return textureId; }
+		uint32_t GetGeometryId() const { return geometryId; }
+
+		/* Meshes with the same shaders, texture and geometry can be drawn as instances of one draw with this meshes buffers and texture. */
+		virtual bool CanInstanceWith(const RenderableMesh& other) const noexcept override;
+		virtual void RenderInstanced(Graphics& graphics, const InstanceTransform* instances, UINT count) const noexcept override;
+
+	private:
+
+		/* Create the buffers, texture, shaders and constant buffers used to draw the given geometry. */
+		void Setup(Graphics& graphics, const std::string& filePath, const std::vector<Vertex>& vertices, const std::vector<unsigned short>& indices, bool lit,
+			const std::string& geometryName);
+
+	private:
+
+		// Bounds of the meshes vertices.
+		BoundingBox bounds;
+
+		// The meshes own context data bound for instanced draws, everything but the transform, vertex shader and input layout, and its index count.
+		std::vector<ContextData*> instancedData;
+		UINT indexCount = 0;
+
+		// Ids of the shaders, texture and geometry used.
+		uint32_t shaderId = 0;
+		uint32_t textureId = 0;
+		uint32_t geometryId = 0;
 	};
 }
 
@@ -8,8 +8,7 @@ namespace ReeeEngine
 	RenderableMesh::RenderableMesh()
 	{
 		// Set default transform to 0 rotation/rotation in all axis with 1 scale in all axis.
-		meshTransform = DirectX::XMMatrixScaling(1.0f, 1.0f, 1.0f) * DirectX::XMMatrixRotationRollPitchYaw(0.0f, 0.0f, 0.0f) *
-			DirectX::XMMatrixTranslation(0.0f, 0.0f, 0.0f);
+		meshTransform = Matrix4x4::Identity();
 	}
 
 	void RenderableMesh::Render(Graphics& graphics) const noexcept
@@ -28,12 +27,22 @@ namespace ReeeEngine
 		graphics.Draw(pIndexData->GetNum());
 	}
 
-	void RenderableMesh::SetTransform(const DirectX::XMMATRIX& newTransform)
+	bool RenderableMesh::CanInstanceWith(const RenderableMesh& other) const noexcept
+	{
+		return false;
+	}
+
+	void RenderableMesh::RenderInstanced(Graphics& graphics, const InstanceTransform* instances, UINT count) const noexcept
+	{
+		assert("Renderable can not be drawn instanced, CanInstanceWith has to be overridden along with RenderInstanced" && false);
+	}
+
+	void RenderableMesh::SetTransform(const Matrix4x4& newTransform)
 	{
 		meshTransform = newTransform;
 	}
 
-	DirectX::XMMATRIX RenderableMesh::GetTransform() const noexcept
+	Matrix4x4 RenderableMesh::GetTransform() const noexcept
 	{
 		return meshTransform;
 	}
@@ -3,11 +3,13 @@
 #include "../../Math/ReeeMath.h"
 #include "../../Math/Vector3D.h"
 #include "../../Math/Rotator.h"
+#include "../../Math/Matrix4x4.h"
 
 namespace ReeeEngine
 {
 	// Define classes used.
 	class ContextData;
+	struct InstanceTransform;
 
 	/* Renderable class to parent anything that is a loaded mesh.
 	 * NOTE: Contains the functions needed to update and render a object with vertexes to the rendering texture. */
@@ -24,12 +26,19 @@ namespace ReeeEngine
 		virtual ~RenderableMesh() = default;
 
 		/* Get/Set the renderable transform position. */
-		void SetTransform(const DirectX::XMMATRIX& newTransform);
-		virtual DirectX::XMMATRIX GetTransform() const noexcept;
+		void SetTransform(const Matrix4x4& newTransform);
+		virtual Matrix4x4 GetTransform() const noexcept;
 
 		/* Render the position of the renderable to the render texture on the pipeline. */
 		void Render(Graphics& graphics) const noexcept;
 
+		/* Returns if this and another renderable draw the same geometry with the same material, so can be drawn as instances of one draw.
+		 * NOTE: Renderables can not be instanced unless they override this and RenderInstanced. */
+		virtual bool CanInstanceWith(const RenderableMesh& other) const noexcept;
+
+		/* Render the renderable once for each of count instance transforms in one draw. */
+		virtual void RenderInstanced(Graphics& graphics, const InstanceTransform* instances, UINT count) const noexcept;
+
 	protected:
 
 		/* Add context data to the renderable for example a constant buffer or transform... */
@@ -50,6 +59,6 @@ namespace ReeeEngine
 		std::vector<Refference<ContextData>> pContextData;
 
 		// Position of the mesh in the world for rendering purposes.
-		DirectX::XMMATRIX meshTransform;
+		Matrix4x4 meshTransform;
 	};
 }
\ No newline at end of file
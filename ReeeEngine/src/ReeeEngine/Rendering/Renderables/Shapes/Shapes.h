@@ -1,6 +1,11 @@
 #pragma once
 #include <vector>
+#include <array>
+#include <cassert>
 #include "../../../Math/ReeeMath.h"
+#include "../../../Math/Vector3D.h"
+#include "../../../Math/Matrix4x4.h"
+#include "../../../Math/VectorBatch.h"
 
 namespace ReeeEngine
 {
@@ -19,14 +24,11 @@ namespace ReeeEngine
 		}
 
 		/* Transform the vertices's and indices relative to the transform matrix passed in. */
-		void Transform(DirectX::FXMMATRIX transformMatrix)
+		void Transform(const Matrix4x4& transformMatrix)
 		{
-			// Loop through each vertex and transform it relative to its current position and the passed transform matrix.
-			for (auto& vertex : vertices)
-			{
-				const DirectX::XMVECTOR vertexPos = DirectX::XMLoadFloat3(&vertex.pos);
-				DirectX::XMStoreFloat3(&vertex.pos, DirectX::XMVector3Transform(vertexPos, transformMatrix));
-			}
+			// Transform every vertex position relative to its current position and the passed transform matrix in batches.
+			if (vertices.empty()) return;
+			VectorBatch::TransformPositions(transformMatrix, &vertices[0].pos.x, sizeof(T), vertices.size());
 		}
 
 		/* Set up face-independent vertices w/ normals cleared to zero... 
@@ -34,18 +36,25 @@ namespace ReeeEngine
 		void SetNormalsIndependentFlat()
 		{
 			assert(indices.size() % 3 == 0 && indices.size() > 0);
-			for (size_t i = 0; i < indices.size(); i += 3)
+
+			// Work out every face normal in batches first.
+			const size_t triangleCount = indices.size() / 3;
+			std::vector<float> normals(triangleCount * 3);
+			float* normalX = normals.data();
+			float* normalY = normalX + triangleCount;
+			float* normalZ = normalY + triangleCount;
+			VectorBatch::ComputeFaceNormals(&vertices[0].pos.x, sizeof(T), indices.data(), indices.size(), normalX, normalY, normalZ);
+
+			// Then write them to each face's vertices in order so shared vertices end up with the last face's normal like before.
+			for (size_t i = 0; i < triangleCount; i++)
 			{
-				auto& v0 = vertices[indices[i]];
-				auto& v1 = vertices[indices[i + 1]];
-				auto& v2 = vertices[indices[i + 2]];
-				const auto p0 = DirectX::XMLoadFloat3(&v0.pos);
-				const auto p1 = DirectX::XMLoadFloat3(&v1.pos);
-				const auto p2 = DirectX::XMLoadFloat3(&v2.pos);
-				const auto n = DirectX::XMVector3Normalize(DirectX::XMVector3Cross((p1 - p0), (p2 - p0)));
-				DirectX::XMStoreFloat3(&v0.n, n);
-				DirectX::XMStoreFloat3(&v1.n, n);
-				DirectX::XMStoreFloat3(&v2.n, n);
+				for (size_t corner = 0; corner < 3; corner++)
+				{
+					auto& vertex = vertices[indices[i * 3 + corner]];
+					vertex.n.x = normalX[i];
+					vertex.n.y = normalY[i];
+					vertex.n.z = normalZ[i];
+				}
 			}
 		}
 
@@ -66,7 +75,7 @@ namespace ReeeEngine
 		{
 			// Create each vertex of a cube and add it to the verteces list.
 			constexpr float side = 1.0f / 2.0f;
-			std::vector<DirectX::XMFLOAT3> vertices;
+			std::vector<Vector3D> vertices;
 			vertices.emplace_back(-side, -side, -side);
 			vertices.emplace_back(side, -side, -side);
 			vertices.emplace_back(-side, side, -side);
@@ -80,7 +89,7 @@ namespace ReeeEngine
 			std::vector<V> verts(vertices.size());
 			for (size_t i = 0; i < vertices.size(); i++)
 			{
-				verts[i].pos = vertices[i];
+				VectorStoreFloat3(vertices[i].ToRegister(), &verts[i].pos.x);
 			}
 
 			// Return verts and indeces to present a cube mesh.
@@ -121,7 +130,7 @@ namespace ReeeEngine
 			const float sideY = height / 2.0f;
 			const float divisionSizeX = width / float(xDiv);
 			const float divisionSizeY = height / float(yDiv);
-			const auto bottomLeft = DirectX::XMVectorSet(-sideX, -sideY, 0.0f, 0.0f);
+			const Vector3D bottomLeft = Vector3D(-sideX, -sideY, 0.0f);
 
 			// For each vertex along the x and y-axis add it to the set of vectors in the correct position.
 			for (int y = 0, i = 0; y < vertNumY; y++)
@@ -130,8 +139,8 @@ namespace ReeeEngine
 				for (int x = 0; x < vertNumX; x++, i++)
 				{
 					// Create new vert and add to list.
-					DirectX::XMVECTOR newVert = DirectX::XMVectorAdd(bottomLeft, DirectX::XMVectorSet(float(x) * divisionSizeX, yPosition, 0.0f, 0.0f));
-					DirectX::XMStoreFloat3(&vertices[i].pos, newVert);
+					const Vector3D newVert = bottomLeft + Vector3D(float(x) * divisionSizeX, yPosition, 0.0f);
+					VectorStoreFloat3(newVert.ToRegister(), &vertices[i].pos.x);
 				}
 			}
 
@@ -180,7 +189,7 @@ namespace ReeeEngine
 			assert(verticalDiv >= 3);
 
 			// Create transform for creating sections of the sphere with the correct number of divisions.
-			const auto transform = DirectX::XMVectorSet(0.0f, 0.0f, radius, 0.0f);
+			const Vector3D transform = Vector3D(0.0f, 0.0f, radius);
 			const float horizontalAngle = PI / horizonalDiv;
 			const float verticalAngle = 2.0f * PI / verticalDiv;
 
@@ -188,22 +197,22 @@ namespace ReeeEngine
 			std::vector<V> vertices;
 			for (int h = 1; h < horizonalDiv; h++)
 			{
-				DirectX::XMVECTOR horizontalPos = DirectX::XMVector3Transform(transform, DirectX::XMMatrixRotationX(horizontalAngle * h));
+				const Vector3D horizontalPos = Matrix4x4::RotationX(horizontalAngle * h).TransformPosition(transform);
 				for (int v = 0; v < verticalDiv; v++)
 				{
 					vertices.emplace_back();
-					DirectX::XMVECTOR verticalPos = DirectX::XMVector3Transform(horizontalPos, DirectX::XMMatrixRotationZ(verticalAngle * v));
-					DirectX::XMStoreFloat3(&vertices.back().pos, verticalPos);
+					const Vector3D verticalPos = Matrix4x4::RotationZ(verticalAngle * v).TransformPosition(horizontalPos);
+					VectorStoreFloat3(verticalPos.ToRegister(), &vertices.back().pos.x);
 				}
 			}
 
 			// Cap the top and bottom of the mesh.
 			const auto topPole = (unsigned short)vertices.size();
 			vertices.emplace_back();
-			DirectX::XMStoreFloat3(&vertices.back().pos, transform);
+			VectorStoreFloat3(transform.ToRegister(), &vertices.back().pos.x);
 			const auto bottomPole = (unsigned short)vertices.size();
 			vertices.emplace_back();
-			DirectX::XMStoreFloat3(&vertices.back().pos, DirectX::XMVectorNegate(transform));
+			VectorStoreFloat3((-transform).ToRegister(), &vertices.back().pos.x);
 
 			// Lambda function for returning index position of the current horizontal and vertical division.
 			const auto GetIndexPosition = [horizonalDiv, verticalDiv](unsigned short h, unsigned short v)
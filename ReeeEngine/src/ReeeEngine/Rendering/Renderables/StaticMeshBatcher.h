@@ -0,0 +1,152 @@
+#pragma once
+#include "../../Math/Matrix4x4.h"
+#include "../../Math/VectorBatch.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <limits>
+
+namespace ReeeEngine
+{
+	/* Merges the geometry of static meshes that share a material into as few vertex and index lists as possible so each list
+	 * can be drawn in one draw. Meshes are moved into world space as they are added so the merged lists are drawn untransformed.
+	 * NOTE: Only uses the math layer so merging can be ran and checked without a graphics device.
+	 *       V can be any vertex type with pos and n members made of x, y and z floats, e.g. Vertex. */
+	template<class V>
+	class StaticMeshBatcher
+	{
+	public:
+
+		// Index type used by every mesh in the engine, it limits how many vertices one batch can hold.
+		typedef unsigned short IndexType;
+		static constexpr size_t MaxBatchVertices = size_t(std::numeric_limits<IndexType>::max()) + 1;
+
+		// Returned by Add when a mesh can not be merged.
+		static constexpr size_t InvalidBatch = ~size_t(0);
+
+		/* Where the vertices and indices of one added mesh are in its batch. Empty once the mesh is removed. */
+		struct MeshRange
+		{
+			size_t firstVertex = 0;
+			size_t vertexCount = 0;
+			size_t firstIndex = 0;
+			size_t indexCount = 0;
+		};
+
+		/* Merged world space geometry of one or more meshes that share a material. */
+		struct Batch
+		{
+			std::string materialKey;
+			std::vector<V> vertices;
+			std::vector<IndexType> indices;
+
+			// Range of each mesh added to the batch by its slot and the number of them not yet removed.
+			std::vector<MeshRange> meshes;
+			size_t meshCount = 0;
+		};
+
+		/* Move a mesh into world space and add it to the batch of its material, a new batch is started once the batch being
+		 * filled can not fit the meshes vertices. Returns the index of the batch the mesh was added to and sets meshSlot to the slot
+		 * it can be removed with if one is given.
+		 * NOTE: Meshes with more vertices than a batch can hold return InvalidBatch and have to be drawn on their own. */
+		size_t Add(const std::string& materialKey, const std::vector<V>& vertices, const std::vector<IndexType>& indices, const Matrix4x4& worldMatrix,
+			size_t* meshSlot = nullptr)
+		{
+			if (vertices.empty() || indices.empty() || vertices.size() > MaxBatchVertices) return InvalidBatch;
+
+			// Find the batch being filled for this material or start a new one.
+			auto openBatch = openBatches.find(materialKey);
+			if (openBatch == openBatches.end() || batches[openBatch->second].vertices.size() + vertices.size() > MaxBatchVertices)
+			{
+				batches.emplace_back();
+				batches.back().materialKey = materialKey;
+				openBatch = openBatches.insert_or_assign(materialKey, batches.size() - 1).first;
+			}
+			const size_t batchIndex = openBatch->second;
+			Batch& batch = batches[batchIndex];
+
+			// Copy the vertices across then move their positions and normals into world space in place.
+			const size_t firstVertex = batch.vertices.size();
+			batch.vertices.insert(batch.vertices.end(), vertices.begin(), vertices.end());
+			V* const addedVertices = &batch.vertices[firstVertex];
+			VectorBatch::TransformPositions(worldMatrix, &addedVertices->pos.x, sizeof(V), vertices.size());
+			VectorBatch::TransformNormals(worldMatrix, &addedVertices->n.x, sizeof(V), vertices.size());
+
+			// Offset the indices past the vertices already in the batch.
+			// A mirroring matrix flips the winding of every triangle so swap two of their corners to keep the same faces in front.
+			const bool mirrored = worldMatrix.GetDeterminant() < 0.0f;
+			const size_t firstIndex = batch.indices.size();
+			batch.indices.reserve(batch.indices.size() + indices.size());
+			for (size_t i = 0; i + 2 < indices.size(); i += 3)
+			{
+				batch.indices.push_back(IndexType(firstVertex + indices[i]));
+				batch.indices.push_back(IndexType(firstVertex + indices[mirrored ? i + 2 : i + 1]));
+				batch.indices.push_back(IndexType(firstVertex + indices[mirrored ? i + 1 : i + 2]));
+			}
+			MeshRange range;
+			range.firstVertex = firstVertex;
+			range.vertexCount = vertices.size();
+			range.firstIndex = firstIndex;
+			range.indexCount = batch.indices.size() - firstIndex;
+			if (meshSlot) *meshSlot = batch.meshes.size();
+			batch.meshes.push_back(range);
+			batch.meshCount++;
+			return batchIndex;
+		}
+
+		/* Remove the geometry of an added mesh from its batch, moving the meshes added after it down into the gap.
+		 * Returns false if there is no such mesh or it has already been removed. */
+		bool Remove(size_t batchIndex, size_t meshSlot)
+		{
+			if (batchIndex >= batches.size() || meshSlot >= batches[batchIndex].meshes.size()) return false;
+			Batch& batch = batches[batchIndex];
+			const MeshRange removed = batch.meshes[meshSlot];
+			if (removed.vertexCount == 0) return false;
+
+			// Later meshes always come after this one in both lists so only their indices and ranges need moving down.
+			batch.vertices.erase(batch.vertices.begin() + removed.firstVertex, batch.vertices.begin() + removed.firstVertex + removed.vertexCount);
+			batch.indices.erase(batch.indices.begin() + removed.firstIndex, batch.indices.begin() + removed.firstIndex + removed.indexCount);
+			for (size_t i = removed.firstIndex; i < batch.indices.size(); i++) batch.indices[i] = IndexType(batch.indices[i] - removed.vertexCount);
+			for (size_t slot = meshSlot + 1; slot < batch.meshes.size(); slot++)
+			{
+				MeshRange& range = batch.meshes[slot];
+				if (range.vertexCount == 0) continue;
+				range.firstVertex -= removed.vertexCount;
+				range.firstIndex -= removed.indexCount;
+			}
+			batch.meshes[meshSlot] = MeshRange();
+			batch.meshCount--;
+			return true;
+		}
+
+		/* Returns every batch in the order they were started. */
+		const std::vector<Batch>& GetBatches() const
+		{
+			return batches;
+		}
+
+		/* Remove every batch and start again with none. */
+		void Clear()
+		{
+			batches.clear();
+			openBatches.clear();
+		}
+
+		/* Move out every batch and start again with none. */
+		std::vector<Batch> TakeBatches()
+		{
+			std::vector<Batch> takenBatches = std::move(batches);
+			batches.clear();
+			openBatches.clear();
+			return takenBatches;
+		}
+
+	private:
+
+		// Every batch started so far.
+		std::vector<Batch> batches;
+
+		// Index of the batch currently being filled for each material.
+		std::unordered_map<std::string, size_t> openBatches;
+	};
+}
\ No newline at end of file
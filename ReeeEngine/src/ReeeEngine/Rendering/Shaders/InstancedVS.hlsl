@@ -0,0 +1,23 @@
+struct VSOut
+{
+	float3 worldPos : Position;
+	float3 normal : Normal;
+	float2 tc : Texcoord;
+	float4 pos : SV_Position;
+};
+
+// Same as the textured vertex shaders with the transforms read per instance, each given as the four rows of the transposed matrix.
+VSOut main(float3 pos : Position, float3 n : Normal, float2 tc : Texcoord,
+	float4 mv0 : InstanceModelView0, float4 mv1 : InstanceModelView1, float4 mv2 : InstanceModelView2, float4 mv3 : InstanceModelView3,
+	float4 mvp0 : InstanceModelViewProj0, float4 mvp1 : InstanceModelViewProj1, float4 mvp2 : InstanceModelViewProj2, float4 mvp3 : InstanceModelViewProj3)
+{
+	const matrix modelView = transpose(matrix(mv0, mv1, mv2, mv3));
+	const matrix modelViewProj = transpose(matrix(mvp0, mvp1, mvp2, mvp3));
+
+	VSOut vso;
+	vso.worldPos = (float3) mul(float4(pos, 1.0f), modelView);
+	vso.normal = mul(n, (float3x3) modelView);
+	vso.pos = mul(float4(pos, 1.0f), modelViewProj);
+	vso.tc = tc;
+	return vso;
+}
\ No newline at end of file
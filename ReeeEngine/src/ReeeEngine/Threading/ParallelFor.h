@@ -0,0 +1,24 @@
+#pragma once
+#include "WorkerPool.h"
+#include <thread>
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace ReeeEngine
+{
+	/* Returns the number of threads work can be split across, at least 1. */
+	inline unsigned int GetParallelThreadCount()
+	{
+		static const unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+		return threadCount;
+	}
+
+	/* Run function(begin, end) over the range [0, count) split into chunks across the shared worker pool.
+	 * NOTE: Chunks are never smaller than minBatchSize so small inputs run on the calling thread with no overhead.
+	 *       The calling thread helps run the chunks and this only returns once every chunk has finished. */
+	inline void ParallelFor(size_t count, size_t minBatchSize, const std::function<void(size_t, size_t)>& function)
+	{
+		WorkerPool::GetShared().ParallelFor(count, minBatchSize, function);
+	}
+}
\ No newline at end of file
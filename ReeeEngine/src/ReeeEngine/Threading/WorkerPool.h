@@ -0,0 +1,216 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+
+namespace ReeeEngine
+{
+	/* Pool of persistent worker threads that run parallel for loops with work stealing.
+	 * Each loop is split into chunks that are dealt out evenly to every thread's own queue. A thread works through its own
+	 * queue from the front and once it is empty steals chunks from the back of the other queues, so uneven chunks still
+	 * keep every thread busy. As long as each part of the range only writes its own results the output does not depend on
+	 * the number of threads or which thread ran which chunk.
+	 * NOTE: The calling thread works on the loop too. Loops started from inside a loop, or while another thread is using the
+	 *       pool, run on the calling thread instead of waiting. */
+	class WorkerPool
+	{
+	public:
+
+		/* Function ran over the range [begin, end) of a loop. */
+		typedef std::function<void(size_t, size_t)> RangeFunction;
+
+		/* Setup the pool to run loops across threadCount threads, the calling thread included. */
+		explicit WorkerPool(unsigned int threadCount) : queues(std::max(1u, threadCount)), remainingChunks(0), generation(0), stopping(false)
+		{
+			for (unsigned int i = 0; i < std::max(1u, threadCount); i++)
+			{
+				queues[i] = std::make_unique<WorkQueue>();
+			}
+			for (unsigned int i = 1; i < queues.size(); i++)
+			{
+				workers.emplace_back([this, i]() { WorkerLoop(i); });
+			}
+		}
+
+		/* Stop and join every worker thread. */
+		~WorkerPool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				stopping = true;
+			}
+			wakeCondition.notify_all();
+			for (auto& worker : workers) worker.join();
+		}
+
+		/* The pool owns its threads so it can't be copied. */
+		WorkerPool(const WorkerPool&) = delete;
+		WorkerPool& operator=(const WorkerPool&) = delete;
+
+		/* Returns the number of threads loops are split across, the calling thread included. */
+		unsigned int GetThreadCount() const
+		{
+			return (unsigned int)queues.size();
+		}
+
+		/* Run function(begin, end) over the range [0, count) and only return once all of it has finished.
+		 * NOTE: Chunks are never smaller than minBatchSize so small inputs run on the calling thread with no overhead. */
+		void ParallelFor(size_t count, size_t minBatchSize, const RangeFunction& function)
+		{
+			if (count == 0) return;
+
+			// A few chunks per thread gives stealing something to balance with.
+			const size_t maxChunks = std::max<size_t>(1, count / std::max<size_t>(1, minBatchSize));
+			const size_t chunkCount = std::min<size_t>(maxChunks, (size_t)GetThreadCount() * ChunksPerThread);
+			std::unique_lock<std::mutex> submitLock(submitMutex, std::try_to_lock);
+			if (chunkCount <= 1 || IsWorkerThread() || !submitLock.owns_lock())
+			{
+				function(0, count);
+				return;
+			}
+
+			// Set the chunks to wait for first as a worker still looking for work could take one as soon as it is queued.
+			const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+			remainingChunks.store((count + chunkSize - 1) / chunkSize);
+
+			// Deal out contiguous runs of chunks so each thread starts on its own part of the range.
+			const size_t queueCount = queues.size();
+			for (size_t queue = 0; queue < queueCount; queue++)
+			{
+				const size_t firstChunk = queue * chunkCount / queueCount;
+				const size_t lastChunk = (queue + 1) * chunkCount / queueCount;
+				std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+				for (size_t chunk = firstChunk; chunk < lastChunk; chunk++)
+				{
+					const size_t begin = chunk * chunkSize;
+					if (begin >= count) break;
+					queues[queue]->chunks.push_back({ begin, std::min(count, begin + chunkSize), &function });
+				}
+			}
+
+			// Wake the workers and help out on this thread until every chunk has finished.
+			{
+				std::lock_guard<std::mutex> lock(wakeMutex);
+				generation++;
+			}
+			wakeCondition.notify_all();
+			RunChunks(0);
+			while (remainingChunks.load() != 0) std::this_thread::yield();
+		}
+
+		/* Returns the pool shared by the engine, sized to the number of cores.
+		 * NOTE: Never destroyed so no threads are joined while the process is shutting down. */
+		static WorkerPool& GetShared()
+		{
+			static WorkerPool* sharedPool = new WorkerPool(std::max(1u, std::thread::hardware_concurrency()));
+			return *sharedPool;
+		}
+
+	private:
+
+		/* A part of a loop waiting to be ran. */
+		struct Chunk
+		{
+			size_t begin;
+			size_t end;
+			const RangeFunction* function;
+		};
+
+		/* Chunks owned by one thread. The owner takes from the front and other threads steal from the back. */
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Chunk> chunks;
+		};
+
+		/* Returns if the current thread is running chunks for a pool. */
+		static bool& IsWorkerThread()
+		{
+			static thread_local bool workerThread = false;
+			return workerThread;
+		}
+
+		/* Take the next chunk from a threads own queue, or steal one from another. Returns false once every queue is empty. */
+		bool TakeChunk(size_t queueIndex, Chunk& outChunk)
+		{
+			{
+				WorkQueue& own = *queues[queueIndex];
+				std::lock_guard<std::mutex> lock(own.mutex);
+				if (!own.chunks.empty())
+				{
+					outChunk = own.chunks.front();
+					own.chunks.pop_front();
+					return true;
+				}
+			}
+			for (size_t offset = 1; offset < queues.size(); offset++)
+			{
+				WorkQueue& victim = *queues[(queueIndex + offset) % queues.size()];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if (!victim.chunks.empty())
+				{
+					outChunk = victim.chunks.back();
+					victim.chunks.pop_back();
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/* Run chunks until there are none left to take. */
+		void RunChunks(size_t queueIndex)
+		{
+			IsWorkerThread() = true;
+			Chunk chunk;
+			while (TakeChunk(queueIndex, chunk))
+			{
+				(*chunk.function)(chunk.begin, chunk.end);
+				remainingChunks.fetch_sub(1);
+			}
+			IsWorkerThread() = false;
+		}
+
+		/* Worker threads sleep until a loop is started then help run it. */
+		void WorkerLoop(size_t queueIndex)
+		{
+			size_t seenGeneration = 0;
+			while (true)
+			{
+				{
+					std::unique_lock<std::mutex> lock(wakeMutex);
+					wakeCondition.wait(lock, [&]() { return stopping || generation != seenGeneration; });
+					if (stopping) return;
+					seenGeneration = generation;
+				}
+				RunChunks(queueIndex);
+			}
+		}
+
+	private:
+
+		// Number of chunks each loop is split into per thread.
+		static const size_t ChunksPerThread = 4;
+
+		// Chunk queue of each thread, the calling thread uses the first.
+		std::vector<std::unique_ptr<WorkQueue>> queues;
+		std::vector<std::thread> workers;
+
+		// Chunks of the current loop that have not finished yet.
+		std::atomic<size_t> remainingChunks;
+
+		// Only one thread can run a loop on the pool at a time.
+		std::mutex submitMutex;
+
+		// Workers wait on this until the generation changes, meaning a new loop has started, or the pool is stopping.
+		std::mutex wakeMutex;
+		std::condition_variable wakeCondition;
+		size_t generation;
+		bool stopping;
+	};
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <queue>
 #include <bitset>
+#include "../Globals.h"
 #include "../Math/Vector2D.h"
 #include "WindowsKeyCodes.h"
 
@@ -32,33 +32,11 @@ namespace ReeeEngine
 		SetProjectionSettings();
 	}
 
-	DirectX::XMMATRIX CameraComponent::GetViewMatrix() const
+	Matrix4x4 CameraComponent::GetViewMatrix() const
 	{
-		// Get the base forward vector.
-		const DirectX::XMVECTOR Forward = DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
-
-		// Apply camera rotations to the base forward vector.
-		Rotator worldRotation = GetWorldRotation().ToRadians();
-		Vector3D worldPosition = GetWorldLocation();
-		DirectX::XMVECTOR lookVector = DirectX::XMVector3Transform(Forward, DirectX::XMMatrixRotationRollPitchYaw(worldRotation.Pitch, worldRotation.Yaw, worldRotation.Roll));
-
-		// Get the cameras position from the world location vector 3d.
-		DirectX::XMVECTOR cameraPosition = DirectX::XMLoadFloat3(&worldPosition.ToFloat3());
-
-		// Get the direction the camera is looking in.
-		DirectX::XMFLOAT3 float3LookVector;
-		DirectX::XMFLOAT3 camTarget;
-		DirectX::XMStoreFloat3(&float3LookVector, lookVector);
-		camTarget.x = worldPosition.X + float3LookVector.x;
-		camTarget.y = worldPosition.Y + float3LookVector.y;
-		camTarget.z = worldPosition.Z + float3LookVector.z;
-
-		// Get the up vector.
-		DirectX::XMVECTOR upDirection = DirectX::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-		DirectX::XMVECTOR worldRotationVector = DirectX::XMQuaternionRotationRollPitchYaw(worldRotation.Pitch, worldRotation.Yaw, worldRotation.Roll);
-
-		// Return the view matrix.
-		return DirectX::XMMatrixLookAtLH(cameraPosition, DirectX::XMLoadFloat3(&camTarget), DirectX::XMVector3Rotate(upDirection, worldRotationVector));
+		// Look along the cameras forward vector with its up vector using the world transforms cached rotation.
+		const Transform worldTransform = GetWorldTransform();
+		return Matrix4x4::LookToLH(worldTransform.GetLocation(), worldTransform.GetForwardVector(), worldTransform.GetUpVector());
 	}
 
 	void CameraComponent::SetProjectionSettings(float fov, float newWidth, float newHeight, float nearClip, float farClip) noexcept
@@ -71,16 +49,16 @@ namespace ReeeEngine
 		if (farClip != 0.0f) projectionSettings.farClip = farClip;
 
 		// Set new matrix.
-		auto newMatrix = DirectX::XMMatrixPerspectiveFovLH(ReeeMath::Radians(projectionSettings.fov), ReeeMath::GetAspectRatio(projectionSettings.width, projectionSettings.height), projectionSettings.nearClip, projectionSettings.farClip);
+		const Matrix4x4 newMatrix = Matrix4x4::PerspectiveFovLH(ReeeMath::Radians(projectionSettings.fov), ReeeMath::GetAspectRatio(projectionSettings.width, projectionSettings.height), projectionSettings.nearClip, projectionSettings.farClip);
 		SetProjectionMatrix(newMatrix);
 	}
 
-	void CameraComponent::SetProjectionMatrix(DirectX::FXMMATRIX projectionMat) noexcept
+	void CameraComponent::SetProjectionMatrix(const Matrix4x4& projectionMat) noexcept
 	{
 		projectionMatrix = projectionMat;
 	}
 
-	DirectX::XMMATRIX CameraComponent::GetProjectionMatrix() const noexcept
+	Matrix4x4 CameraComponent::GetProjectionMatrix() const noexcept
 	{
 		return projectionMatrix;
 	}
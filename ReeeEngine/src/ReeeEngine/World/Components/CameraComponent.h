@@ -1,6 +1,7 @@
 #pragma once
 #include "../../Globals.h"
 #include "../../Math/ReeeMath.h"
+#include "../../Math/Matrix4x4.h"
 #include "SceneComponent.h"
 
 namespace ReeeEngine
@@ -29,13 +30,13 @@ namespace ReeeEngine
 		virtual void Tick(float deltaTime) override;
 
 		/* Returns view matrix. */
-		DirectX::XMMATRIX GetViewMatrix() const;
+		Matrix4x4 GetViewMatrix() const;
 
 		/* Projection matrix functions for changing camera's FOV, far and near clip planes and aspect ratio from height and width of monitor. */
 		void SetWindowSize(float width, float height);
 		void SetProjectionSettings(float fov = 0.0f, float newWidth = 0.0f, float newHeight = 0.0f, float nearClip = 0.0f, float farClip = 0.0f) noexcept;
-		void SetProjectionMatrix(DirectX::FXMMATRIX projectionMat) noexcept;
-		DirectX::XMMATRIX GetProjectionMatrix() const noexcept;
+		void SetProjectionMatrix(const Matrix4x4& projectionMat) noexcept;
+		Matrix4x4 GetProjectionMatrix() const noexcept;
 
 	private:
 
@@ -43,6 +44,6 @@ namespace ReeeEngine
 		ProjectionSettings projectionSettings;
 
 		/* Current projection matrix. */
-		DirectX::XMMATRIX projectionMatrix;
+		Matrix4x4 projectionMatrix;
 	};
 }
\ No newline at end of file
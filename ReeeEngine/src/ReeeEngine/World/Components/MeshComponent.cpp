@@ -1,21 +1,354 @@
 #include "MeshComponent.h"
 #include "..\..\Application.h"
 #include "..\..\Rendering\Renderables\Mesh.h"
+#include "..\..\Rendering\Renderables\StaticMeshBatcher.h"
+#include "..\..\Rendering\Renderables\FrustumCuller.h"
+#include "..\..\Threading\ParallelFor.h"
+#include "..\Core\GameObject.h"
+#include <unordered_map>
+#include <mutex>
 
 namespace ReeeEngine
 {
-	MeshComponent::MeshComponent(const std::string name) : SceneComponent(name) {}
+	namespace
+	{
+		// Every mesh component in the world in the order they were created and the world bounds of each, kept packed for culling.
+		std::vector<MeshComponent*> meshComponents;
+		std::vector<BoundingBox> meshWorldBounds;
+
+		// Mesh components moved since the last ResolveMeshTransforms.
+		std::vector<MeshComponent*> pendingMeshTransforms;
+
+		// Counters for the frame being built and the last resolved frame.
+		MeshTransformStats currentStats;
+		MeshTransformStats lastStats;
+
+		// Minimum number of meshes given to each thread when resolving in parallel.
+		const size_t MeshResolveBatchSize = 256;
+
+		// Merged static geometry drawn in place of the baked meshes and the counters of the last bake.
+		std::vector<Refference<Mesh>> staticBatches;
+		std::vector<BoundingBox> staticBatchBounds;
+		StaticMeshBakeStats bakeStats;
+
+		/* Mesh file and lighting a static batch is created with. */
+		struct StaticBatchMaterial
+		{
+			std::string filePath;
+			bool lit;
+		};
+
+		// Geometry of every batch kept so baked meshes can be taken back out, the material of each and the ones changed since they were created.
+		StaticMeshBatcher<Vertex> staticBatcher;
+		std::vector<StaticBatchMaterial> staticBatchMaterials;
+		std::vector<bool> staticBatchesChanged;
+		bool anyStaticBatchChanged = false;
+
+		// Culling of the meshes and batches against the camera and the counters of the last rendered frame.
+		FrustumCuller meshCuller;
+		FrustumCuller batchCuller;
+		MeshCullingStats cullingStats;
+
+		/* Vertices and indices read from a mesh file at an import scale. */
+		struct MeshGeometry
+		{
+			std::vector<Vertex> vertices;
+			std::vector<unsigned short> indices;
+		};
+
+		// Geometry of every mesh file loaded so far by file and scale, so each file is only read once and can be read ahead on other threads.
+		std::unordered_map<std::string, std::shared_ptr<const MeshGeometry>> geometryCache;
+		std::mutex geometryCacheMutex;
+
+		/* Returns the geometry of a mesh file, reading it the first time it is used at a scale. Safe to call from any thread. */
+		std::shared_ptr<const MeshGeometry> GetGeometry(const std::string& filePath, float importScale)
+		{
+			const std::string key = filePath + "|" + std::to_string(importScale);
+			{
+				std::lock_guard<std::mutex> lock(geometryCacheMutex);
+				auto cached = geometryCache.find(key);
+				if (cached != geometryCache.end()) return cached->second;
+			}
+
+			// Read without holding the lock so other meshes can still be looked up, the first of two threads reading the same file wins.
+			auto geometry = std::make_shared<MeshGeometry>();
+			Mesh::LoadGeometry(filePath, importScale, geometry->vertices, geometry->indices);
+			std::lock_guard<std::mutex> lock(geometryCacheMutex);
+			return geometryCache.emplace(key, std::move(geometry)).first->second;
+		}
+
+		/* Add an opaque draw of a mesh to a render queue keyed on what it is drawn with and the distance from the camera to its world bounds. */
+		void SubmitMesh(RenderQueue& queue, const Mesh& mesh, const BoundingBox& worldBounds, const Vector3D& cameraLocation)
+		{
+			const float depth = worldBounds.GetDistanceSquared(cameraLocation);
+			queue.Submit(RenderQueue::MakeKey(RenderPass::Opaque, mesh.GetShaderId(), mesh.GetTextureId(), mesh.GetGeometryId(), depth), &mesh);
+		}
+
+		/* Create every changed static batch on the graphics device again, batches left with no meshes are freed. */
+		void UpdateStaticBatches()
+		{
+			if (!anyStaticBatchChanged) return;
+			Graphics& graphics = Application::GetEngine().GetWindow().GetGraphics();
+			const auto& batches = staticBatcher.GetBatches();
+			staticBatches.resize(batches.size());
+			staticBatchBounds.resize(batches.size(), BoundingBox(Vector3D(0.0f), Vector3D(0.0f)));
+			for (size_t i = 0; i < batches.size(); i++)
+			{
+				if (!staticBatchesChanged[i]) continue;
+				staticBatchesChanged[i] = false;
+				if (batches[i].meshCount == 0)
+				{
+					staticBatches[i].reset();
+					continue;
+				}
+				const StaticBatchMaterial& material = staticBatchMaterials[i];
+				staticBatches[i] = CreateReff<Mesh>(graphics, material.filePath, batches[i].vertices, batches[i].indices, material.lit);
+
+				// Batches are drawn untransformed so their bounds are already in world space.
+				staticBatchBounds[i] = staticBatches[i]->GetBounds();
+			}
+			anyStaticBatchChanged = false;
+		}
+
+		/* Returns if a component and everything it is attached below is static, so it can never be moved once the level starts. */
+		bool IsStaticBranch(const SceneComponent* component)
+		{
+			for (; component; component = component->GetAttachParent())
+			{
+				if (component->GetMobility() != Mobility::Static) return false;
+			}
+			return true;
+		}
+	}
+
+	MeshComponent::MeshComponent(const std::string name) : SceneComponent(name)
+	{
+		meshTransformPending = false;
+		meshImportScale = 1.0f;
+		meshLit = false;
+		meshBounds = BoundingBox(Vector3D(0.0f), Vector3D(0.0f));
+		staticBatched = false;
+		staticBatch = StaticMeshBatcher<Vertex>::InvalidBatch;
+		staticBatchSlot = 0;
+		meshIndex = meshComponents.size();
+		meshComponents.push_back(this);
+		meshWorldBounds.push_back(meshBounds);
+	}
+
+	MeshComponent::~MeshComponent()
+	{
+		UnregisterMesh();
+	}
+
+	void MeshComponent::UnregisterMesh()
+	{
+		RemoveFromStaticBatch();
+		if (meshIndex == InvalidMeshIndex) return;
+
+		// Swap the last mesh component into this ones place.
+		meshComponents[meshIndex] = meshComponents.back();
+		meshComponents[meshIndex]->meshIndex = meshIndex;
+		meshComponents.pop_back();
+		meshWorldBounds[meshIndex] = meshWorldBounds.back();
+		meshWorldBounds.pop_back();
+		meshIndex = InvalidMeshIndex;
+
+		// Make sure an unregistered component is never resolved.
+		if (meshTransformPending)
+		{
+			pendingMeshTransforms.erase(std::remove(pendingMeshTransforms.begin(), pendingMeshTransforms.end(), this), pendingMeshTransforms.end());
+			meshTransformPending = false;
+		}
+	}
+
+	void MeshComponent::RemoveFromStaticBatch()
+	{
+		if (staticBatch == StaticMeshBatcher<Vertex>::InvalidBatch) return;
+		if (staticBatcher.Remove(staticBatch, staticBatchSlot))
+		{
+			staticBatchesChanged[staticBatch] = true;
+			anyStaticBatchChanged = true;
+		}
+		staticBatch = StaticMeshBatcher<Vertex>::InvalidBatch;
+	}
 
 	void MeshComponent::SetStaticMesh(const std::string& filePath, float importScale, bool lit)
 	{
-		// Create mesh on rendering pipeline.
-		staticMesh = CreateReff<Mesh>(Application::GetEngine().GetWindow().GetGraphics(), filePath, importScale, lit);
+		// A baked mesh given a new static mesh is drawn on its own again.
+		RemoveFromStaticBatch();
+
+		// Create mesh on rendering pipeline from the cached geometry, only reading the file if it has not been loaded before.
+		const auto geometry = GetGeometry(filePath, importScale);
+		staticMesh = CreateReff<Mesh>(Application::GetEngine().GetWindow().GetGraphics(), filePath, geometry->vertices, geometry->indices, lit,
+			filePath + "|" + std::to_string(importScale));
+		meshFilePath = filePath;
+		meshImportScale = importScale;
+		meshLit = lit;
+		meshBounds = staticMesh->GetBounds();
+		staticBatched = false;
+
+		// Start the new mesh at this components current transform and refit the owner around the new bounds.
+		TransformChanged();
+		GameObject* owner = GetOwner();
+		if (owner) owner->MarkBoundsDirty();
+	}
+
+	BoundingBox MeshComponent::GetLocalBounds() const
+	{
+		return meshBounds;
+	}
+
+	void MeshComponent::PreloadStaticMesh(const std::string& filePath, float importScale)
+	{
+		GetGeometry(filePath, importScale);
 	}
 
 	void MeshComponent::TransformChanged()
 	{
-		// Update the meshes transform matrix from this component.
-		if (staticMesh) staticMesh->SetTransform(GetWorldTransform().GetTransformAsMatrix());
+		// Baked meshes are already in world space in their batch and unregistered meshes are no longer drawn.
+		if (staticBatched || meshIndex == InvalidMeshIndex) return;
+
+		// Count every move that used to rebuild the matrix, the matrix itself is only rebuilt once when the frame is resolved.
+		currentStats.transformChanges += std::max(1u, GetTransformHierarchy().GetChangeCount(transformHandle));
+		if (!meshTransformPending)
+		{
+			meshTransformPending = true;
+			pendingMeshTransforms.push_back(this);
+		}
+	}
+
+	void MeshComponent::ResolveMeshTransforms(bool allowParallel)
+	{
+		// Make sure no world transform is dirty so the threads below only read from the hierarchy.
+		GetTransformHierarchy().UpdateWorldTransforms();
+
+		// Rebuild each moved meshes matrix once. Every mesh has its own transform so they can be resolved in any order.
+		ParallelFor(pendingMeshTransforms.size(), allowParallel ? MeshResolveBatchSize : pendingMeshTransforms.size(), [](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				MeshComponent* mesh = pendingMeshTransforms[i];
+				const Matrix4x4& worldMatrix = mesh->GetWorldTransform().GetTransformAsMatrix();
+				if (mesh->staticMesh) mesh->staticMesh->SetTransform(worldMatrix);
+				meshWorldBounds[mesh->meshIndex] = mesh->meshBounds.TransformBy(worldMatrix);
+				mesh->meshTransformPending = false;
+			}
+		});
+
+		// Store this frames counters.
+		currentStats.matrixRebuilds = (uint32_t)pendingMeshTransforms.size();
+		lastStats = currentStats;
+		currentStats = MeshTransformStats();
+		pendingMeshTransforms.clear();
+	}
+
+	void MeshComponent::GatherMeshes(RenderQueue& queue, const Matrix4x4& viewProjection, const Vector3D& cameraLocation)
+	{
+		// Cull the batches and meshes against the camera eight at a time before anything is submitted.
+		// Batches that lost a baked mesh are created again first, ones left empty have nothing to draw so are not counted.
+		UpdateStaticBatches();
+		const Frustum frustum(viewProjection);
+		cullingStats = MeshCullingStats();
+		batchCuller.Cull(frustum, staticBatchBounds.data(), staticBatchBounds.size());
+		for (size_t i = 0; i < staticBatches.size(); i++)
+		{
+			if (!staticBatches[i]) continue;
+			if (!batchCuller.IsVisible(i))
+			{
+				cullingStats.culledBatches++;
+				continue;
+			}
+			SubmitMesh(queue, *staticBatches[i], staticBatchBounds[i], cameraLocation);
+			cullingStats.visibleBatches++;
+		}
+
+		// Baked meshes and meshes without a static mesh have nothing to draw so are not counted.
+		meshCuller.Cull(frustum, meshWorldBounds.data(), meshWorldBounds.size());
+		for (size_t i = 0; i < meshComponents.size(); i++)
+		{
+			MeshComponent* mesh = meshComponents[i];
+			if (!mesh->staticMesh) continue;
+			if (!meshCuller.IsVisible(i))
+			{
+				cullingStats.culledMeshes++;
+				continue;
+			}
+			SubmitMesh(queue, *mesh->staticMesh, meshWorldBounds[i], cameraLocation);
+			cullingStats.visibleMeshes++;
+		}
+	}
+
+	const MeshCullingStats& MeshComponent::GetCullingStats()
+	{
+		return cullingStats;
+	}
+
+	void MeshComponent::BakeStaticMeshes()
+	{
+		bakeStats = StaticMeshBakeStats();
+
+		// The world transforms are baked into the vertices so make sure none are out of date.
+		GetTransformHierarchy().UpdateWorldTransforms();
+
+		// Merge each static mesh into the batch of its material. Meshes loaded from the same file with the same scale share one load.
+		std::vector<MeshComponent*> bakedMeshes;
+		for (MeshComponent* mesh : meshComponents)
+		{
+			if (!mesh->staticMesh || mesh->GetMobility() != Mobility::Static) continue;
+			if (!IsStaticBranch(mesh))
+			{
+				COMPONENT_WARNING("BakeStaticMeshes: a static mesh is attached below a movable component so is not baked.");
+				continue;
+			}
+
+			const auto geometry = GetGeometry(mesh->meshFilePath, mesh->meshImportScale);
+
+			// Textures are loaded from the meshes file and the shaders depend on if it is lit, so that makes up its material.
+			const std::string materialKey = mesh->meshFilePath + (mesh->meshLit ? "|Lit" : "|Unlit");
+			size_t slot;
+			const size_t batch = staticBatcher.Add(materialKey, geometry->vertices, geometry->indices, mesh->GetWorldTransform().GetTransformAsMatrix(), &slot);
+			if (batch == StaticMeshBatcher<Vertex>::InvalidBatch) continue;
+			if (batch == staticBatchMaterials.size()) staticBatchMaterials.push_back({ mesh->meshFilePath, mesh->meshLit });
+			staticBatchesChanged.resize(staticBatchMaterials.size(), false);
+			staticBatchesChanged[batch] = true;
+			anyStaticBatchChanged = true;
+			mesh->staticBatch = batch;
+			mesh->staticBatchSlot = slot;
+			bakedMeshes.push_back(mesh);
+		}
+
+		// Create each changed batch on the graphics device then free the buffers of the meshes they replace.
+		UpdateStaticBatches();
+		for (MeshComponent* mesh : bakedMeshes)
+		{
+			mesh->staticMesh.reset();
+			mesh->staticBatched = true;
+		}
+		bakeStats.bakedMeshes = (uint32_t)bakedMeshes.size();
+		for (const auto& batch : staticBatches) bakeStats.batches += batch ? 1 : 0;
+	}
+
+	void MeshComponent::ReleaseStaticMeshes()
+	{
+		// Meshes still registered are left out of the batches so they do not take their geometry out of a later bake.
+		for (MeshComponent* mesh : meshComponents) mesh->staticBatch = StaticMeshBatcher<Vertex>::InvalidBatch;
+		staticBatches.clear();
+		staticBatchBounds.clear();
+		staticBatcher.Clear();
+		staticBatchMaterials.clear();
+		staticBatchesChanged.clear();
+		anyStaticBatchChanged = false;
+		bakeStats = StaticMeshBakeStats();
+	}
+
+	const StaticMeshBakeStats& MeshComponent::GetStaticBakeStats()
+	{
+		return bakeStats;
+	}
+
+	const MeshTransformStats& MeshComponent::GetTransformStats()
+	{
+		return lastStats;
 	}
 
 	void MeshComponent::LevelStart()
@@ -28,7 +361,6 @@ namespace ReeeEngine
 	{
 		SceneComponent::Tick(deltaTime);
 
-		// Render static mesh...
-		if (staticMesh) staticMesh->Render(Application::GetEngine().GetWindow().GetGraphics());
+		// Rendering is done by the world once every transform of the frame is resolved.
 	}
 }
\ No newline at end of file
@@ -2,9 +2,49 @@
 #include "SceneComponent.h"
 #include "../../Globals.h"
 #include "../../Rendering/Renderables/Mesh.h"
+#include "../../Rendering/RenderQueue.h"
 
 namespace ReeeEngine
 {
+	/* Counters of how many mesh matrix rebuilds the deferred transform resolve saved in a frame. */
+	struct MeshTransformStats
+	{
+		// Times a mesh was moved, by itself or a parent. Each of these used to rebuild the meshes matrix straight away.
+		uint32_t transformChanges = 0;
+
+		// Mesh matrices actually rebuilt, at most once per mesh per frame.
+		uint32_t matrixRebuilds = 0;
+
+		/* Returns the number of matrix rebuilds that were skipped. */
+		uint32_t GetSavedRebuilds() const
+		{
+			return transformChanges > matrixRebuilds ? transformChanges - matrixRebuilds : 0;
+		}
+	};
+
+	/* Counters of the static meshes merged by the last BakeStaticMeshes. */
+	struct StaticMeshBakeStats
+	{
+		// Static meshes merged into batches, each of these used to be drawn on its own.
+		uint32_t bakedMeshes = 0;
+
+		// Merged batches drawn in their place, one per material unless a material has too many vertices for one batch.
+		// Counts every batch still holding a mesh, including ones from earlier bakes.
+		uint32_t batches = 0;
+	};
+
+	/* Counters of the meshes and static batches culled against the camera in the last rendered frame. */
+	struct MeshCullingStats
+	{
+		// Meshes drawn and meshes skipped for being off screen.
+		uint32_t visibleMeshes = 0;
+		uint32_t culledMeshes = 0;
+
+		// Merged static batches drawn and skipped.
+		uint32_t visibleBatches = 0;
+		uint32_t culledBatches = 0;
+	};
+
 	/* Component that can pass rendering information to the Direct3D pipeline. */
 	class REEE_API MeshComponent : public SceneComponent
 	{
@@ -12,14 +52,57 @@ namespace ReeeEngine
 
 		/* Default constructor/destructor. */
 		MeshComponent(const std::string name);
-		~MeshComponent() = default;
+		~MeshComponent();
 
 		/* Static mesh setting/initialization function. */
 		void SetStaticMesh(const std::string& filePath, float importScale = 1.0f, bool lit = false);
 
-		/* Override transform change call to update mesh. */
+		/* Stop this mesh being culled and drawn, taking it out of its static batch if it was baked.
+		 * Ran when its owner is removed from its world as something else can still hold onto it. */
+		void UnregisterMesh();
+
+		/* Read a mesh files geometry ahead of time so setting it as a static mesh later does not have to.
+		 * NOTE: Safe to call from any thread, e.g. by the level streamer while a level is read in the background. */
+		static void PreloadStaticMesh(const std::string& filePath, float importScale = 1.0f);
+
+		/* Returns the bounds of the static mesh, a point at the origin until one is set. */
+		virtual BoundingBox GetLocalBounds() const override;
+
+		/* Override transform change call to queue the meshes matrix to be rebuilt by ResolveMeshTransforms. */
 		virtual void TransformChanged() override;
 
+		/* Rebuild the matrix of every mesh moved since the last call once, splitting the meshes across threads when there are enough.
+		 * NOTE: Ran by the world after every object has ticked and before the meshes are rendered. */
+		static void ResolveMeshTransforms(bool allowParallel = true);
+
+		/* Submit a draw to the render queue for the merged static batches and every mesh component that still has its own static mesh,
+		 * skipping anything whose world bounds are outside the frustum of the view * projection matrix. Draws are keyed on their shaders,
+		 * texture, geometry and distance from the camera location.
+		 * NOTE: Ran by the world after the transforms are resolved, the queue is sorted and drawn after every mesh is gathered. */
+		static void GatherMeshes(RenderQueue& queue, const Matrix4x4& viewProjection, const Vector3D& cameraLocation);
+
+		/* Returns the counters of the last GatherMeshes. */
+		static const MeshCullingStats& GetCullingStats();
+
+		/* Merge every static mesh whose parents are all static into batches of meshes sharing a material, moved into world space.
+		 * The batches are drawn in place of the meshes, which free their own buffers. Meshes baked earlier stay in their batches.
+		 * NOTE: Ran by the world at level start before static transforms are locked.
+		 *       The merged geometry is kept so a baked mesh that is unregistered can be taken back out, its batch is created again
+		 *       on the graphics device the next time the meshes are gathered. */
+		static void BakeStaticMeshes();
+
+		/* Free the merged static batches so they are no longer drawn, ran when the world they were baked for is destroyed. */
+		static void ReleaseStaticMeshes();
+
+		/* Returns the counters of the last BakeStaticMeshes. */
+		static const StaticMeshBakeStats& GetStaticBakeStats();
+
+		/* Returns if this mesh is drawn as part of a merged static batch. */
+		bool IsStaticBatched() const { return staticBatched; }
+
+		/* Returns the counters of the last ResolveMeshTransforms. */
+		static const MeshTransformStats& GetTransformStats();
+
 		/* Level start function. */
 		virtual void LevelStart() override;
 
@@ -30,5 +113,28 @@ namespace ReeeEngine
 
 		// Pointer to the static mesh held under this component.
 		Refference<Mesh> staticMesh;
+
+		// Settings the static mesh was loaded with, used to load it again when it is baked.
+		std::string meshFilePath;
+		float meshImportScale;
+		bool meshLit;
+
+		// Bounds of the static meshes vertices in this components space.
+		BoundingBox meshBounds;
+
+		// If this mesh has been merged into a static batch, the batch and the slot its geometry was added at.
+		bool staticBatched;
+		size_t staticBatch;
+		size_t staticBatchSlot;
+
+		// Index of this component in the list of every mesh component, used to remove it without searching. Invalid once unregistered.
+		size_t meshIndex;
+		static constexpr size_t InvalidMeshIndex = ~size_t(0);
+
+		// If this meshes matrix is queued to be rebuilt by ResolveMeshTransforms.
+		bool meshTransformPending;
+
+		/* Take this meshes geometry out of the static batch it was baked into, if it is still in one. */
+		void RemoveFromStaticBatch();
 	};
 }
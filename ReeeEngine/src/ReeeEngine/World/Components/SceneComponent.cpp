@@ -1,10 +1,26 @@
 #include "SceneComponent.h"
+#include "../Core/GameObject.h"
 
 namespace ReeeEngine
 {
+	namespace
+	{
+		// Number of changed scene components needed before world transforms are updated across the shared worker pool, 0 to
+		// always use the serial sweep. Off by default as walking each root subtree costs more than the linear sweep.
+		size_t parallelTransformUpdateCount = 0;
+	}
+
 	SceneComponent::SceneComponent(const std::string componentName) : Component(componentName)
 	{
-		attachParent = nullptr;
+		transformHandle = GetTransformHierarchy().Add(this);
+		mobility = Mobility::Movable;
+		transformLocked = false;
+	}
+
+	SceneComponent::~SceneComponent()
+	{
+		// Detaches from the parent and leaves any children where they are in the world as new roots.
+		GetTransformHierarchy().Remove(transformHandle);
 	}
 
 	void SceneComponent::LevelStart()
@@ -21,57 +37,84 @@ namespace ReeeEngine
 		//...
 	}
 
+	bool SceneComponent::CanEverTick() const
+	{
+		return mobility != Mobility::Static && Component::CanEverTick();
+	}
+
+	void SceneComponent::SetMobility(Mobility newMobility)
+	{
+		COMPONENT_CHECK_RETURN((!transformLocked), "SetMobility: mobility cannot be changed once the level has started.");
+		mobility = newMobility;
+	}
+
+	void SceneComponent::LockTransform()
+	{
+		transformLocked = true;
+	}
+
+	bool SceneComponent::IsTransformLocked() const
+	{
+		return transformLocked && mobility == Mobility::Static;
+	}
+
 	SceneComponent* SceneComponent::GetAttachParent() const
 	{
-		return attachParent;
+		TransformHierarchy& hierarchy = GetTransformHierarchy();
+		return hierarchy.GetOwner(hierarchy.GetParent(transformHandle));
 	}
 
 	void SceneComponent::AddChild(SceneComponent* child)
 	{
 		COMPONENT_CHECK_RETURN(child, "AddChild: child is null cannot add returning...");
-		childrenComponents.push_back(child);
+		COMPONENT_CHECK_RETURN((!child->IsTransformLocked()), "AddChild: cannot move a static component once the level has started.");
+
+		// Attach keeping the childs relative transform.
+		const bool attached = GetTransformHierarchy().Attach(child->transformHandle, transformHandle);
+		COMPONENT_CHECK_RETURN(attached, "AddChild: cannot add a component that this component is attached below.");
 	}
 
 	void SceneComponent::RemoveChild(SceneComponent* child)
 	{
 		COMPONENT_CHECK_RETURN(child, "RemoveChild: child is null cannot remove returning...");
-		
-		// Find child and remove from array if it is there.
-		auto it = std::find(childrenComponents.begin(), childrenComponents.end(), child);
-		if (it != childrenComponents.end()) 
-		{ 
-			childrenComponents.erase(it); 
+
+		// Remove the child if it is attached to this component, leaving it where it is in the world.
+		TransformHierarchy& hierarchy = GetTransformHierarchy();
+		if (hierarchy.GetParent(child->transformHandle) == transformHandle)
+		{
+			const Transform childWorldTransform = hierarchy.GetWorld(child->transformHandle);
+			hierarchy.Detach(child->transformHandle);
+			hierarchy.SetLocal(child->transformHandle, childWorldTransform);
 		}
 	}
 
 	void SceneComponent::AttachToComponent(SceneComponent* newParent, const AttachProperties& props)
 	{
 		COMPONENT_CHECK_RETURN(newParent, "AttachToComponent: newParent is null cannot attach.");
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "AttachToComponent: cannot move a static component once the level has started.");
 
-		// If already attached clear old parent and remove child from children list.
-		if (attachParent)
-		{
-			attachParent->RemoveChild(this);
-			attachParent = nullptr;
-		}
+		// Attaching to this component or anything below it would create a loop.
+		TransformHierarchy& hierarchy = GetTransformHierarchy();
+		COMPONENT_CHECK_RETURN((!hierarchy.IsAncestorOf(transformHandle, newParent->transformHandle)), "AttachToComponent: cannot attach a component to itself or one of its children.");
 
-		// Set new attach parent.
-		attachParent = newParent;
+		// Keep the current world transform so the attachment rules can be applied to it.
+		const Transform oldWorldTransform = GetWorldTransform();
 
-		// Add to children list of parent.
-		newParent->AddChild(this);
+		// Work out the new relative transform of every channel first so the move below only dirties and notifies once.
+		// Start from keeping the world transform, the rules below then change what they need to.
+		Transform newRelativeTransform = oldWorldTransform.GetRelativeTo(newParent->GetWorldTransform());
 
 		// Setup location rules.
 		switch (props.locationRule)
 		{
 			case AttachmentRule::AttachRelative:
 			{
-				SetRelativeLocation(GetWorldLocation());
+				newRelativeTransform.SetLocation(oldWorldTransform.GetLocation());
 				break;
 			}
 			case AttachmentRule::Snap:
 			{
-				SetWorldLocation(newParent->GetWorldLocation());
+				newRelativeTransform.SetLocation(Vector3D(0.0f));
 				break;
 			}
 		}
@@ -81,12 +124,12 @@ namespace ReeeEngine
 		{
 			case AttachmentRule::AttachRelative:
 			{
-				SetRelativeRotation(GetWorldRotation());
+				newRelativeTransform.SetRotation(oldWorldTransform.GetRotation());
 				break;
 			}
 			case AttachmentRule::Snap:
 			{
-				SetWorldRotation(newParent->GetWorldRotation());
+				newRelativeTransform.SetRotation(Rotator(0.0f));
 				break;
 			}
 		}
@@ -96,200 +139,198 @@ namespace ReeeEngine
 		{
 			case AttachmentRule::AttachRelative:
 			{
-				SetRelativeScale(GetWorldScale());
+				newRelativeTransform.SetScale(oldWorldTransform.GetScale());
 				break;
 			}
 			case AttachmentRule::Snap:
 			{
-				SetWorldScale(newParent->GetWorldScale());
+				newRelativeTransform.SetScale(Vector3D(1.0f));
 				break;
 			}
 		}
+
+		// Move to the new parent, which also detaches from any old parent, then apply the new relative transform.
+		hierarchy.Attach(transformHandle, newParent->transformHandle);
+		hierarchy.SetLocal(transformHandle, newRelativeTransform);
 	}
 
-	void SceneComponent::InitNewLocation(const Vector3D& change)
+	void SceneComponent::MarkTransformDirty()
 	{
-		for (auto it = childrenComponents.begin(); it != childrenComponents.end(); ++it)
-		{
-			// Update childrens world location from change.
-			SceneComponent* currComp = *it;
-			currComp->SetWorldLocation(change, true);
-		}
-		TransformChanged();
+		GetTransformHierarchy().MarkDirty(transformHandle);
+	}
+
+	bool SceneComponent::IsTransformDirty() const
+	{
+		return GetTransformHierarchy().IsDirty(transformHandle);
 	}
 
-	void SceneComponent::InitNewRotation(const Rotator& change)
+	void SceneComponent::FlushTransformChanges()
 	{
-		for (auto it = childrenComponents.begin(); it != childrenComponents.end(); ++it)
+		// Update every world transform in one pass so notified components don't resolve their parents one at a time.
+		TransformHierarchy& hierarchy = GetTransformHierarchy();
+		WorkerPool& pool = WorkerPool::GetShared();
+		const bool updateInParallel = parallelTransformUpdateCount > 0 && hierarchy.GetChangedCount() >= parallelTransformUpdateCount && pool.GetThreadCount() > 1;
+		if (updateInParallel) hierarchy.UpdateWorldTransformsParallel(pool);
+		else hierarchy.UpdateWorldTransforms();
+		hierarchy.ConsumeChanged([&hierarchy](TransformHierarchy::Handle handle)
 		{
-			// Update childrens components rotations from rotation change in this parent.
-			SceneComponent* currComp = *it;
-			currComp->SetWorldRotation(change, true);
+			SceneComponent* component = hierarchy.GetOwner(handle);
+			if (component) component->NotifyTransformChanged();
+		});
+	}
 
-			// Update new world positions after a rotation is applied to the children.
-			currComp->SetRelativeLocation(currComp->GetRelativeLocation());
-		}
-		TransformChanged();
+	void SceneComponent::SetParallelTransformUpdateCount(size_t changedCount)
+	{
+		parallelTransformUpdateCount = changedCount;
 	}
 
-	void SceneComponent::InitNewScale(const Vector3D& change)
+	void SceneComponent::FlushTransformChange()
+	{
+		if (GetTransformHierarchy().ConsumeChanged(transformHandle)) NotifyTransformChanged();
+	}
+
+	void SceneComponent::NotifyTransformChanged()
 	{
-		for (auto it = childrenComponents.begin(); it != childrenComponents.end(); ++it)
-		{
-			// Update childrens world scale from change.
-			SceneComponent* currComp = *it;
-			currComp->SetWorldScale(change, true);
-		}
 		TransformChanged();
+
+		// The owners bounds are made from its scene components so have to be refit in its worlds spatial index.
+		GameObject* owner = GetOwner();
+		if (owner) owner->MarkBoundsDirty();
+	}
+
+	TransformHierarchy& SceneComponent::GetTransformHierarchy()
+	{
+		static TransformHierarchy hierarchy;
+		return hierarchy;
 	}
 
 	Vector3D SceneComponent::GetWorldLocation() const
 	{
-		return transform.GetLocation();
+		return GetWorldTransform().GetLocation();
 	}
 
 	Vector3D SceneComponent::GetRelativeLocation() const
 	{
-		// Return the relative transform to the attach parent if there is one.
-		if (attachParent)
-		{
-			return relativeTransform.GetLocation();
-		}
-		// If there is no parent just return the world location...
-		else return transform.GetLocation();
+		return GetTransformHierarchy().GetLocal(transformHandle).GetLocation();
 	}
 
 	void SceneComponent::SetWorldLocation(const Vector3D& newLocation, bool addToCurrent)
 	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetWorldLocation: cannot move a static component once the level has started.");
 		if (addToCurrent && newLocation.IsZero()) return;
-		const Vector3D newLoc = addToCurrent ? transform.GetLocation() + newLocation : newLocation;
-		const Vector3D diff = newLoc - GetWorldLocation();
-		transform.SetLocation(newLoc);
-		InitNewLocation(diff);
+		const Vector3D newLoc = addToCurrent ? GetWorldLocation() + newLocation : newLocation;
+
+		// Store the location relative to the parent.
+		const SceneComponent* attachParent = GetAttachParent();
+		const Vector3D newRelativeLoc = attachParent ? attachParent->GetWorldTransform().InverseTransformPosition(newLoc) : newLoc;
+		GetTransformHierarchy().EditLocal(transformHandle).SetLocation(newRelativeLoc);
 	}
 
 	void SceneComponent::SetRelativeLocation(const Vector3D& newRelativeLocation, bool addToCurrent)
 	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetRelativeLocation: cannot move a static component once the level has started.");
 		if (addToCurrent && newRelativeLocation.IsZero()) return;
-		if (attachParent)
-		{
-			// Get new relative location in terms of the parents rotation.
-			const Vector3D relativeOffset = addToCurrent ? relativeTransform.GetLocation() + newRelativeLocation : newRelativeLocation;
-			DirectX::XMVECTOR newRelVector = DirectX::XMLoadFloat3(&relativeOffset.ToFloat3());
-			Rotator parentRotation = attachParent->GetWorldRotation().ToRadians();
-			DirectX::XMVECTOR parentRotationVec = DirectX::XMQuaternionRotationRollPitchYaw(parentRotation.Pitch, parentRotation.Yaw, parentRotation.Roll);
-			DirectX::XMVECTOR relativeWithRot = DirectX::XMVector3Rotate(newRelVector, parentRotationVec);
-
-			// Get readable relative location with rotation.
-			DirectX::XMFLOAT3 rotatedRelativeLocation;
-			DirectX::XMStoreFloat3(&rotatedRelativeLocation, relativeWithRot);
-
-			// Get new relative location and set the relative transform...
-			Vector3D relativeWorldLocation = Vector3D(rotatedRelativeLocation.x, rotatedRelativeLocation.y, rotatedRelativeLocation.z);
-			relativeTransform.SetLocation(relativeOffset);
-			SetWorldLocation(attachParent->GetWorldLocation() + relativeWorldLocation);
-		}
-		else
-		{
-			// If theres no parent just update world location.
-			SetWorldLocation(newRelativeLocation, addToCurrent);
-		}
+		Transform& relativeTransform = GetTransformHierarchy().EditLocal(transformHandle);
+		relativeTransform.SetLocation(addToCurrent ? relativeTransform.GetLocation() + newRelativeLocation : newRelativeLocation);
 	}
 
 	Rotator SceneComponent::GetWorldRotation() const
 	{
-		return transform.GetRotation();
+		return GetWorldTransform().GetRotation();
 	}
 
 	Rotator SceneComponent::GetRelativeRotation() const
 	{
-		// Return world rotation if relative doesn't exist.
-		return attachParent ? relativeTransform.GetRotation() : transform.GetRotation();
+		return GetTransformHierarchy().GetLocal(transformHandle).GetRotation();
 	}
 
 	void SceneComponent::SetWorldRotation(const Rotator& newRotation, bool addToCurrent)
 	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetWorldRotation: cannot move a static component once the level has started.");
 		if (addToCurrent && newRotation.IsZero()) return;
-		const Rotator newRot = addToCurrent ? transform.GetRotation() + newRotation : newRotation;
-		const Rotator diff = newRot - GetWorldRotation();
-		transform.SetRotation(newRot);
-		InitNewRotation(diff);
+		const Rotator newRot = addToCurrent ? GetWorldRotation() + newRotation : newRotation;
+
+		// Remove the parents rotation with quaternions so the rotator of a root component stays exactly as given.
+		const SceneComponent* attachParent = GetAttachParent();
+		if (attachParent)
+		{
+			const Quat newRelativeQuat = (Quat::FromRotator(newRot) * attachParent->GetWorldTransform().GetQuaternion().GetInverse()).GetNormal();
+			GetTransformHierarchy().EditLocal(transformHandle).SetQuaternion(newRelativeQuat);
+		}
+		else GetTransformHierarchy().EditLocal(transformHandle).SetRotation(newRot);
 	}
 
 	void SceneComponent::SetRelativeRotation(const Rotator& newRelativeRotation, bool addToCurrent)
 	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetRelativeRotation: cannot move a static component once the level has started.");
 		if (addToCurrent && newRelativeRotation.IsZero()) return;
-		if (attachParent)
-		{
-			// Set world rotation from relative.
-			Rotator relativeOffset = addToCurrent ? relativeTransform.GetRotation() + newRelativeRotation : newRelativeRotation;
-			relativeTransform.SetRotation(relativeOffset);
-			SetWorldRotation(attachParent->GetWorldRotation() + relativeOffset);
-		}
-		else
-		{
-			// If there is no parent just set world rotation instead.
-			SetWorldRotation(newRelativeRotation, addToCurrent);
-		}
+		Transform& relativeTransform = GetTransformHierarchy().EditLocal(transformHandle);
+		relativeTransform.SetRotation(addToCurrent ? relativeTransform.GetRotation() + newRelativeRotation : newRelativeRotation);
 	}
 
 	Vector3D SceneComponent::GetWorldScale() const
 	{
-		return transform.GetScale();
+		return GetWorldTransform().GetScale();
 	}
 
 	Vector3D SceneComponent::GetRelativeScale() const
 	{
-		// Return world scale if relative doesn't exist.
-		return attachParent ? (transform.GetScale() - attachParent->GetWorldTransform().GetScale()) : transform.GetScale();
+		return GetTransformHierarchy().GetLocal(transformHandle).GetScale();
 	}
 
 	void SceneComponent::SetWorldScale(const Vector3D& newScale, bool addToCurrent)
 	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetWorldScale: cannot move a static component once the level has started.");
 		if (addToCurrent && newScale.IsZero()) return;
-		const Vector3D newS = addToCurrent ? transform.GetScale() + newScale : newScale;
-		const Vector3D diff = newS - GetWorldScale();
-		transform.SetScale(newS);
-		InitNewScale(diff);
+		const Vector3D newS = addToCurrent ? GetWorldScale() + newScale : newScale;
+
+		// Divide out the parents scale.
+		const SceneComponent* attachParent = GetAttachParent();
+		if (attachParent)
+		{
+			Transform newWorld = GetWorldTransform();
+			newWorld.SetScale(newS);
+			const Vector3D newRelativeScale = newWorld.GetRelativeTo(attachParent->GetWorldTransform()).GetScale();
+			GetTransformHierarchy().EditLocal(transformHandle).SetScale(newRelativeScale);
+		}
+		else GetTransformHierarchy().EditLocal(transformHandle).SetScale(newS);
 	}
 
 	void SceneComponent::SetRelativeScale(const Vector3D& newRelativeScale, bool addToCurrent)
 	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetRelativeScale: cannot move a static component once the level has started.");
 		if (addToCurrent && newRelativeScale.IsZero()) return;
-		if (attachParent)
-		{
-			// Set world scale from relative.
-			SetWorldScale(GetRelativeScale() + newRelativeScale, addToCurrent);
-		}
-		else
-		{
-			// Set the world scale if there is no parent comp.
-			SetWorldScale(newRelativeScale, addToCurrent);
-		}
+		Transform& relativeTransform = GetTransformHierarchy().EditLocal(transformHandle);
+		relativeTransform.SetScale(addToCurrent ? relativeTransform.GetScale() + newRelativeScale : newRelativeScale);
 	}
 
-	Transform SceneComponent::GetWorldTransform() const
+	const Transform& SceneComponent::GetWorldTransform() const
 	{
-		return transform;
+		// Only rebuilt from the parents if this or one of them has moved since it was last asked for.
+		return GetTransformHierarchy().GetWorld(transformHandle);
 	}
 
 	Transform SceneComponent::GetRelativeTransform() const
 	{
-		return Transform(GetRelativeLocation(), GetRelativeRotation(), GetRelativeScale());
+		return GetTransformHierarchy().GetLocal(transformHandle);
 	}
 
 	void SceneComponent::SetWorldTransform(const Transform& newTransform)
 	{
-		SetWorldLocation(newTransform.GetLocation());
-		SetWorldRotation(newTransform.GetRotation());
-		SetWorldScale(newTransform.GetScale());
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetWorldTransform: cannot move a static component once the level has started.");
+		GetTransformHierarchy().SetWorld(transformHandle, newTransform);
 	}
 
 	void SceneComponent::SetRelativeTransform(const Transform& newRelativeTransform)
 	{
-		SetRelativeLocation(newRelativeTransform.GetLocation());
-		SetRelativeRotation(newRelativeTransform.GetRotation());
-		SetRelativeScale(newRelativeTransform.GetScale());
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetRelativeTransform: cannot move a static component once the level has started.");
+		GetTransformHierarchy().SetLocal(transformHandle, newRelativeTransform);
+	}
+
+	void SceneComponent::SetWorldLocationAndRotation(const Vector3D& newLocation, const Rotator& newRotation)
+	{
+		COMPONENT_CHECK_RETURN((!IsTransformLocked()), "SetWorldLocationAndRotation: cannot move a static component once the level has started.");
+		GetTransformHierarchy().SetWorld(transformHandle, Transform(newLocation, newRotation, GetWorldScale()));
 	}
 
 	void SceneComponent::TransformChanged()
@@ -297,13 +338,31 @@ namespace ReeeEngine
 		//...
 	}
 
+	BoundingBox SceneComponent::GetLocalBounds() const
+	{
+		return BoundingBox(Vector3D(0.0f), Vector3D(0.0f));
+	}
+
+	BoundingBox SceneComponent::GetWorldBounds() const
+	{
+		return GetLocalBounds().TransformBy(GetWorldTransform().GetTransformAsMatrix());
+	}
+
 	std::vector<SceneComponent*> SceneComponent::GetChildren() const
 	{
-		return childrenComponents;
+		// Walk the childrens sibling links in the hierarchy.
+		TransformHierarchy& hierarchy = GetTransformHierarchy();
+		std::vector<SceneComponent*> children;
+		children.reserve(hierarchy.GetChildCount(transformHandle));
+		for (TransformHierarchy::Handle child = hierarchy.GetFirstChild(transformHandle); child != TransformHierarchy::InvalidHandle; child = hierarchy.GetNextSibling(child))
+		{
+			children.push_back(hierarchy.GetOwner(child));
+		}
+		return children;
 	}
 
 	int SceneComponent::GetChildrenNum() const
 	{
-		return childrenComponents.size();
+		return (int)GetTransformHierarchy().GetChildCount(transformHandle);
 	}
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "Component.h"
 #include "../../Math/ReeeMath.h"
 #include "../../Math/Transform.h"
+#include "../../Math/Bounds.h"
+#include "../Core/TransformHierarchy.h"
 #include "../../ReeeLog.h"
 
 /* Helper window macros for throwing errors into the log and stopping code execution. */
@@ -17,6 +19,13 @@ namespace ReeeEngine
 		Snap			// Snap the component to the new parent components world (0,0,0)
 	};
 
+	/* How a scene component can move once the level has started. */
+	enum class Mobility
+	{
+		Movable,	// Can be moved at any time.
+		Static		// Placed before the level starts and never moved again. Static meshes are merged into batches and static components are not ticked.
+	};
+
 	/* Attachment properties for attaching a component to a new parent. 
 	 * Note: by default it keeps all current world positions. */
 	struct AttachProperties
@@ -42,7 +51,7 @@ namespace ReeeEngine
 
 		/* Setup default component. */
 		SceneComponent(const std::string componentName);
-		~SceneComponent() = default;
+		~SceneComponent();
 
 		/* Level start function. */
 		virtual void LevelStart() override;
@@ -50,6 +59,20 @@ namespace ReeeEngine
 		/* Ticking function. */
 		virtual void Tick(float DeltaTime) override;
 
+		/* Static components have nothing to update so are never registered to be ticked. */
+		virtual bool CanEverTick() const override;
+
+		/* Mobility getter and setter.
+		 * NOTE: Can only be changed before the level starts. */
+		Mobility GetMobility() const { return mobility; }
+		void SetMobility(Mobility newMobility);
+
+		/* Stop this component changing mobility and, if it is static, being moved. Ran by its world once the level has started. */
+		void LockTransform();
+
+		/* Returns if this component is static and its worlds level has started, so it can no longer be moved. */
+		bool IsTransformLocked() const;
+
 		/* Add and remove function for children components attached to this component. */
 		void AddChild(SceneComponent* child);
 		void RemoveChild(SceneComponent* child);
@@ -58,10 +81,28 @@ namespace ReeeEngine
 		class SceneComponent* GetAttachParent() const;
 		void AttachToComponent(SceneComponent* newParent, const AttachProperties& props = AttachProperties());
 
-		/* Recursive positioning functions for updating attachment position/rotation/scale hierarchy. */
-		void InitNewLocation(const Vector3D& change);
-		void InitNewRotation(const Rotator& change);
-		void InitNewScale(const Vector3D& change);
+		/* Flag the cached world transform of this component and everything attached below it as out of date.
+		 * NOTE: Stops at children that are already dirty as their own children are always dirty too. */
+		void MarkTransformDirty();
+
+		/* Returns if the world transform needs to be recalculated before it is next used. */
+		bool IsTransformDirty() const;
+
+		/* Update every dirty world transform in one sweep then call TransformChanged once on every component whose transform
+		 * changed since the last call.
+		 * NOTE: Ran by the world at the end of each frame so many moves in a frame only notify once. */
+		static void FlushTransformChanges();
+
+		/* Set how many scene components have to change in a frame before FlushTransformChanges updates them across the shared
+		 * worker pool, 0 to always update serially which is the default.
+		 * NOTE: Measure with the TransformHierarchy benchmarks on the target hardware before turning this on. */
+		static void SetParallelTransformUpdateCount(size_t changedCount);
+
+		/* Returns the hierarchy holding the transforms of every scene component. */
+		static TransformHierarchy& GetTransformHierarchy();
+
+		/* Returns this components handle in the transform hierarchy. */
+		TransformHierarchy::Handle GetTransformHandle() const { return transformHandle; }
 
 		/* Location manipulation functions. */
 		Vector3D GetWorldLocation() const;
@@ -81,15 +122,23 @@ namespace ReeeEngine
 		void SetWorldScale(const Vector3D& newScale, bool addToCurrent = false);
 		void SetRelativeScale(const Vector3D& newRelativeScale, bool addToCurrent = false);
 
-		/* Transform manipulation functions. */
-		Transform GetWorldTransform() const;
+		/* Transform manipulation functions.
+		 * NOTE: These set every channel at once so this component and its children are only marked dirty and notified once. */
+		const Transform& GetWorldTransform() const;
 		Transform GetRelativeTransform() const;
 		void SetWorldTransform(const Transform& newTransform);
 		void SetRelativeTransform(const Transform& newRelativeTransform);
+		void SetWorldLocationAndRotation(const Vector3D& newLocation, const Rotator& newRotation);
 
 		/* Virtual overridable function for updating any unattached subcomponents from the transform of this scene component. */
 		virtual void TransformChanged();
 
+		/* Returns the bounds of what this component draws or collides with in its own space, a point at its origin by default. */
+		virtual BoundingBox GetLocalBounds() const;
+
+		/* Returns the local bounds moved into world space by this components world transform. */
+		BoundingBox GetWorldBounds() const;
+
 		/* Get vector array of attached children components. */
 		std::vector<SceneComponent*> GetChildren() const;
 
@@ -98,16 +147,19 @@ namespace ReeeEngine
 
 	protected:
 
-		// The scene component this component is attached to.
-		SceneComponent* attachParent;
+		/* Send this components pending TransformChanged now if it has one, e.g. just before it is rendered. */
+		void FlushTransformChange();
+
+		/* Call TransformChanged and queue the owners bounds to be refit in its worlds spatial index. */
+		void NotifyTransformChanged();
 
-		// Vector array of children components attached to this component.
-		std::vector<SceneComponent*> childrenComponents;
+		// Handle of this components node in the transform hierarchy, which holds its parent, children and transforms.
+		TransformHierarchy::Handle transformHandle;
 
-		// The components world transform.
-		Transform transform;
+		// If this component can move after the level has started.
+		Mobility mobility;
 
-		// The components relative transform to its attachParent if it has one.
-		Transform relativeTransform;
+		// If the level of the world this component is in has started, so its mobility is fixed.
+		bool transformLocked;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,462 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+#include <type_traits>
+#include <typeinfo>
+#include <algorithm>
+
+namespace ReeeEngine
+{
+	/* Archetype based store of entities and the components they are made of.
+	 * Entities with the same set of component types share an archetype, which keeps each component type in its own array
+	 * inside fixed size chunks. Queries walk those arrays in order so updating thousands of entities reads contiguous memory
+	 * with no virtual calls. Removing an entity moves the last entity of its archetype into its place so the arrays stay packed.
+	 * Component types are numbered by each store in the order it first sees them, looked up by a key made from the types name
+	 * so the engine and the game modules agree on the index of a type even though each has its own copy of the templates.
+	 * NOTE: Components are moved between chunks with memcpy so have to be trivially copyable, at most 64 types can be used per store.
+	 *       Entities can not be created, destroyed or have components added or removed while a query is running. */
+	class EntityStore
+	{
+	public:
+
+		// Index of a component type in a store.
+		typedef uint32_t ComponentType;
+
+		// Key of a component type that is the same in every module.
+		typedef uint64_t ComponentTypeKey;
+
+		// One bit per component type an entity or query uses.
+		typedef uint64_t Signature;
+		static constexpr size_t MaxComponentTypes = 64;
+
+		// Index used by entities that do not exist.
+		static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+		// Bytes of component data each chunk holds.
+		static constexpr size_t ChunkBytes = 16 * 1024;
+
+		/* Handle to an entity. The generation changes every time an index is reused so handles to destroyed entities stay invalid. */
+		struct Entity
+		{
+			uint32_t index = InvalidIndex;
+			uint32_t generation = 0;
+
+			bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+			bool operator!=(const Entity& other) const { return !(*this == other); }
+		};
+
+		// Type index returned for component types a store has not seen yet.
+		static constexpr ComponentType InvalidComponentType = 0xFFFFFFFFu;
+
+		/* Returns the key of a component type, a hash of its name so every module computes the same one. */
+		template<class T>
+		static ComponentTypeKey GetComponentTypeKey()
+		{
+			static const ComponentTypeKey key = HashTypeName(typeid(T).name());
+			return key;
+		}
+
+		/* Returns the index of a component type in this store, registering it the first time it is used. */
+		template<class T>
+		ComponentType GetComponentType()
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Entity components have to be trivially copyable.");
+			static_assert(alignof(T) <= alignof(ChunkBlock), "Entity components can not be aligned to more than a chunk block.");
+			const ComponentTypeKey key = GetComponentTypeKey<T>();
+			const ComponentType type = FindComponentType(key);
+			if (type != InvalidComponentType)
+			{
+				assert("Two component types share a name." && typeInfos[type].size == sizeof(T) && typeInfos[type].alignment == alignof(T));
+				return type;
+			}
+			return RegisterComponentType(key, sizeof(T), alignof(T));
+		}
+
+		/* Returns the index of a component type in this store or InvalidComponentType if it has not been used with it. */
+		template<class T>
+		ComponentType FindComponentType() const
+		{
+			return FindComponentType(GetComponentTypeKey<T>());
+		}
+
+		/* Returns the signature of a set of component types, registering any this store has not seen yet. */
+		template<class... T>
+		Signature GetSignature()
+		{
+			return (Signature(0) | ... | (Signature(1) << GetComponentType<T>()));
+		}
+
+		/* Returns the number of component types used with this store. */
+		size_t GetComponentTypeCount() const
+		{
+			return typeKeys.size();
+		}
+
+	public:
+
+		/* Setup an empty store. */
+		EntityStore() = default;
+		EntityStore(const EntityStore&) = delete;
+		EntityStore& operator=(const EntityStore&) = delete;
+
+		/* Create a new entity made of the given components. */
+		template<class... T>
+		Entity Create(const T&... components)
+		{
+			// Reuse a destroyed entities index if there is one.
+			uint32_t index;
+			if (!freeIndices.empty())
+			{
+				index = freeIndices.back();
+				freeIndices.pop_back();
+			}
+			else
+			{
+				index = (uint32_t)records.size();
+				records.emplace_back();
+			}
+
+			// Add a row to the archetype of these components and copy them in.
+			const uint32_t archetypeIndex = GetArchetype(GetSignature<T...>());
+			Archetype& archetype = *archetypes[archetypeIndex];
+			const size_t row = PushRow(archetype, index);
+			(WriteComponent(archetype, row, GetComponentType<T>(), &components), ...);
+
+			EntityRecord& record = records[index];
+			record.archetype = archetypeIndex;
+			record.row = (uint32_t)row;
+			record.alive = true;
+			return Entity{ index, record.generation };
+		}
+
+		/* Destroy an entity and its components. Does nothing if it has already been destroyed. */
+		void Destroy(Entity entity)
+		{
+			if (!IsValid(entity)) return;
+			EntityRecord& record = records[entity.index];
+			RemoveRow(*archetypes[record.archetype], record.row);
+			record.alive = false;
+			record.generation++;
+			freeIndices.push_back(entity.index);
+		}
+
+		/* Returns if an entity exists. */
+		bool IsValid(Entity entity) const
+		{
+			return entity.index < records.size() && records[entity.index].alive && records[entity.index].generation == entity.generation;
+		}
+
+		/* Returns if an entity has a component. */
+		template<class T>
+		bool Has(Entity entity) const
+		{
+			const ComponentType type = FindComponentType<T>();
+			return type != InvalidComponentType && IsValid(entity) && (archetypes[records[entity.index].archetype]->signature & (Signature(1) << type)) != 0;
+		}
+
+		/* Returns a pointer to an entities component or nullptr if it does not have one.
+		 * NOTE: Only valid until an entity is next created, destroyed or has components added or removed. */
+		template<class T>
+		T* Get(Entity entity)
+		{
+			if (!Has<T>(entity)) return nullptr;
+			const EntityRecord& record = records[entity.index];
+			return reinterpret_cast<T*>(GetCell(*archetypes[record.archetype], record.row, FindComponentType<T>()));
+		}
+
+		/* Add a component to an entity, moving it to the archetype of its new set of components. Overwrites it if it already has one. */
+		template<class T>
+		void Add(Entity entity, const T& component)
+		{
+			if (!IsValid(entity)) return;
+			if (!Has<T>(entity)) MoveToArchetype(entity.index, archetypes[records[entity.index].archetype]->signature | GetSignature<T>());
+			*Get<T>(entity) = component;
+		}
+
+		/* Remove a component from an entity, moving it to the archetype of its remaining components. */
+		template<class T>
+		void Remove(Entity entity)
+		{
+			if (!Has<T>(entity)) return;
+			MoveToArchetype(entity.index, archetypes[records[entity.index].archetype]->signature & ~(Signature(1) << FindComponentType<T>()));
+		}
+
+		/* Run function(count, T* arrays...) over every chunk of entities that have all of the given components.
+		 * Each array holds count components of one type in the same entity order, ready for batched or SIMD updates. */
+		template<class... T, class F>
+		void ForEachChunk(F&& function)
+		{
+			ForEachChunkRows<T...>([&function](size_t, const uint32_t*, size_t count, T*... arrays) { function(count, arrays...); });
+		}
+
+		/* Run function(T&...) on every entity that has all of the given components. */
+		template<class... T, class F>
+		void ForEach(F&& function)
+		{
+			ForEachChunkRows<T...>([&function](size_t, const uint32_t*, size_t count, T*... arrays)
+			{
+				for (size_t i = 0; i < count; i++) function(arrays[i]...);
+			});
+		}
+
+		/* Run function(Entity, T&...) on every entity that has all of the given components. */
+		template<class... T, class F>
+		void ForEachEntity(F&& function)
+		{
+			ForEachChunkRows<T...>([this, &function](size_t firstRow, const uint32_t* entityIndices, size_t count, T*... arrays)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					const uint32_t index = entityIndices[firstRow + i];
+					function(Entity{ index, records[index].generation }, arrays[i]...);
+				}
+			});
+		}
+
+		/* Returns the number of entities that exist. */
+		size_t GetCount() const
+		{
+			return records.size() - freeIndices.size();
+		}
+
+		/* Returns the number of archetypes, one per set of component types used so far. */
+		size_t GetArchetypeCount() const
+		{
+			return archetypes.size();
+		}
+
+	private:
+
+		/* Block chunks are allocated in so every component array can be aligned. */
+		struct alignas(64) ChunkBlock
+		{
+			unsigned char bytes[64];
+		};
+
+		/* Size and alignment of a registered component type. */
+		struct ComponentTypeInfo
+		{
+			size_t size;
+			size_t alignment;
+		};
+
+		/* Every entity with the same set of component types. Row r is found in chunk r / chunkCapacity. */
+		struct Archetype
+		{
+			Signature signature = 0;
+
+			// Component types in the order of their arrays, with the byte offset of each array inside a chunk.
+			std::vector<ComponentType> types;
+			std::vector<size_t> columnOffsets;
+			std::array<int, MaxComponentTypes> columnOfType;
+
+			// Entities per chunk and the number of blocks each chunk is allocated with.
+			size_t chunkCapacity = 0;
+			size_t chunkBlocks = 0;
+			std::vector<std::unique_ptr<ChunkBlock[]>> chunks;
+
+			// Index of the entity in each row.
+			std::vector<uint32_t> entityIndices;
+			size_t count = 0;
+		};
+
+		/* Where an entity is stored. */
+		struct EntityRecord
+		{
+			uint32_t generation = 0;
+			uint32_t archetype = 0;
+			uint32_t row = 0;
+			bool alive = false;
+		};
+
+		/* FNV-1a hash of a type name. */
+		static ComponentTypeKey HashTypeName(const char* name)
+		{
+			ComponentTypeKey hash = 14695981039346656037ull;
+			for (; *name; name++)
+			{
+				hash ^= (unsigned char)*name;
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		/* Returns the index of the component type with a key or InvalidComponentType if there isn't one. */
+		ComponentType FindComponentType(ComponentTypeKey key) const
+		{
+			for (size_t type = 0; type < typeKeys.size(); type++)
+			{
+				if (typeKeys[type] == key) return (ComponentType)type;
+			}
+			return InvalidComponentType;
+		}
+
+		/* Add a new component type to the types used with this store. */
+		ComponentType RegisterComponentType(ComponentTypeKey key, size_t size, size_t alignment)
+		{
+			assert("Too many entity component types registered." && typeKeys.size() < MaxComponentTypes);
+			typeKeys.push_back(key);
+			typeInfos.push_back({ size, alignment });
+			return (ComponentType)(typeKeys.size() - 1);
+		}
+
+		/* Returns the index of the archetype with a signature, creating it if it doesn't exist yet. */
+		uint32_t GetArchetype(Signature signature)
+		{
+			const auto found = archetypeIndices.find(signature);
+			if (found != archetypeIndices.end()) return found->second;
+
+			auto archetype = std::make_unique<Archetype>();
+			archetype->signature = signature;
+			archetype->columnOfType.fill(-1);
+			size_t rowBytes = 0;
+			for (ComponentType type = 0; type < MaxComponentTypes; type++)
+			{
+				if ((signature & (Signature(1) << type)) == 0) continue;
+				archetype->columnOfType[type] = (int)archetype->types.size();
+				archetype->types.push_back(type);
+				rowBytes += typeInfos[type].size;
+			}
+
+			// Fit as many entities in a chunk as possible, taking off one at a time until the aligned arrays fit.
+			size_t capacity = std::max<size_t>(1, ChunkBytes / std::max<size_t>(1, rowBytes));
+			size_t chunkSize;
+			while (true)
+			{
+				chunkSize = 0;
+				archetype->columnOffsets.clear();
+				for (ComponentType type : archetype->types)
+				{
+					const size_t alignment = typeInfos[type].alignment;
+					chunkSize = (chunkSize + alignment - 1) / alignment * alignment;
+					archetype->columnOffsets.push_back(chunkSize);
+					chunkSize += typeInfos[type].size * capacity;
+				}
+				if (chunkSize <= ChunkBytes || capacity == 1) break;
+				capacity--;
+			}
+			archetype->chunkCapacity = capacity;
+			archetype->chunkBlocks = (chunkSize + sizeof(ChunkBlock) - 1) / sizeof(ChunkBlock);
+
+			archetypes.push_back(std::move(archetype));
+			archetypeIndices[signature] = (uint32_t)(archetypes.size() - 1);
+			return (uint32_t)(archetypes.size() - 1);
+		}
+
+		/* Returns the address of a component of the entity in a row. */
+		unsigned char* GetCell(Archetype& archetype, size_t row, ComponentType type)
+		{
+			const size_t column = (size_t)archetype.columnOfType[type];
+			const size_t typeSize = typeInfos[type].size;
+			return GetChunkData(archetype, row / archetype.chunkCapacity) + archetype.columnOffsets[column] + (row % archetype.chunkCapacity) * typeSize;
+		}
+
+		/* Returns the start of a chunks memory. */
+		static unsigned char* GetChunkData(Archetype& archetype, size_t chunk)
+		{
+			return archetype.chunks[chunk] ? archetype.chunks[chunk][0].bytes : nullptr;
+		}
+
+		/* Copy a component into a row. */
+		void WriteComponent(Archetype& archetype, size_t row, ComponentType type, const void* component)
+		{
+			std::memcpy(GetCell(archetype, row, type), component, typeInfos[type].size);
+		}
+
+		/* Add an entity to the end of an archetype, adding a chunk if the last one is full. Returns its row. */
+		size_t PushRow(Archetype& archetype, uint32_t entityIndex)
+		{
+			const size_t row = archetype.count++;
+			if (row / archetype.chunkCapacity >= archetype.chunks.size())
+			{
+				archetype.chunks.push_back(archetype.chunkBlocks ? std::make_unique<ChunkBlock[]>(archetype.chunkBlocks) : nullptr);
+			}
+			archetype.entityIndices.push_back(entityIndex);
+			return row;
+		}
+
+		/* Remove a row by moving the last row of the archetype into it. */
+		void RemoveRow(Archetype& archetype, size_t row)
+		{
+			const size_t lastRow = archetype.count - 1;
+			if (row != lastRow)
+			{
+				for (ComponentType type : archetype.types)
+				{
+					std::memcpy(GetCell(archetype, row, type), GetCell(archetype, lastRow, type), typeInfos[type].size);
+				}
+				const uint32_t movedIndex = archetype.entityIndices[lastRow];
+				archetype.entityIndices[row] = movedIndex;
+				records[movedIndex].row = (uint32_t)row;
+			}
+			archetype.entityIndices.pop_back();
+			archetype.count--;
+
+			// Keep one empty chunk spare so an entity moving back and forth does not allocate every time.
+			const size_t usedChunks = (archetype.count + archetype.chunkCapacity - 1) / archetype.chunkCapacity;
+			if (archetype.chunks.size() > usedChunks + 1) archetype.chunks.pop_back();
+		}
+
+		/* Move an entity to the archetype of a new signature, keeping every component both archetypes have. */
+		void MoveToArchetype(uint32_t entityIndex, Signature newSignature)
+		{
+			EntityRecord& record = records[entityIndex];
+			const uint32_t newArchetypeIndex = GetArchetype(newSignature);
+			Archetype& oldArchetype = *archetypes[record.archetype];
+			Archetype& newArchetype = *archetypes[newArchetypeIndex];
+			const size_t newRow = PushRow(newArchetype, entityIndex);
+			for (ComponentType type : newArchetype.types)
+			{
+				if (oldArchetype.columnOfType[type] < 0) continue;
+				std::memcpy(GetCell(newArchetype, newRow, type), GetCell(oldArchetype, record.row, type), typeInfos[type].size);
+			}
+			RemoveRow(oldArchetype, record.row);
+			record.archetype = newArchetypeIndex;
+			record.row = (uint32_t)newRow;
+		}
+
+		/* Run function(firstRow, entityIndices, count, T* arrays...) over every chunk of every archetype that has all of the given components. */
+		template<class... T, class F>
+		void ForEachChunkRows(F&& function)
+		{
+			static_assert(sizeof...(T) > 0, "Queries need at least one component type.");
+			// Nothing has a component type this store has not seen.
+			const ComponentType types[] = { FindComponentType<T>()... };
+			Signature required = 0;
+			for (ComponentType type : types)
+			{
+				if (type == InvalidComponentType) return;
+				required |= Signature(1) << type;
+			}
+			for (auto& archetype : archetypes)
+			{
+				if ((archetype->signature & required) != required) continue;
+				for (size_t firstRow = 0; firstRow < archetype->count; firstRow += archetype->chunkCapacity)
+				{
+					unsigned char* chunkData = GetChunkData(*archetype, firstRow / archetype->chunkCapacity);
+					const size_t count = std::min(archetype->chunkCapacity, archetype->count - firstRow);
+					function(firstRow, archetype->entityIndices.data(), count, reinterpret_cast<T*>(chunkData + archetype->columnOffsets[archetype->columnOfType[FindComponentType<T>()]])...);
+				}
+			}
+		}
+
+	private:
+
+		// Key, size and alignment of each component type used with this store, by type index.
+		std::vector<ComponentTypeKey> typeKeys;
+		std::vector<ComponentTypeInfo> typeInfos;
+
+		// Every archetype created so far and the index of each by signature.
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::unordered_map<Signature, uint32_t> archetypeIndices;
+
+		// Where each entity is stored and the indices of destroyed entities waiting to be reused.
+		std::vector<EntityRecord> records;
+		std::vector<uint32_t> freeIndices;
+	};
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "GameObject.h"
 #include "../Components/SceneComponent.h"
+#include "../Components/MeshComponent.h"
 
 namespace ReeeEngine
 {
@@ -13,6 +14,11 @@ namespace ReeeEngine
 	{
 		// Clear components.
 		components.clear();
+
+		// Remove the entity this object is linked to and invalidate any handles to it.
+		if (entityStore) entityStore->Destroy(entity);
+		if (handleTable) handleTable->Remove(handle);
+		if (spatialIndex) spatialIndex->Remove(spatialProxy);
 	}
 
 	void GameObject::LevelStart()
@@ -26,11 +32,32 @@ namespace ReeeEngine
 
 	void GameObject::Tick(float DeltaTime)
 	{
-		// Tick each component.
-		for (auto& comp : components)
+		// Components that need ticking are registered with the world and ticked on their own.
+	}
+
+	BoundingBox GameObject::GetWorldBounds() const
+	{
+		if (!sceneComponentsCached)
+		{
+			sceneComponents.clear();
+			for (Component* comp : components)
+			{
+				SceneComponent* sceneComp = dynamic_cast<SceneComponent*>(comp);
+				if (sceneComp) sceneComponents.push_back(sceneComp);
+			}
+			sceneComponentsCached = true;
+		}
+		BoundingBox bounds;
+		for (const SceneComponent* sceneComp : sceneComponents)
 		{
-			comp->Tick(DeltaTime);
+			bounds.Expand(sceneComp->GetWorldBounds());
 		}
+		return bounds;
+	}
+
+	void GameObject::MarkBoundsDirty()
+	{
+		if (spatialIndex) spatialIndex->MarkDirty(spatialProxy);
 	}
 
 	Vector3D GameObject::GetWorldLocation() const
@@ -73,6 +100,45 @@ namespace ReeeEngine
 		return rootComponent->SetWorldTransform(newTransform);
 	}
 
+	void GameObject::SetWorldLocationAndRotation(const Vector3D& newLocation, const Rotator& newRotation)
+	{
+		rootComponent->SetWorldLocationAndRotation(newLocation, newRotation);
+	}
+
+	void GameObject::SetMobility(Mobility newMobility)
+	{
+		for (auto& comp : components)
+		{
+			if (SceneComponent* sceneComp = dynamic_cast<SceneComponent*>(comp)) sceneComp->SetMobility(newMobility);
+		}
+	}
+
+	void GameObject::LockTransforms()
+	{
+		for (auto& comp : components)
+		{
+			if (SceneComponent* sceneComp = dynamic_cast<SceneComponent*>(comp)) sceneComp->LockTransform();
+		}
+	}
+
+	void GameObject::UnlinkComponents()
+	{
+		for (auto& comp : components)
+		{
+			if (MeshComponent* meshComp = dynamic_cast<MeshComponent*>(comp)) meshComp->UnregisterMesh();
+			SceneComponent* sceneComp = dynamic_cast<SceneComponent*>(comp);
+			if (!sceneComp) continue;
+
+			// Components of other objects are left where they are in the world.
+			SceneComponent* parent = sceneComp->GetAttachParent();
+			if (parent && parent->GetOwner() != this) parent->RemoveChild(sceneComp);
+			for (SceneComponent* child : sceneComp->GetChildren())
+			{
+				if (child->GetOwner() != this) sceneComp->RemoveChild(child);
+			}
+		}
+	}
+
 	int GameObject::GetNumChildren() const
 	{
 		return components.size();
@@ -5,6 +5,9 @@
 #include "../../Math/Rotator.h"
 #include "../../Math/Transform.h"
 #include "../Components/Component.h"
+#include "EntityStore.h"
+#include "ObjectHandle.h"
+#include "SpatialIndex.h"
 
 /* Define used classes. */
 class SceneComponent;
@@ -15,9 +18,21 @@ class SceneComponent;
 
 namespace ReeeEngine
 {
+	/* Define used types. */
+	enum class Mobility;
+
+	/* Entity component linking an entity in the worlds entity store back to the game object it was created for. */
+	struct GameObjectEntity
+	{
+		class GameObject* object;
+	};
+
 	/* Game objects are world objects that own components. */
 	class REEE_API GameObject : public Object
 	{
+		/* Allow the world to link objects to their entity. */
+		friend class World;
+
 	public:
 
 		/* Setup default game object. */
@@ -41,6 +56,24 @@ namespace ReeeEngine
 		void SetWorldRotation(const Rotator& newRotation, bool addToCurrent = false);
 		void SetWorldScale(const Vector3D& newScale, bool addToCurrent = false);
 		void SetWorldTransform(const Transform& newTransform);
+		void SetWorldLocationAndRotation(const Vector3D& newLocation, const Rotator& newRotation);
+
+		/* Returns the box around the world bounds of every scene component owned by this object. */
+		BoundingBox GetWorldBounds() const;
+
+		/* Queue this objects bounds to be refit in its worlds spatial index, ran when one of its scene components moves. */
+		void MarkBoundsDirty();
+
+		/* Set the mobility of every scene component owned by this object.
+		 * NOTE: Can only be changed before the level starts. */
+		void SetMobility(Mobility newMobility);
+
+		/* Lock the mobility of every scene component owned by this object, ran by the world once its level has started. */
+		void LockTransforms();
+
+		/* Stop drawing the meshes of this object and detach its scene components from those of other objects so neither follows the other.
+		 * NOTE: Ran by the world when it removes this object, as something outside the world can still hold onto it. */
+		void UnlinkComponents();
 
 		/* Get the root component. */
 		Pointer<SceneComponent> GetRootComponent() const { return rootComponent; }
@@ -48,6 +81,33 @@ namespace ReeeEngine
 		/* Get number of children owned by this object. */
 		int GetNumChildren() const;
 
+		/* Returns the handle of this object in its world, copies of it stay valid until the object is destroyed. */
+		ObjectHandle<GameObject> GetHandle() const { return handle; }
+
+		/* Returns if the object has been destroyed and is waiting to be removed from its world at the end of the frame. */
+		bool IsPendingDestroy() const { return pendingDestroy; }
+
+		/* Returns the entity this object is linked to in the worlds entity store. */
+		EntityStore::Entity GetEntity() const { return entity; }
+
+		/* Add, get and remove plain data components on this objects entity so they can be updated by the worlds systems.
+		 * NOTE: Pointers returned by GetEntityData are only valid until components are next added to or removed from any entity. */
+		template<class T>
+		void AddEntityData(const T& data)
+		{
+			if (entityStore) entityStore->Add(entity, data);
+		}
+		template<class T>
+		T* GetEntityData()
+		{
+			return entityStore ? entityStore->Get<T>(entity) : nullptr;
+		}
+		template<class T>
+		void RemoveEntityData()
+		{
+			if (entityStore) entityStore->Remove<T>(entity);
+		}
+
 	protected:
 
 		/* Declare and define create sub-object function for adding new components to a given game object. */
@@ -62,6 +122,7 @@ namespace ReeeEngine
 			Component* comp = static_cast<Component*>(newComp.get());
 			comp->SetOwner(this);
 			components.push_back(comp);
+			sceneComponentsCached = false;
 			return newComp;
 		}
 
@@ -70,5 +131,25 @@ namespace ReeeEngine
 
 		// Array of all of subobjects owned by this game object.
 		std::vector<Component*> components;
+
+		// Entity of this object and the store it is in, set by the world when the object is spawned.
+		EntityStore::Entity entity;
+		EntityStore* entityStore = nullptr;
+
+		// Handle of this object and the table it is in, set by the world when the object is spawned.
+		ObjectHandle<GameObject> handle;
+		HandleTable<GameObject>* handleTable = nullptr;
+
+		// Proxy of this object in its worlds spatial index and the index it is in, set by the world when the object is spawned.
+		SpatialIndex<GameObject*>* spatialIndex = nullptr;
+		uint32_t spatialProxy = SpatialIndex<GameObject*>::InvalidProxy;
+
+		// Scene components of this object its bounds are made from, found the first time they are needed after a component is added.
+		mutable std::vector<SceneComponent*> sceneComponents;
+		mutable bool sceneComponentsCached = false;
+
+		// Place of this object in its worlds object list and if it has been destroyed, set by the world.
+		size_t worldIndex = ~size_t(0);
+		bool pendingDestroy = false;
 	};
 }
@@ -0,0 +1,71 @@
+#include "Object.h"
+#include "TickManager.h"
+
+namespace ReeeEngine
+{
+	Object::~Object()
+	{
+		// Unlink from every prerequisite and dependent so they no longer point at this object.
+		for (Object* prerequisite : tickPrerequisites)
+		{
+			auto& dependents = prerequisite->tickDependents;
+			dependents.erase(std::remove(dependents.begin(), dependents.end(), this), dependents.end());
+		}
+		for (Object* dependent : tickDependents)
+		{
+			auto& prerequisites = dependent->tickPrerequisites;
+			prerequisites.erase(std::remove(prerequisites.begin(), prerequisites.end(), this), prerequisites.end());
+			if (dependent->tickManager) dependent->tickManager->needsSchedule = true;
+		}
+		tickPrerequisites.clear();
+		tickDependents.clear();
+		if (tickManager) tickManager->Unregister(this);
+	}
+
+	void Object::SetTickEnabled(bool enabled)
+	{
+		tickSettings.enabled = enabled;
+		if (!tickManager) return;
+
+		// Wait a full interval again once re-enabled.
+		auto& entry = tickManager->GetEntry(this);
+		if (enabled && !entry.enabled) tickManager->RestartTickInterval(entry);
+		entry.enabled = enabled;
+	}
+
+	bool Object::IsTickEnabled() const
+	{
+		return tickSettings.enabled;
+	}
+
+	void Object::SetTickFrameInterval(uint32_t frames)
+	{
+		tickSettings.frameInterval = std::max(1u, frames);
+		if (tickManager) tickManager->GetEntry(this).frameInterval = tickSettings.frameInterval;
+	}
+
+	void Object::SetTickInterval(float seconds)
+	{
+		tickSettings.secondsInterval = std::max(0.0f, seconds);
+		if (tickManager) tickManager->GetEntry(this).secondsInterval = tickSettings.secondsInterval;
+	}
+
+	void Object::AddTickPrerequisite(Object* prerequisite)
+	{
+		if (!prerequisite || prerequisite == this) return;
+		if (std::find(tickPrerequisites.begin(), tickPrerequisites.end(), prerequisite) != tickPrerequisites.end()) return;
+		tickPrerequisites.push_back(prerequisite);
+		prerequisite->tickDependents.push_back(this);
+		if (tickManager) tickManager->needsSchedule = true;
+	}
+
+	void Object::RemoveTickPrerequisite(Object* prerequisite)
+	{
+		auto found = std::find(tickPrerequisites.begin(), tickPrerequisites.end(), prerequisite);
+		if (found == tickPrerequisites.end()) return;
+		tickPrerequisites.erase(found);
+		auto& dependents = prerequisite->tickDependents;
+		dependents.erase(std::remove(dependents.begin(), dependents.end(), this), dependents.end());
+		if (tickManager) tickManager->needsSchedule = true;
+	}
+}
\ No newline at end of file
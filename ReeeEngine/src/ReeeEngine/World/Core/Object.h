@@ -1,20 +1,29 @@
 #pragma once
 #include "../../Globals.h"
+#include "TickManager.h"
+#include <cstdint>
+#include <vector>
 
 namespace ReeeEngine
 {
+	/* Define used classes. */
+	class Object;
+	typedef BasicTickManager<Object> TickManager;
+
 	/* Base object for anything that has to be ticked within the engine.
 	 * NOTE: For example GameObjects and components will be the main subclasses. */
 	class REEE_API Object
 	{
 		friend class SceneComponent;
 		friend class GameObject;
+		friend class BasicTickManager<Object>;
 
 	public:
 
-		/* Default constructor and destructor. */
-		Object(const std::string objectName) : name(objectName) {}
-		~Object() = default;
+		/* Default constructor and destructor.
+		 * NOTE: The destructor removes the object from the tick lists it is registered in. */
+		Object(const std::string objectName) : name(objectName), tickManager(nullptr), tickIndex(0) {}
+		~Object();
 
 		/* Level start function. */
 		virtual void LevelStart() = 0;
@@ -25,9 +34,38 @@ namespace ReeeEngine
 		/* Return the objects name. */
 		const std::string GetName() { return name; }
 
+		/* Returns if this object should be registered to be ticked. */
+		virtual bool CanEverTick() const { return tickSettings.canEverTick; }
+
+		/* Enable or disable ticking while the object is registered. */
+		void SetTickEnabled(bool enabled);
+		bool IsTickEnabled() const;
+
+		/* Set how often the object is ticked, in frames and in seconds. */
+		void SetTickFrameInterval(uint32_t frames);
+		void SetTickInterval(float seconds);
+
+		/* Make this object tick after another object each frame. A prerequisite in an earlier tick group has always ticked
+		 * first, one in a later group can't tick first and is ignored. */
+		void AddTickPrerequisite(Object* prerequisite);
+		void RemoveTickPrerequisite(Object* prerequisite);
+
 	protected:
 
 		// The name of this object.
 		std::string name;
+
+		// How this object is ticked, set up by subclasses that need ticking before they are registered.
+		TickSettings tickSettings;
+
+	private:
+
+		// Tick list this object is registered in and its place in its groups list.
+		TickManager* tickManager;
+		uint32_t tickIndex;
+
+		// Objects this object ticks after and the objects that tick after it, kept both ways so neither is left pointing at a destroyed object.
+		std::vector<Object*> tickPrerequisites;
+		std::vector<Object*> tickDependents;
 	};
-}
+}
\ No newline at end of file
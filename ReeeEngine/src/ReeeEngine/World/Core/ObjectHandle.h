@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <type_traits>
+
+namespace ReeeEngine
+{
+	/* Index used by handles that point at nothing. */
+	constexpr uint32_t InvalidHandleIndex = 0xFFFFFFFFu;
+
+	/* Handle to an object in a handle table, 32 bits of index and 32 bits of generation packed into 64 bits.
+	 * The generation of a slot changes every time its index is reused so handles to destroyed objects stay invalid,
+	 * unlike raw pointers, and unlike shared pointers copying one costs nothing. */
+	template<class T>
+	struct ObjectHandle
+	{
+		uint32_t index = InvalidHandleIndex;
+		uint32_t generation = 0;
+
+		ObjectHandle() = default;
+		ObjectHandle(uint32_t handleIndex, uint32_t handleGeneration) : index(handleIndex), generation(handleGeneration) {}
+
+		/* Handles to a type convert to handles of its base types the same as pointers do. */
+		template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+		ObjectHandle(const ObjectHandle<U>& other) : index(other.index), generation(other.generation) {}
+
+		/* Returns if this handle has never been set to an object. Use the handles table to check it is still valid. */
+		bool IsNull() const { return index == InvalidHandleIndex; }
+
+		bool operator==(const ObjectHandle& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const ObjectHandle& other) const { return !(*this == other); }
+	};
+
+	/* Table of slots handing out generational handles to objects of the base type B and its subclasses.
+	 * Checking and resolving a handle is one array lookup and a compare. Freed slots are reused most recent first.
+	 * NOTE: Handles are only as type safe as the code making them, a handle resolves to the type it was made for. */
+	template<class B>
+	class HandleTable
+	{
+	public:
+
+		/* Setup an empty table. */
+		HandleTable() : freeHead(InvalidHandleIndex), liveCount(0) {}
+		HandleTable(const HandleTable&) = delete;
+		HandleTable& operator=(const HandleTable&) = delete;
+
+		/* Give an object a slot and return its handle. */
+		template<class T>
+		ObjectHandle<T> Add(T* object)
+		{
+			uint32_t index;
+			if (freeHead != InvalidHandleIndex)
+			{
+				index = freeHead;
+				freeHead = slots[index].nextFree;
+			}
+			else
+			{
+				// Generations start at 1 so a zeroed handle never matches a slot.
+				index = (uint32_t)slots.size();
+				slots.push_back({ nullptr, 1, InvalidHandleIndex });
+			}
+			slots[index].object = object;
+			liveCount++;
+			return ObjectHandle<T>(index, slots[index].generation);
+		}
+
+		/* Free the slot of a handle so it and any copies of it are no longer valid. Does nothing for invalid handles. */
+		template<class T>
+		void Remove(const ObjectHandle<T>& handle)
+		{
+			if (!IsValid(handle)) return;
+			Slot& slot = slots[handle.index];
+			slot.object = nullptr;
+			slot.generation = slot.generation == 0xFFFFFFFFu ? 1 : slot.generation + 1;
+			slot.nextFree = freeHead;
+			freeHead = handle.index;
+			liveCount--;
+		}
+
+		/* Returns if a handle still points at an object. */
+		template<class T>
+		bool IsValid(const ObjectHandle<T>& handle) const
+		{
+			return handle.index < slots.size() && slots[handle.index].generation == handle.generation && slots[handle.index].object;
+		}
+
+		/* Returns the object a handle points at or nullptr if it is no longer valid. */
+		template<class T>
+		T* Get(const ObjectHandle<T>& handle) const
+		{
+			return IsValid(handle) ? static_cast<T*>(slots[handle.index].object) : nullptr;
+		}
+
+		/* Returns the number of objects with a slot. */
+		size_t GetCount() const
+		{
+			return liveCount;
+		}
+
+	private:
+
+		/* An object and the generation of handles to it, or the next free slot while unused. */
+		struct Slot
+		{
+			B* object;
+			uint32_t generation;
+			uint32_t nextFree;
+		};
+
+		// Every slot made so far and the most recently freed one.
+		std::vector<Slot> slots;
+		uint32_t freeHead;
+		size_t liveCount;
+	};
+}
\ No newline at end of file
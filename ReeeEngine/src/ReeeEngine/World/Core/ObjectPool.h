@@ -0,0 +1,129 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace ReeeEngine
+{
+	/* Pool of fixed size slots for objects of type T, allocated in blocks so objects of the same type sit next to each other.
+	 * Freed slots go on a free list and are handed out again most recent first while they are still warm in the cache.
+	 * Blocks are never released so the pool stays at the most objects alive at once.
+	 * NOTE: Only hands out memory, constructing and destroying objects in it is up to the caller.
+	 *       Not thread safe, like the rest of the world objects are only spawned and released on the game thread. */
+	template<class T>
+	class ObjectPool
+	{
+	public:
+
+		// Slots allocated at once when the pool runs out.
+		static constexpr size_t SlotsPerBlock = 64;
+
+		/* Returns the pool of this type.
+		 * NOTE: Never destroyed so objects released while the process is shutting down still have a pool to go back to. */
+		static ObjectPool& Get()
+		{
+			static ObjectPool* pool = new ObjectPool();
+			return *pool;
+		}
+
+		/* Returns memory for one T. */
+		void* Allocate()
+		{
+			if (!freeHead) AddBlock();
+			FreeSlot* slot = freeHead;
+			freeHead = slot->next;
+			liveCount++;
+			return slot;
+		}
+
+		/* Give back memory returned by Allocate. */
+		void Free(void* memory)
+		{
+			FreeSlot* slot = static_cast<FreeSlot*>(memory);
+			slot->next = freeHead;
+			freeHead = slot;
+			liveCount--;
+		}
+
+		/* Returns the number of slots in use and the number allocated. */
+		size_t GetLiveCount() const
+		{
+			return liveCount;
+		}
+		size_t GetCapacity() const
+		{
+			return blocks.size() * SlotsPerBlock;
+		}
+
+	private:
+
+		/* Link in an unused slot. */
+		struct FreeSlot
+		{
+			FreeSlot* next;
+		};
+
+		// Size and alignment of each slot, big enough to hold either a T or a free list link.
+		static constexpr size_t SlotAlign = std::max(alignof(T), alignof(FreeSlot));
+		static constexpr size_t SlotSize = (std::max(sizeof(T), sizeof(FreeSlot)) + SlotAlign - 1) / SlotAlign * SlotAlign;
+
+		/* Frees a block with the alignment it was allocated with. */
+		struct BlockDeleter
+		{
+			void operator()(unsigned char* block) const { ::operator delete(block, std::align_val_t(SlotAlign)); }
+		};
+
+		ObjectPool() : freeHead(nullptr), liveCount(0) {}
+
+		/* Allocate a new block and put its slots on the free list, lowest address first. */
+		void AddBlock()
+		{
+			unsigned char* block = static_cast<unsigned char*>(::operator new(SlotSize * SlotsPerBlock, std::align_val_t(SlotAlign)));
+			blocks.emplace_back(block);
+			for (size_t i = SlotsPerBlock; i-- > 0;)
+			{
+				FreeSlot* slot = reinterpret_cast<FreeSlot*>(block + i * SlotSize);
+				slot->next = freeHead;
+				freeHead = slot;
+			}
+		}
+
+	private:
+
+		// Every block allocated and the first free slot.
+		std::vector<std::unique_ptr<unsigned char, BlockDeleter>> blocks;
+		FreeSlot* freeHead;
+		size_t liveCount;
+	};
+
+	/* Allocator that takes single objects from the ObjectPool of their type. Used with std::allocate_shared the object and
+	 * its reference counts are pooled together in one slot. */
+	template<class T>
+	struct PoolAllocator
+	{
+		typedef T value_type;
+
+		PoolAllocator() = default;
+		template<class U>
+		PoolAllocator(const PoolAllocator<U>&) {}
+
+		T* allocate(size_t count)
+		{
+			if (count == 1) return static_cast<T*>(ObjectPool<T>::Get().Allocate());
+			return std::allocator<T>().allocate(count);
+		}
+
+		void deallocate(T* memory, size_t count)
+		{
+			if (count == 1) ObjectPool<T>::Get().Free(memory);
+			else std::allocator<T>().deallocate(memory, count);
+		}
+
+		template<class U>
+		bool operator==(const PoolAllocator<U>&) const { return true; }
+		template<class U>
+		bool operator!=(const PoolAllocator<U>&) const { return false; }
+	};
+}
\ No newline at end of file
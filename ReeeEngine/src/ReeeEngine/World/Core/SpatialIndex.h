@@ -0,0 +1,485 @@
+#pragma once
+#include "../../Math/Bounds.h"
+#include "../../Math/Frustum.h"
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace ReeeEngine
+{
+	/* A value found by a nearest query and its squared distance from the query point. */
+	template<class T>
+	struct SpatialHit
+	{
+		T value;
+		float distanceSquared;
+	};
+
+	/* Dynamic bounding volume tree of values placed by their world bounds, for finding what is in or near part of the world
+	 * without looking at everything. Leaves hold the bounds grown by a margin so objects that move a little stay inside their
+	 * leaf and only the exact bounds are updated, objects that leave it are taken out and put back where they fit best. The
+	 * tree is kept balanced by rotating nodes as it changes so queries stay fast however objects are added.
+	 * Queries call a function for each value found instead of filling a list so finding things never allocates.
+	 * NOTE: Only uses the math layer so it can be benchmarked without the rest of the engine.
+	 *       Changing the tree while it is being queried is not safe, querying it from many threads at once is. */
+	template<class T>
+	class SpatialIndex
+	{
+	public:
+
+		// Proxy returned for values that are not in the index.
+		static constexpr uint32_t InvalidProxy = 0xFFFFFFFFu;
+
+		/* Setup an empty index that grows the bounds of its leaves by the given margin. */
+		explicit SpatialIndex(float leafMargin = 1.0f) : root(InvalidProxy), freeHead(InvalidProxy), margin(leafMargin), count(0) {}
+		SpatialIndex(const SpatialIndex&) = delete;
+		SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+		/* Add a value with its world bounds and return the proxy it is moved and removed with. */
+		uint32_t Insert(const BoundingBox& bounds, const T& value)
+		{
+			const uint32_t leaf = AllocateNode();
+			Node& node = nodes[leaf];
+			node.bounds = GetFatBounds(bounds);
+			node.tightBounds = bounds;
+			node.value = value;
+			node.height = 0;
+			node.dirty = false;
+			InsertLeaf(leaf);
+			count++;
+			return leaf;
+		}
+
+		/* Remove a value by its proxy. Does nothing for the invalid proxy. */
+		void Remove(uint32_t proxy)
+		{
+			if (proxy == InvalidProxy) return;
+			RemoveLeaf(proxy);
+			FreeNode(proxy);
+			count--;
+		}
+
+		/* Update the bounds of a value. Returns true if it left its leafs bounds and had to be moved in the tree. */
+		bool Move(uint32_t proxy, const BoundingBox& bounds)
+		{
+			Node& node = nodes[proxy];
+			node.tightBounds = bounds;
+			if (Contains(node.bounds, bounds)) return false;
+			RemoveLeaf(proxy);
+			nodes[proxy].bounds = GetFatBounds(bounds);
+			InsertLeaf(proxy);
+			return true;
+		}
+
+		/* Queue a value to have its bounds updated by the next Refit, a value queued more than once is only updated once. */
+		void MarkDirty(uint32_t proxy)
+		{
+			if (proxy == InvalidProxy || nodes[proxy].dirty) return;
+			nodes[proxy].dirty = true;
+			dirtyProxies.push_back(proxy);
+		}
+
+		/* Update the bounds of every value queued since the last refit using a function returning the bounds of a value.
+		 * Returns the number of values that had to be moved in the tree. */
+		template<class F>
+		size_t Refit(F&& getBounds)
+		{
+			size_t moved = 0;
+			for (uint32_t proxy : dirtyProxies)
+			{
+				// Values removed after being queued have had their node freed or reused, either way it is no longer dirty.
+				if (!nodes[proxy].dirty) continue;
+				nodes[proxy].dirty = false;
+				moved += Move(proxy, getBounds(nodes[proxy].value)) ? 1 : 0;
+			}
+			dirtyProxies.clear();
+			return moved;
+		}
+
+		/* Returns the value and exact bounds of a proxy. */
+		const T& GetValue(uint32_t proxy) const { return nodes[proxy].value; }
+		const BoundingBox& GetBounds(uint32_t proxy) const { return nodes[proxy].tightBounds; }
+
+		/* Returns the number of values in the index and the height of the tree. */
+		size_t GetCount() const { return count; }
+		int32_t GetHeight() const { return root == InvalidProxy ? 0 : nodes[root].height; }
+
+		/* Leaf margin getter and setter, a new margin is used by leaves as they are next moved. */
+		float GetMargin() const { return margin; }
+		void SetMargin(float newMargin) { margin = newMargin; }
+
+		/* Call visit with each value whose bounds overlap a box. */
+		template<class F>
+		void QueryBox(const BoundingBox& box, F&& visit) const
+		{
+			Traverse([&box](const BoundingBox& bounds)
+			{
+				if (!box.Intersects(bounds)) return Overlap::Outside;
+				return Contains(box, bounds) ? Overlap::Inside : Overlap::Partial;
+			}, visit);
+		}
+
+		/* Call visit with each value whose bounds are within a radius of a point. */
+		template<class F>
+		void QueryRadius(const Vector3D& center, float radius, F&& visit) const
+		{
+			const float radiusSquared = radius * radius;
+			Traverse([&center, radiusSquared](const BoundingBox& bounds)
+			{
+				if (bounds.GetDistanceSquared(center) > radiusSquared) return Overlap::Outside;
+				return GetFarthestDistanceSquared(bounds, center) <= radiusSquared ? Overlap::Inside : Overlap::Partial;
+			}, visit);
+		}
+
+		/* Call visit with each value whose bounds are at least partly inside a frustum. */
+		template<class F>
+		void QueryFrustum(const Frustum& frustum, F&& visit) const
+		{
+			Traverse([&frustum](const BoundingBox& bounds)
+			{
+				const VectorRegister center = VectorSetW(bounds.GetCenter().ToRegister(), 1.0f);
+				const VectorRegister extents = bounds.GetExtents().ToRegister();
+				Overlap overlap = Overlap::Inside;
+				for (int i = 0; i < Frustum::PlaneCount; i++)
+				{
+					const float distance = VectorGetX(VectorDot4(frustum.Planes[i], center));
+					const float projectedRadius = VectorGetX(VectorDot3(VectorAbs(frustum.Planes[i]), extents));
+					if (distance < -projectedRadius) return Overlap::Outside;
+					if (distance < projectedRadius) overlap = Overlap::Partial;
+				}
+				return overlap;
+			}, visit);
+		}
+
+		/* Find up to maxHits values nearest a point within maxDistance, written to outHits nearest first by the distance to
+		 * their bounds. Returns the number of values found. */
+		size_t QueryNearest(const Vector3D& point, SpatialHit<T>* outHits, size_t maxHits, float maxDistance = BIG_NUMBER) const
+		{
+			if (root == InvalidProxy || maxHits == 0) return 0;
+			size_t hitCount = 0;
+			float searchDistanceSquared = maxDistance * maxDistance;
+			uint32_t stack[MaxStackDepth];
+			size_t stackSize = 0;
+			stack[stackSize++] = root;
+			while (stackSize > 0)
+			{
+				const Node& node = nodes[stack[--stackSize]];
+				if (node.bounds.GetDistanceSquared(point) > searchDistanceSquared) continue;
+				if (node.IsLeaf())
+				{
+					const float distanceSquared = node.tightBounds.GetDistanceSquared(point);
+					if (distanceSquared > searchDistanceSquared) continue;
+
+					// Keep the hits sorted, dropping the farthest once the list is full.
+					size_t slot = hitCount < maxHits ? hitCount++ : maxHits - 1;
+					for (; slot > 0 && outHits[slot - 1].distanceSquared > distanceSquared; slot--) outHits[slot] = outHits[slot - 1];
+					outHits[slot] = { node.value, distanceSquared };
+					if (hitCount == maxHits) searchDistanceSquared = outHits[maxHits - 1].distanceSquared;
+					continue;
+				}
+
+				// Push the nearer child last so it is searched first and shrinks the search distance sooner.
+				const float distance1 = nodes[node.child1].bounds.GetDistanceSquared(point);
+				const float distance2 = nodes[node.child2].bounds.GetDistanceSquared(point);
+				stack[stackSize++] = distance1 < distance2 ? node.child2 : node.child1;
+				stack[stackSize++] = distance1 < distance2 ? node.child1 : node.child2;
+			}
+			return hitCount;
+		}
+
+	private:
+
+		// Deepest a query can go. A balanced tree is at most about 1.44 log2 of its leaf count tall so this fits any tree that fits in memory.
+		static constexpr size_t MaxStackDepth = 64;
+
+		/* How much of a node a query covers. */
+		enum class Overlap : uint8_t
+		{
+			Outside,
+			Partial,
+			Inside
+		};
+
+		/* A leaf holding a value or a branch joining two nodes, free nodes are linked through their parent. */
+		struct Node
+		{
+			BoundingBox bounds;
+			BoundingBox tightBounds;
+			T value;
+			uint32_t parent;
+			uint32_t child1;
+			uint32_t child2;
+			int32_t height;
+			bool dirty;
+
+			bool IsLeaf() const { return child1 == InvalidProxy; }
+		};
+
+		/* Walk every node the test says overlaps, visiting each leaf under a node fully inside without testing it again. */
+		template<class Test, class F>
+		void Traverse(const Test& test, F& visit) const
+		{
+			if (root == InvalidProxy) return;
+			uint32_t stack[MaxStackDepth];
+			size_t stackSize = 0;
+			stack[stackSize++] = root;
+			while (stackSize > 0)
+			{
+				const uint32_t index = stack[--stackSize];
+				const Node& node = nodes[index];
+				if (node.IsLeaf())
+				{
+					if (test(node.tightBounds) != Overlap::Outside) visit(node.value);
+					continue;
+				}
+				const Overlap overlap = test(node.bounds);
+				if (overlap == Overlap::Outside) continue;
+				if (overlap == Overlap::Inside)
+				{
+					VisitAll(index, visit);
+					continue;
+				}
+				stack[stackSize++] = node.child2;
+				stack[stackSize++] = node.child1;
+			}
+		}
+
+		/* Visit every leaf under a node. */
+		template<class F>
+		void VisitAll(uint32_t index, F& visit) const
+		{
+			uint32_t stack[MaxStackDepth];
+			size_t stackSize = 0;
+			stack[stackSize++] = index;
+			while (stackSize > 0)
+			{
+				const Node& node = nodes[stack[--stackSize]];
+				if (node.IsLeaf())
+				{
+					visit(node.value);
+					continue;
+				}
+				stack[stackSize++] = node.child2;
+				stack[stackSize++] = node.child1;
+			}
+		}
+
+		/* Returns if a box fully contains another. */
+		static bool Contains(const BoundingBox& outer, const BoundingBox& inner)
+		{
+			return inner.Min.X >= outer.Min.X && inner.Min.Y >= outer.Min.Y && inner.Min.Z >= outer.Min.Z
+				&& inner.Max.X <= outer.Max.X && inner.Max.Y <= outer.Max.Y && inner.Max.Z <= outer.Max.Z;
+		}
+
+		/* Returns the squared distance from a point to the farthest corner of a box. */
+		static float GetFarthestDistanceSquared(const BoundingBox& box, const Vector3D& point)
+		{
+			const float x = ReeeMath::Max(std::abs(point.X - box.Min.X), std::abs(point.X - box.Max.X));
+			const float y = ReeeMath::Max(std::abs(point.Y - box.Min.Y), std::abs(point.Y - box.Max.Y));
+			const float z = ReeeMath::Max(std::abs(point.Z - box.Min.Z), std::abs(point.Z - box.Max.Z));
+			return x * x + y * y + z * z;
+		}
+
+		/* Returns half the surface area of a box, the cost of a node is how likely a query is to have to look inside it. */
+		static float GetCost(const BoundingBox& box)
+		{
+			const Vector3D size = box.GetSize();
+			return size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+		}
+
+		/* Returns the union of two boxes. */
+		static BoundingBox GetUnion(const BoundingBox& a, const BoundingBox& b)
+		{
+			BoundingBox result = a;
+			result.Expand(b);
+			return result;
+		}
+
+		/* Returns a box grown by the leaf margin on every side. */
+		BoundingBox GetFatBounds(const BoundingBox& bounds) const
+		{
+			const Vector3D grow(margin);
+			return BoundingBox(bounds.Min - grow, bounds.Max + grow);
+		}
+
+		/* Take a node from the free list or add a new one. */
+		uint32_t AllocateNode()
+		{
+			uint32_t index;
+			if (freeHead != InvalidProxy)
+			{
+				index = freeHead;
+				freeHead = nodes[index].parent;
+			}
+			else
+			{
+				index = (uint32_t)nodes.size();
+				nodes.emplace_back();
+			}
+			Node& node = nodes[index];
+			node.parent = InvalidProxy;
+			node.child1 = InvalidProxy;
+			node.child2 = InvalidProxy;
+			node.height = 0;
+			node.dirty = false;
+			return index;
+		}
+
+		/* Put a node back on the free list. */
+		void FreeNode(uint32_t index)
+		{
+			nodes[index].parent = freeHead;
+			nodes[index].height = -1;
+			nodes[index].dirty = false;
+			freeHead = index;
+		}
+
+		/* Place a leaf next to the node that grows the tree the least, then fix the bounds and balance above it. */
+		void InsertLeaf(uint32_t leaf)
+		{
+			if (root == InvalidProxy)
+			{
+				root = leaf;
+				nodes[root].parent = InvalidProxy;
+				return;
+			}
+
+			// Walk down picking the child that costs the least to add the leaf under, stopping once making a new branch here is cheaper.
+			const BoundingBox leafBounds = nodes[leaf].bounds;
+			uint32_t index = root;
+			while (!nodes[index].IsLeaf())
+			{
+				const Node& node = nodes[index];
+				const float area = GetCost(node.bounds);
+				const float combinedArea = GetCost(GetUnion(node.bounds, leafBounds));
+				const float branchCost = 2.0f * combinedArea;
+				const float inheritanceCost = 2.0f * (combinedArea - area);
+				const float cost1 = GetChildCost(node.child1, leafBounds) + inheritanceCost;
+				const float cost2 = GetChildCost(node.child2, leafBounds) + inheritanceCost;
+				if (branchCost < cost1 && branchCost < cost2) break;
+				index = cost1 < cost2 ? node.child1 : node.child2;
+			}
+
+			// Join the leaf and the chosen node under a new branch.
+			const uint32_t sibling = index;
+			const uint32_t oldParent = nodes[sibling].parent;
+			const uint32_t newParent = AllocateNode();
+			nodes[newParent].parent = oldParent;
+			nodes[newParent].bounds = GetUnion(leafBounds, nodes[sibling].bounds);
+			nodes[newParent].height = nodes[sibling].height + 1;
+			nodes[newParent].child1 = sibling;
+			nodes[newParent].child2 = leaf;
+			nodes[sibling].parent = newParent;
+			nodes[leaf].parent = newParent;
+			if (oldParent == InvalidProxy) root = newParent;
+			else if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+			else nodes[oldParent].child2 = newParent;
+			FixUpwards(newParent);
+		}
+
+		/* Returns the cost of adding a leaf under a child node. */
+		float GetChildCost(uint32_t child, const BoundingBox& leafBounds) const
+		{
+			const Node& node = nodes[child];
+			const float combinedArea = GetCost(GetUnion(node.bounds, leafBounds));
+			return node.IsLeaf() ? combinedArea : combinedArea - GetCost(node.bounds);
+		}
+
+		/* Take a leaf out of the tree, its sibling takes the place of their parent. */
+		void RemoveLeaf(uint32_t leaf)
+		{
+			if (leaf == root)
+			{
+				root = InvalidProxy;
+				return;
+			}
+			const uint32_t parent = nodes[leaf].parent;
+			const uint32_t grandParent = nodes[parent].parent;
+			const uint32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+			FreeNode(parent);
+			if (grandParent == InvalidProxy)
+			{
+				root = sibling;
+				nodes[sibling].parent = InvalidProxy;
+				return;
+			}
+			if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+			else nodes[grandParent].child2 = sibling;
+			nodes[sibling].parent = grandParent;
+			FixUpwards(grandParent);
+		}
+
+		/* Balance each node from a branch up to the root and refresh their bounds and heights. */
+		void FixUpwards(uint32_t index)
+		{
+			while (index != InvalidProxy)
+			{
+				index = Balance(index);
+				Node& node = nodes[index];
+				node.height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+				node.bounds = GetUnion(nodes[node.child1].bounds, nodes[node.child2].bounds);
+				index = node.parent;
+			}
+		}
+
+		/* Rotate the taller child of a node up if its children differ in height by more than one. Returns the node now in its place. */
+		uint32_t Balance(uint32_t a)
+		{
+			Node& nodeA = nodes[a];
+			if (nodeA.IsLeaf() || nodeA.height < 2) return a;
+			const uint32_t b = nodeA.child1;
+			const uint32_t c = nodeA.child2;
+			const int32_t balance = nodes[c].height - nodes[b].height;
+			if (balance > 1) return Rotate(a, c, b, false);
+			if (balance < -1) return Rotate(a, b, c, true);
+			return a;
+		}
+
+		/* Move the tall child of a node up into its place, the node takes the shorter grandchild. Returns the tall child. */
+		uint32_t Rotate(uint32_t a, uint32_t tall, uint32_t shorter, bool tallIsChild1)
+		{
+			Node& nodeA = nodes[a];
+			Node& nodeTall = nodes[tall];
+			const uint32_t f = nodeTall.child1;
+			const uint32_t g = nodeTall.child2;
+
+			// The tall child takes the nodes place under its parent.
+			nodeTall.child1 = a;
+			nodeTall.parent = nodeA.parent;
+			nodeA.parent = tall;
+			if (nodeTall.parent == InvalidProxy) root = tall;
+			else if (nodes[nodeTall.parent].child1 == a) nodes[nodeTall.parent].child1 = tall;
+			else nodes[nodeTall.parent].child2 = tall;
+
+			// Keep the taller grandchild under the tall child and give the shorter one to the node.
+			const bool fTaller = nodes[f].height > nodes[g].height;
+			const uint32_t kept = fTaller ? f : g;
+			const uint32_t given = fTaller ? g : f;
+			nodeTall.child2 = kept;
+			if (tallIsChild1) nodeA.child1 = given;
+			else nodeA.child2 = given;
+			nodes[given].parent = a;
+			nodeA.bounds = GetUnion(nodes[shorter].bounds, nodes[given].bounds);
+			nodeTall.bounds = GetUnion(nodeA.bounds, nodes[kept].bounds);
+			nodeA.height = 1 + std::max(nodes[shorter].height, nodes[given].height);
+			nodeTall.height = 1 + std::max(nodeA.height, nodes[kept].height);
+			return tall;
+		}
+
+	private:
+
+		// Every node of the tree, free nodes included, and the root and first free node.
+		std::vector<Node> nodes;
+		uint32_t root;
+		uint32_t freeHead;
+
+		// Values queued to have their bounds updated by the next refit.
+		std::vector<uint32_t> dirtyProxies;
+
+		// How far each leafs bounds are grown past the bounds of its value.
+		float margin;
+
+		// Number of values in the index.
+		size_t count;
+	};
+}
\ No newline at end of file
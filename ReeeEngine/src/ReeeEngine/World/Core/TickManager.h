@@ -0,0 +1,454 @@
+#pragma once
+#include "TickSettings.h"
+#include "../../Threading/WorkerPool.h"
+#include <array>
+#include <vector>
+#include <string>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+
+namespace ReeeEngine
+{
+	/* Counters of the objects the last tick went through. */
+	struct TickStats
+	{
+		// Objects that were ticked.
+		uint32_t ticked = 0;
+
+		// Registered objects that were disabled or waiting for their tick interval.
+		uint32_t skipped = 0;
+
+		// Amortized objects ticked within the budget and ones whose turn was put off to a later frame as the budget ran out.
+		uint32_t amortized = 0;
+		uint32_t deferred = 0;
+
+		// Microseconds spent ticking amortized objects, including the time spent taking turns.
+		float amortizedMicroseconds = 0.0f;
+	};
+
+	/* Lists of the objects that need ticking, one per tick group.
+	 * Objects are only added if they can ever tick so objects with nothing to update cost nothing each frame.
+	 * The groups are ticked in order and each group is split into waves by the objects tick prerequisites, an object is only
+	 * ticked in a wave after every wave holding one of its prerequisites. Within a wave objects that have to tick on the game
+	 * thread are ticked first in the order they were registered, then objects that can run on any thread are spread across
+	 * the worker pool. Every wave finishes before the next starts so the order objects see each other in never changes.
+	 * Amortized objects are ticked after the waves of their group in turns, starting where the last frame stopped, until the frames
+	 * amortized budget is spent. Each objects average tick cost is tracked so the turn stops before an object that would go over
+	 * the budget instead of after it. At least one due object of each group is ticked every frame so every object gets its turn.
+	 * Entries keep the frame and time of their last tick instead of counting up every frame so objects waiting their turn cost nothing.
+	 * NOTE: Objects registered while ticking start ticking the next frame, objects unregistered while ticking are skipped.
+	 *       The budget is shared by every group in order so amortized objects in earlier groups are ticked first.
+	 *       T is the ticked object type, the engine uses it as TickManager over Object. Any type with the same tick members
+	 *       (name, tickSettings, tickManager, tickIndex, tickPrerequisites, CanEverTick and Tick) works so the scheduling can
+	 *       be ran without the engine. */
+	template<class T>
+	class BasicTickManager
+	{
+		/* Allow objects to update their own tick entry. */
+		friend T;
+
+	public:
+
+		/* Function given the warnings found while scheduling, e.g. tick prerequisite loops. */
+		typedef std::function<void(const std::string&)> WarningFunction;
+
+		/* Setup empty tick lists. */
+		BasicTickManager() : needsCompact(false), needsSchedule(false), amortizedBudget(DefaultAmortizedBudget) {}
+		BasicTickManager(const BasicTickManager&) = delete;
+		BasicTickManager& operator=(const BasicTickManager&) = delete;
+
+		/* Unregister every object still registered so none are left pointing at this manager. */
+		~BasicTickManager()
+		{
+			for (auto& entries : groups)
+			{
+				for (TickEntry& entry : entries)
+				{
+					if (entry.object) entry.object->tickManager = nullptr;
+				}
+			}
+		}
+
+		/* Add an object to the list of its tick group using its tick settings. Does nothing if the object can never tick or is already registered. */
+		void Register(T* object)
+		{
+			if (!object || object->tickManager || !object->CanEverTick()) return;
+
+			// Start objects that skip frames at different points so they don't all tick on the same frame.
+			const TickSettings& settings = object->tickSettings;
+			auto& entries = groups[(size_t)settings.group];
+			TickEntry entry;
+			entry.object = object;
+			entry.frameInterval = std::max(1u, settings.frameInterval);
+			entry.lastTickFrame = frameNumber - entries.size() % entry.frameInterval;
+			entry.secondsInterval = settings.secondsInterval;
+			entry.lastTickTime = tickTime;
+			entry.enabled = settings.enabled;
+			entry.averageCost = 0.0f;
+			object->tickManager = this;
+			object->tickIndex = (uint32_t)entries.size();
+			entries.push_back(entry);
+			needsSchedule = true;
+		}
+
+		/* Remove an object from its tick list. */
+		void Unregister(T* object)
+		{
+			if (!object || object->tickManager != this) return;
+
+			// Leave a gap so a list being ticked is not changed under it, the gaps are removed at the end of the tick.
+			groups[(size_t)object->tickSettings.group][object->tickIndex].object = nullptr;
+			object->tickManager = nullptr;
+			needsCompact = true;
+			needsSchedule = true;
+		}
+
+		/* Tick every enabled object whose tick interval has passed, group by group and wave by wave.
+		 * Objects that can tick on any thread are spread across the pool, the shared engine pool when none is given. */
+		void Tick(float deltaTime, WorkerPool* pool = nullptr)
+		{
+			if (needsSchedule) BuildSchedule();
+			frameNumber++;
+			tickTime += deltaTime;
+			WorkerPool& workers = pool ? *pool : WorkerPool::GetShared();
+			TickStats stats;
+			float amortizedSpent = 0.0f;
+			for (size_t group = 0; group < TickGroupCount; group++)
+			{
+				for (const TickWave& wave : schedules[group])
+				{
+					// Game thread objects first as they are free to change anything the other objects read.
+					for (uint32_t index : wave.gameThreadEntries)
+					{
+						T* object;
+						float tickDeltaTime;
+						if (!TakeTick(groups[group][index], object, tickDeltaTime, stats)) continue;
+						object->Tick(tickDeltaTime);
+					}
+
+					// Gather the due objects before starting the workers so the entries are only changed on this thread.
+					dueObjects.clear();
+					for (uint32_t index : wave.anyThreadEntries)
+					{
+						T* object;
+						float tickDeltaTime;
+						if (!TakeTick(groups[group][index], object, tickDeltaTime, stats)) continue;
+						dueObjects.push_back({ object, tickDeltaTime });
+					}
+					workers.ParallelFor(dueObjects.size(), ParallelTickBatchSize, [this](size_t begin, size_t end)
+					{
+						for (size_t i = begin; i < end; i++) dueObjects[i].object->Tick(dueObjects[i].deltaTime);
+					});
+				}
+				TickAmortized(group, amortizedSpent, stats);
+			}
+			if (needsCompact) Compact();
+			lastStats = stats;
+		}
+
+		/* Set the function given scheduling warnings, they are dropped when none is set. */
+		void SetWarningFunction(const WarningFunction& function) { warningFunction = function; }
+
+		/* Microseconds each frame can spend ticking amortized objects. */
+		void SetAmortizedBudget(float microseconds) { amortizedBudget = std::max(0.0f, microseconds); }
+		float GetAmortizedBudget() const { return amortizedBudget; }
+
+		/* Returns the counters of the last tick. */
+		const TickStats& GetStats() const
+		{
+			return lastStats;
+		}
+
+		/* Returns the number of registered objects. */
+		size_t GetRegisteredCount() const
+		{
+			size_t count = 0;
+			for (const auto& entries : groups) count += GetLiveCount(entries);
+			return count;
+		}
+
+	private:
+
+		// Fewest objects a worker is given at once, ticks are usually short so smaller batches cost more to hand out than they save.
+		static constexpr size_t ParallelTickBatchSize = 64;
+
+		// Default amortized tick budget in microseconds, a tenth of a 60hz frame.
+		static constexpr float DefaultAmortizedBudget = 1500.0f;
+
+		// How much of each new tick cost is blended into an objects average, low enough that one slow tick does not hold it back for long.
+		static constexpr float TickCostBlend = 0.25f;
+
+		/* A registered object and its tick state. */
+		struct TickEntry
+		{
+			T* object;
+			uint32_t frameInterval;
+			float secondsInterval;
+			bool enabled;
+
+			// Frame number and tick time the object last ticked or started waiting at.
+			uint64_t lastTickFrame;
+			double lastTickTime;
+
+			// Average microseconds the objects tick takes, only tracked for amortized objects.
+			float averageCost;
+		};
+
+		/* Objects of a tick group that can tick at the same time, by their index in the groups list. */
+		struct TickWave
+		{
+			std::vector<uint32_t> gameThreadEntries;
+			std::vector<uint32_t> anyThreadEntries;
+		};
+
+		/* An object due a tick this wave and the time since its last tick. */
+		struct DueTick
+		{
+			T* object;
+			float deltaTime;
+		};
+
+		/* If an entry is due a tick mark it as ticked this frame and return the object to tick with the time since its last tick. */
+		bool TakeTick(TickEntry& entry, T*& object, float& tickDeltaTime, TickStats& stats)
+		{
+			if (!entry.object) return false;
+			if (!IsDue(entry))
+			{
+				stats.skipped++;
+				return false;
+			}
+
+			// Reset before ticking as the tick can register new objects and move the list.
+			object = entry.object;
+			tickDeltaTime = (float)(tickTime - entry.lastTickTime);
+			RestartTickInterval(entry);
+			stats.ticked++;
+			return true;
+		}
+
+		/* Returns if an entry is enabled and its tick intervals have passed. */
+		bool IsDue(const TickEntry& entry) const
+		{
+			return entry.enabled && frameNumber - entry.lastTickFrame >= entry.frameInterval && tickTime - entry.lastTickTime >= entry.secondsInterval;
+		}
+
+		/* Start an entries tick intervals again from this frame. */
+		void RestartTickInterval(TickEntry& entry) const
+		{
+			entry.lastTickFrame = frameNumber;
+			entry.lastTickTime = tickTime;
+		}
+
+		/* Tick the amortized objects of a group in turns until the frames budget is spent, carrying on from where the last frame stopped.
+		 * Everything from the start of the turns on is charged to the budget so the time spent skipping objects counts too. */
+		void TickAmortized(size_t group, float& spent, TickStats& stats)
+		{
+			const std::vector<uint32_t>& turns = amortizedSchedules[group];
+			if (turns.empty()) return;
+
+			size_t& cursor = amortizedCursors[group];
+			if (cursor >= turns.size()) cursor = 0;
+			const size_t start = cursor;
+			const float spentBefore = spent;
+			const auto turnsStart = std::chrono::steady_clock::now();
+			auto tickStart = turnsStart;
+			bool tickedAny = false;
+			size_t turn = 0;
+			for (; turn < turns.size(); turn++)
+			{
+				const size_t position = (start + turn) % turns.size();
+				const uint32_t index = turns[position];
+				TickEntry& entry = groups[group][index];
+				if (!entry.object) continue;
+				if (!IsDue(entry))
+				{
+					stats.skipped++;
+					continue;
+				}
+
+				// Stop before an object expected to go over the budget, it is the first to tick next frame.
+				if (tickedAny && (spent >= amortizedBudget || spent + entry.averageCost > amortizedBudget))
+				{
+					cursor = position;
+					break;
+				}
+
+				// Reset before ticking as the tick can register new objects and move the list.
+				T* object = entry.object;
+				const float tickDeltaTime = (float)(tickTime - entry.lastTickTime);
+				RestartTickInterval(entry);
+				object->Tick(tickDeltaTime);
+				const auto tickEnd = std::chrono::steady_clock::now();
+				const float cost = std::chrono::duration<float, std::micro>(tickEnd - tickStart).count();
+				float& averageCost = groups[group][index].averageCost;
+				averageCost = averageCost > 0.0f ? averageCost + (cost - averageCost) * TickCostBlend : cost;
+				spent = spentBefore + std::chrono::duration<float, std::micro>(tickEnd - turnsStart).count();
+				tickStart = tickEnd;
+				tickedAny = true;
+				stats.ticked++;
+				stats.amortized++;
+			}
+
+			// Every object whose turn did not come up waits for a later frame.
+			stats.deferred += (uint32_t)(turns.size() - turn);
+			stats.amortizedMicroseconds += spent - spentBefore;
+		}
+
+		/* Split every group into waves so each object is in a later wave than its prerequisites in the same group.
+		 * Prerequisites in an earlier group have always ticked first and ones in a later group can never tick first so they are
+		 * left out with a warning. Objects stuck in a prerequisite loop are ticked in a last wave of their own on the game thread. */
+		void BuildSchedule()
+		{
+			for (size_t group = 0; group < TickGroupCount; group++)
+			{
+				const auto& entries = groups[group];
+				const uint32_t count = (uint32_t)entries.size();
+				auto& waves = schedules[group];
+				waves.clear();
+				auto& turns = amortizedSchedules[group];
+				turns.clear();
+
+				// Count the prerequisites each object waits on in this group and list who waits on each object.
+				std::vector<uint32_t> waitingOn(count, 0);
+				std::vector<std::vector<uint32_t>> dependents(count);
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const T* object = entries[i].object;
+					if (!object) continue;
+
+					// Amortized objects take turns after every wave of their group so their prerequisites have always ticked.
+					if (object->tickSettings.amortized)
+					{
+						turns.push_back(i);
+						continue;
+					}
+					for (const T* prerequisite : object->tickPrerequisites)
+					{
+						if (prerequisite->tickManager != this) continue;
+						const size_t prerequisiteGroup = (size_t)prerequisite->tickSettings.group;
+						if (prerequisiteGroup > group)
+						{
+							Warn("TickManager: " + object->name + " ticks in an earlier group than its prerequisite " + prerequisite->name + ", the prerequisite is ignored.");
+							continue;
+						}
+						if (prerequisiteGroup < group) continue;
+						if (prerequisite->tickSettings.amortized)
+						{
+							Warn("TickManager: " + prerequisite->name + " is amortized so ticks after " + object->name + " in the same group, the prerequisite is ignored.");
+							continue;
+						}
+						dependents[prerequisite->tickIndex].push_back(i);
+						waitingOn[i]++;
+					}
+				}
+
+				// Peel off the objects with nothing left to wait on one wave at a time, keeping them in registration order.
+				std::vector<uint32_t> ready;
+				for (uint32_t i = 0; i < count; i++)
+				{
+					if (entries[i].object && !entries[i].object->tickSettings.amortized && waitingOn[i] == 0) ready.push_back(i);
+				}
+				uint32_t scheduled = 0;
+				while (!ready.empty())
+				{
+					waves.emplace_back();
+					TickWave& wave = waves.back();
+					std::vector<uint32_t> next;
+					for (uint32_t index : ready)
+					{
+						(entries[index].object->tickSettings.runOnAnyThread ? wave.anyThreadEntries : wave.gameThreadEntries).push_back(index);
+						for (uint32_t dependent : dependents[index])
+						{
+							if (--waitingOn[dependent] == 0) next.push_back(dependent);
+						}
+					}
+					scheduled += (uint32_t)ready.size();
+					std::sort(next.begin(), next.end());
+					ready = std::move(next);
+				}
+
+				// Anything left waits on itself through a loop of prerequisites.
+				if (scheduled + turns.size() < GetLiveCount(entries))
+				{
+					waves.emplace_back();
+					for (uint32_t i = 0; i < count; i++)
+					{
+						if (!entries[i].object || entries[i].object->tickSettings.amortized || waitingOn[i] == 0) continue;
+						Warn("TickManager: " + entries[i].object->name + " is part of a tick prerequisite loop, the loop is ticked in registration order.");
+						waves.back().gameThreadEntries.push_back(i);
+					}
+				}
+			}
+			needsSchedule = false;
+		}
+
+		/* Pass a scheduling warning to the warning function if there is one. */
+		void Warn(const std::string& message) const
+		{
+			if (warningFunction) warningFunction(message);
+		}
+
+		/* Returns the number of entries of a list that are still registered. */
+		static uint32_t GetLiveCount(const std::vector<TickEntry>& entries)
+		{
+			uint32_t count = 0;
+			for (const TickEntry& entry : entries) count += entry.object ? 1 : 0;
+			return count;
+		}
+
+		/* Returns the entry of a registered object. */
+		TickEntry& GetEntry(const T* object)
+		{
+			return groups[(size_t)object->tickSettings.group][object->tickIndex];
+		}
+
+		/* Remove the gaps left by unregistered objects, keeping the rest in the order they were registered. */
+		void Compact()
+		{
+			for (auto& entries : groups)
+			{
+				size_t kept = 0;
+				for (size_t i = 0; i < entries.size(); i++)
+				{
+					if (!entries[i].object) continue;
+					entries[i].object->tickIndex = (uint32_t)kept;
+					entries[kept++] = entries[i];
+				}
+				entries.resize(kept);
+			}
+			needsCompact = false;
+			needsSchedule = true;
+		}
+
+	private:
+
+		// Registered objects of each tick group.
+		std::array<std::vector<TickEntry>, TickGroupCount> groups;
+
+		// If objects have been unregistered since the last compact.
+		bool needsCompact;
+
+		// Waves of each tick group and if they need building again since objects or prerequisites have changed.
+		std::array<std::vector<TickWave>, TickGroupCount> schedules;
+		bool needsSchedule;
+
+		// Amortized objects of each tick group in turn order, where the next frames turn starts and the budget they share.
+		std::array<std::vector<uint32_t>, TickGroupCount> amortizedSchedules;
+		std::array<size_t, TickGroupCount> amortizedCursors = {};
+		float amortizedBudget;
+
+		// Number of the frame being ticked and the total time ticked so far, entries are due by how far these are past their last tick.
+		uint64_t frameNumber = 0;
+		double tickTime = 0.0;
+
+		// Objects due a tick in the wave being ticked on the worker pool.
+		std::vector<DueTick> dueObjects;
+
+		// Counters of the last tick.
+		TickStats lastStats;
+
+		// Given the warnings found while scheduling.
+		WarningFunction warningFunction;
+	};
+}
\ No newline at end of file
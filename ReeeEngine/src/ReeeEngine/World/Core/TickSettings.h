@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+namespace ReeeEngine
+{
+	/* Groups ticked objects are split into. Every object in a group is ticked before the next group starts. */
+	enum class TickGroup : uint8_t
+	{
+		PrePhysics,
+		DuringPhysics,
+		PostPhysics,
+		PostUpdate,
+		PreRender
+	};
+	constexpr size_t TickGroupCount = 5;
+
+	/* How and when an object is ticked. */
+	struct TickSettings
+	{
+		// Only objects that can ever tick are registered with the world to be ticked, so nothing is spent on objects with empty ticks.
+		bool canEverTick = false;
+
+		// If the object is ticked while it is registered, can be changed at any time with SetTickEnabled.
+		bool enabled = true;
+
+		// Group the object is ticked in.
+		TickGroup group = TickGroup::DuringPhysics;
+
+		// Lets the object tick on a worker thread alongside other objects in the same wave of its group.
+		// NOTE: Only for ticks that write nothing but the objects own data, they must not move scene components, spawn or
+		//       destroy objects or change tick settings as none of those are safe to do from more than one thread.
+		bool runOnAnyThread = false;
+
+		// Lets the object be put off to a later frame once the frames amortized tick budget is spent, for expensive ticks that
+		// can run late such as AI. Amortized objects take turns ticking after the rest of their group on the game thread and are
+		// given the time since their last tick, so they can't be a prerequisite of another object in the same group.
+		// NOTE: Like the group this is read when the object is registered.
+		bool amortized = false;
+
+		// Tick at most every frameInterval frames and every secondsInterval seconds, the defaults tick every frame.
+		// NOTE: An object that skips frames is given the time since its last tick as its delta time.
+		uint32_t frameInterval = 1;
+		float secondsInterval = 0.0f;
+	};
+}
\ No newline at end of file
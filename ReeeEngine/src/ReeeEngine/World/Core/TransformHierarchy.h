@@ -0,0 +1,494 @@
+#pragma once
+#include "../../Math/Transform.h"
+#include "../../Threading/WorkerPool.h"
+#include <vector>
+#include <cstdint>
+
+namespace ReeeEngine
+{
+	class SceneComponent;
+
+	/* Flat store of every scene components transform in the world.
+	 * Local transforms, parent slots and world transforms are kept in contiguous arrays ordered so a parent always comes
+	 * before its children, letting every world transform be updated in one linear sweep. Components hold a stable handle
+	 * into the store while the slots behind the handles are re-sorted by depth whenever a re-attach breaks that order.
+	 * NOTE: Attach, detach and removal only relink a few indices so they are O(1), the re-sort is O(n) and done lazily.
+	 *       Large hierarchies can also be updated with the root subtrees split across a worker pool. */
+	class TransformHierarchy
+	{
+	public:
+
+		/* Stable handle of a node in the hierarchy. */
+		typedef uint32_t Handle;
+		static constexpr Handle InvalidHandle = 0xFFFFFFFFu;
+
+		/* Setup an empty hierarchy. */
+		TransformHierarchy() : removedSlots(0), rootSlotCount(0), orderDirty(false), depthSorted(true) {}
+
+		/* The hierarchy owns its nodes so it can't be copied. */
+		TransformHierarchy(const TransformHierarchy&) = delete;
+		TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+		/* Add a new root node with an identity transform and return its handle. */
+		Handle Add(SceneComponent* owner = nullptr)
+		{
+			Handle handle;
+			if (!freeHandles.empty())
+			{
+				handle = freeHandles.back();
+				freeHandles.pop_back();
+			}
+			else
+			{
+				handle = (Handle)nodes.size();
+				nodes.emplace_back();
+			}
+
+			// Appending a root never breaks the parent before child order, but only keeps the roots together if there is nothing else yet.
+			if (depthSorted && rootSlotCount == slotHandles.size()) rootSlotCount++;
+			else depthSorted = false;
+			Node& node = nodes[handle];
+			node = Node();
+			node.slot = (uint32_t)slotHandles.size();
+			node.owner = owner;
+			node.alive = true;
+			localTransforms.emplace_back();
+			worldTransforms.emplace_back();
+			parentSlots.push_back(InvalidHandle);
+			slotHandles.push_back(handle);
+			dirtyFlags.push_back(0);
+			return handle;
+		}
+
+		/* Remove a node. Its children become roots that keep their world transforms. */
+		void Remove(Handle handle)
+		{
+			if (!IsValid(handle)) return;
+
+			while (nodes[handle].firstChild != InvalidHandle)
+			{
+				const Handle child = nodes[handle].firstChild;
+				const Transform childWorld = GetWorld(child);
+				Detach(child);
+				localTransforms[nodes[child].slot] = childWorld;
+			}
+			Detach(handle);
+
+			// Leave a hole in the slot arrays, they are compacted by the next re-sort.
+			Node& node = nodes[handle];
+			slotHandles[node.slot] = InvalidHandle;
+			dirtyFlags[node.slot] = 0;
+			node = Node();
+			freeHandles.push_back(handle);
+			removedSlots++;
+		}
+
+		/* Attach a node to a new parent keeping its local transform. Fails if it would create a loop. */
+		bool Attach(Handle child, Handle parent)
+		{
+			if (!IsValid(child) || !IsValid(parent) || IsAncestorOf(child, parent)) return false;
+			if (nodes[child].parent == parent) return true;
+			Detach(child);
+
+			// Link at the end of the parents children so they keep the order they were attached in.
+			Node& childNode = nodes[child];
+			Node& parentNode = nodes[parent];
+			childNode.parent = parent;
+			childNode.prevSibling = parentNode.lastChild;
+			if (parentNode.lastChild != InvalidHandle) nodes[parentNode.lastChild].nextSibling = child;
+			else parentNode.firstChild = child;
+			parentNode.lastChild = child;
+			parentNode.childCount++;
+			parentSlots[childNode.slot] = parentNode.slot;
+
+			// Children below a parent already later in the arrays can stay where they are, otherwise re-sort before the next sweep.
+			if (parentNode.slot > childNode.slot) orderDirty = true;
+			depthSorted = false;
+			MarkDirty(child);
+			return true;
+		}
+
+		/* Detach a node from its parent making it a root. Keeps its local transform. */
+		void Detach(Handle child)
+		{
+			if (!IsValid(child)) return;
+			Node& childNode = nodes[child];
+			if (childNode.parent == InvalidHandle) return;
+
+			// Unlink from the parents children.
+			Node& parentNode = nodes[childNode.parent];
+			if (childNode.prevSibling != InvalidHandle) nodes[childNode.prevSibling].nextSibling = childNode.nextSibling;
+			else parentNode.firstChild = childNode.nextSibling;
+			if (childNode.nextSibling != InvalidHandle) nodes[childNode.nextSibling].prevSibling = childNode.prevSibling;
+			else parentNode.lastChild = childNode.prevSibling;
+			parentNode.childCount--;
+
+			childNode.parent = InvalidHandle;
+			childNode.prevSibling = InvalidHandle;
+			childNode.nextSibling = InvalidHandle;
+			parentSlots[childNode.slot] = InvalidHandle;
+			depthSorted = false;
+			MarkDirty(child);
+		}
+
+		/* Returns if the handle points at a node in the hierarchy. */
+		bool IsValid(Handle handle) const
+		{
+			return handle < nodes.size() && nodes[handle].alive;
+		}
+
+		/* Returns if ancestor is the node itself or any of its parents. */
+		bool IsAncestorOf(Handle ancestor, Handle handle) const
+		{
+			for (Handle current = handle; current != InvalidHandle; current = nodes[current].parent)
+			{
+				if (current == ancestor) return true;
+			}
+			return false;
+		}
+
+		/* Hierarchy link getters. Return InvalidHandle when there is no such node. */
+		Handle GetParent(Handle handle) const { return nodes[handle].parent; }
+		Handle GetFirstChild(Handle handle) const { return nodes[handle].firstChild; }
+		Handle GetNextSibling(Handle handle) const { return nodes[handle].nextSibling; }
+		uint32_t GetChildCount(Handle handle) const { return nodes[handle].childCount; }
+
+		/* Returns the component that owns a node, or nullptr for an invalid handle. */
+		SceneComponent* GetOwner(Handle handle) const
+		{
+			return handle < nodes.size() ? nodes[handle].owner : nullptr;
+		}
+
+		/* Returns the number of nodes in the hierarchy. */
+		size_t GetCount() const
+		{
+			return slotHandles.size() - removedSlots;
+		}
+
+		/* Get the transform of a node relative to its parent. */
+		const Transform& GetLocal(Handle handle) const
+		{
+			return localTransforms[nodes[handle].slot];
+		}
+
+		/* Returns the local transform of a node to be changed in place. The node is marked dirty. */
+		Transform& EditLocal(Handle handle)
+		{
+			MarkDirty(handle);
+			nodes[handle].changeCount++;
+			return localTransforms[nodes[handle].slot];
+		}
+
+		/* Set the transform of a node relative to its parent. */
+		void SetLocal(Handle handle, const Transform& newLocal)
+		{
+			EditLocal(handle) = newLocal;
+		}
+
+		/* Set the world transform of a node in one step, storing it relative to the parent.
+		 * NOTE: Roots keep the given transform exactly, including its rotator. */
+		void SetWorld(Handle handle, const Transform& newWorld)
+		{
+			const Handle parent = nodes[handle].parent;
+			if (parent == InvalidHandle) SetLocal(handle, newWorld);
+			else SetLocal(handle, newWorld.GetRelativeTo(GetWorld(parent)));
+		}
+
+		/* Get the world transform of a node, only resolving it and its dirty parents if it has changed. */
+		const Transform& GetWorld(Handle handle)
+		{
+			const uint32_t slot = nodes[handle].slot;
+			if (dirtyFlags[slot])
+			{
+				// A clean node always has clean parents so only walk up until one is found, then resolve top down.
+				resolveChain.clear();
+				for (uint32_t current = slot; current != InvalidHandle && dirtyFlags[current]; current = parentSlots[current])
+				{
+					resolveChain.push_back(current);
+				}
+				for (auto it = resolveChain.rbegin(); it != resolveChain.rend(); ++it)
+				{
+					ResolveSlot(*it);
+				}
+			}
+			return worldTransforms[slot];
+		}
+
+		/* Flag the world transform of a node and everything attached below it as out of date and queue it as changed.
+		 * NOTE: Stops at nodes that are already dirty as their children are always dirty too. */
+		void MarkDirty(Handle handle)
+		{
+			dirtyStack.push_back(handle);
+			while (!dirtyStack.empty())
+			{
+				const Handle current = dirtyStack.back();
+				dirtyStack.pop_back();
+
+				Node& node = nodes[current];
+				if (dirtyFlags[node.slot]) continue;
+				dirtyFlags[node.slot] = 1;
+				if (!node.changed)
+				{
+					node.changed = true;
+					changedHandles.push_back(current);
+				}
+
+				for (Handle child = node.firstChild; child != InvalidHandle; child = nodes[child].nextSibling)
+				{
+					dirtyStack.push_back(child);
+				}
+			}
+		}
+
+		/* Flag every node as dirty and changed, e.g. after everything has been moved by a shift of the world origin. */
+		void MarkAllDirty()
+		{
+			for (uint32_t slot = 0; slot < (uint32_t)slotHandles.size(); slot++)
+			{
+				const Handle handle = slotHandles[slot];
+				if (handle == InvalidHandle) continue;
+				dirtyFlags[slot] = 1;
+				if (!nodes[handle].changed)
+				{
+					nodes[handle].changed = true;
+					changedHandles.push_back(handle);
+				}
+			}
+		}
+
+		/* Returns how many times this node and its parents have been changed since the node was last consumed as changed.
+		 * NOTE: Each of these would have been a separate update of the node if changes were applied straight away. */
+		uint32_t GetChangeCount(Handle handle) const
+		{
+			uint32_t changeCount = 0;
+			for (Handle current = handle; current != InvalidHandle; current = nodes[current].parent)
+			{
+				changeCount += nodes[current].changeCount;
+			}
+			return changeCount;
+		}
+
+		/* Returns the number of nodes changed since they were last consumed, which is at least how many nodes are dirty. */
+		size_t GetChangedCount() const
+		{
+			return changedHandles.size();
+		}
+
+		/* Returns if the world transform of a node needs to be recalculated before it is next used. */
+		bool IsDirty(Handle handle) const
+		{
+			return dirtyFlags[nodes[handle].slot] != 0;
+		}
+
+		/* Recalculate every dirty world transform in one sweep over the slot arrays. */
+		void UpdateWorldTransforms()
+		{
+			if (orderDirty || removedSlots > slotHandles.size() / 2) SortByDepth();
+
+			// Parents always come first so their world transform is up to date by the time their children are reached.
+			const uint32_t slotCount = (uint32_t)slotHandles.size();
+			for (uint32_t slot = 0; slot < slotCount; slot++)
+			{
+				if (dirtyFlags[slot]) ResolveSlot(slot);
+			}
+		}
+
+		/* Recalculate every dirty world transform with the subtrees of the roots split across a worker pool.
+		 * NOTE: Each node is composed from its parents world transform exactly like UpdateWorldTransforms does, so the result is
+		 *       the same no matter how many threads are used. Changes made while this runs are not allowed. */
+		void UpdateWorldTransformsParallel(WorkerPool& pool, size_t minRootsPerTask = ParallelRootBatchSize)
+		{
+			// Roots are only next to each other at the start of the slot arrays once sorted by depth.
+			if (orderDirty || !depthSorted || removedSlots > slotHandles.size() / 2) SortByDepth();
+
+			// Each task walks whole root subtrees, so a node is always resolved after its parent by the same thread.
+			pool.ParallelFor(rootSlotCount, minRootsPerTask, [this](size_t begin, size_t end)
+			{
+				static thread_local std::vector<Handle> stack;
+				for (size_t rootSlot = begin; rootSlot < end; rootSlot++)
+				{
+					if (slotHandles[rootSlot] == InvalidHandle) continue;
+					stack.push_back(slotHandles[rootSlot]);
+					while (!stack.empty())
+					{
+						const Node& node = nodes[stack.back()];
+						stack.pop_back();
+						if (dirtyFlags[node.slot]) ResolveSlot(node.slot);
+						for (Handle child = node.firstChild; child != InvalidHandle; child = nodes[child].nextSibling)
+						{
+							stack.push_back(child);
+						}
+					}
+				}
+			});
+		}
+
+		/* Call function(handle) once for every node changed since the last call.
+		 * NOTE: Only the nodes changed so far are visited, anything changed from inside the function is left for the next call. */
+		template<class Function>
+		void ConsumeChanged(Function&& function)
+		{
+			const size_t changedCount = changedHandles.size();
+			for (size_t i = 0; i < changedCount; i++)
+			{
+				const Handle handle = changedHandles[i];
+				if (!IsValid(handle) || !nodes[handle].changed) continue;
+
+				// Resolve first as a node that is still dirty would not queue itself again if it is moved from inside the function.
+				GetWorld(handle);
+				nodes[handle].changed = false;
+				function(handle);
+			}
+
+			// Change counts are summed over parents so they can only be cleared once every changed node has been visited.
+			for (size_t i = 0; i < changedCount; i++)
+			{
+				if (IsValid(changedHandles[i])) nodes[changedHandles[i]].changeCount = 0;
+			}
+			changedHandles.erase(changedHandles.begin(), changedHandles.begin() + changedCount);
+		}
+
+		/* Clear the changed state of a single node returning if it had changed. */
+		bool ConsumeChanged(Handle handle)
+		{
+			if (!IsValid(handle) || !nodes[handle].changed) return false;
+			GetWorld(handle);
+			nodes[handle].changed = false;
+			return true;
+		}
+
+	private:
+
+		/* Per handle links of a node. These never move so handles stay valid when the slots are re-sorted. */
+		struct Node
+		{
+			uint32_t slot = InvalidHandle;
+			Handle parent = InvalidHandle;
+			Handle firstChild = InvalidHandle;
+			Handle lastChild = InvalidHandle;
+			Handle prevSibling = InvalidHandle;
+			Handle nextSibling = InvalidHandle;
+			uint32_t childCount = 0;
+			uint32_t changeCount = 0;
+			SceneComponent* owner = nullptr;
+			bool changed = false;
+			bool alive = false;
+		};
+
+		/* Rebuild the world transform of a slot from its parents. The parent must already be resolved. */
+		void ResolveSlot(uint32_t slot)
+		{
+			const uint32_t parentSlot = parentSlots[slot];
+			if (parentSlot == InvalidHandle) worldTransforms[slot] = localTransforms[slot];
+			else worldTransforms[slot] = localTransforms[slot].GetComposed(worldTransforms[parentSlot]);
+			dirtyFlags[slot] = 0;
+		}
+
+		/* Re-sort the slot arrays by depth with a stable counting sort and remove the holes left by removed nodes. */
+		void SortByDepth()
+		{
+			const uint32_t slotCount = (uint32_t)slotHandles.size();
+
+			// Work out the depth of every node, walking up until a node with a known depth is found.
+			std::vector<uint32_t> depths(nodes.size(), InvalidHandle);
+			uint32_t maxDepth = 0;
+			for (uint32_t slot = 0; slot < slotCount; slot++)
+			{
+				const Handle handle = slotHandles[slot];
+				if (handle == InvalidHandle) continue;
+
+				resolveChain.clear();
+				Handle current = handle;
+				while (current != InvalidHandle && depths[current] == InvalidHandle)
+				{
+					resolveChain.push_back(current);
+					current = nodes[current].parent;
+				}
+				uint32_t depth = current == InvalidHandle ? 0 : depths[current] + 1;
+				for (auto it = resolveChain.rbegin(); it != resolveChain.rend(); ++it, depth++)
+				{
+					depths[*it] = depth;
+				}
+				maxDepth = depths[handle] > maxDepth ? depths[handle] : maxDepth;
+			}
+
+			// Count the nodes at each depth to find where each depth starts, the roots being the first.
+			std::vector<uint32_t> depthStarts(maxDepth + 2, 0);
+			for (uint32_t slot = 0; slot < slotCount; slot++)
+			{
+				if (slotHandles[slot] != InvalidHandle) depthStarts[depths[slotHandles[slot]] + 1]++;
+			}
+			for (uint32_t depth = 1; depth < depthStarts.size(); depth++)
+			{
+				depthStarts[depth] += depthStarts[depth - 1];
+			}
+			rootSlotCount = depthStarts[1];
+
+			// Move every node into its new slot.
+			const uint32_t newCount = (uint32_t)GetCount();
+			std::vector<Transform> newLocals(newCount);
+			std::vector<Transform> newWorlds(newCount);
+			std::vector<Handle> newHandles(newCount);
+			std::vector<uint8_t> newDirty(newCount);
+			for (uint32_t slot = 0; slot < slotCount; slot++)
+			{
+				const Handle handle = slotHandles[slot];
+				if (handle == InvalidHandle) continue;
+
+				const uint32_t newSlot = depthStarts[depths[handle]]++;
+				newLocals[newSlot] = localTransforms[slot];
+				newWorlds[newSlot] = worldTransforms[slot];
+				newHandles[newSlot] = handle;
+				newDirty[newSlot] = dirtyFlags[slot];
+				nodes[handle].slot = newSlot;
+			}
+			localTransforms.swap(newLocals);
+			worldTransforms.swap(newWorlds);
+			slotHandles.swap(newHandles);
+			dirtyFlags.swap(newDirty);
+
+			// Parent slots can only be filled in once every node has moved.
+			parentSlots.assign(newCount, InvalidHandle);
+			for (uint32_t slot = 0; slot < newCount; slot++)
+			{
+				const Handle parent = nodes[slotHandles[slot]].parent;
+				if (parent != InvalidHandle) parentSlots[slot] = nodes[parent].slot;
+			}
+
+			removedSlots = 0;
+			orderDirty = false;
+			depthSorted = true;
+		}
+
+	private:
+
+		// Minimum number of root subtrees given to each task of a parallel update.
+		static const size_t ParallelRootBatchSize = 16;
+
+		// Per slot arrays ordered so parents come before their children. Removed nodes leave an InvalidHandle in slotHandles.
+		std::vector<Transform> localTransforms;
+		std::vector<Transform> worldTransforms;
+		std::vector<uint32_t> parentSlots;
+		std::vector<Handle> slotHandles;
+		std::vector<uint8_t> dirtyFlags;
+
+		// Per handle links and handles free to be reused.
+		std::vector<Node> nodes;
+		std::vector<Handle> freeHandles;
+
+		// Nodes changed since the last ConsumeChanged, duplicates are skipped using the nodes changed flag.
+		std::vector<Handle> changedHandles;
+
+		// Scratch arrays reused between calls to avoid allocating.
+		std::vector<uint32_t> resolveChain;
+		std::vector<Handle> dirtyStack;
+
+		// Number of holes in the slot arrays and the number of roots at the start of them while depthSorted is true.
+		size_t removedSlots;
+		size_t rootSlotCount;
+
+		// If the parent before child order needs restoring and if the slots are still grouped by depth.
+		bool orderDirty;
+		bool depthSorted;
+	};
+}
\ No newline at end of file
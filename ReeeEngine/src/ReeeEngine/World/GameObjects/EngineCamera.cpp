@@ -7,6 +7,9 @@ namespace ReeeEngine
 {
 	EngineCamera::EngineCamera(const std::string& name) : GameObject(name)
 	{
+		// Ticks to move the camera from input.
+		tickSettings.canEverTick = true;
+
 		camera = CreateSubobject<CameraComponent>("EditorCamera");
 		camera->AttachToComponent(rootComponent.get());
 		SetWorldLocation(Vector3D(0.0f, 0.0f, -10.0f));
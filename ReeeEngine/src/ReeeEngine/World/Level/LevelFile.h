@@ -0,0 +1,262 @@
+#pragma once
+#include "../../Math/Vector3D.h"
+#include "../../Math/Rotator.h"
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <unordered_map>
+
+namespace ReeeEngine
+{
+	/* An object placed in a level, spawned by the type registered with the world under its type name. */
+	struct LevelObject
+	{
+		std::string type;
+		std::string name;
+		Vector3D location = Vector3D(0.0f);
+		Rotator rotation = Rotator(0.0f);
+		Vector3D scale = Vector3D(1.0f);
+
+		// Static mesh set on objects that have one, left empty for none.
+		std::string meshPath;
+		float meshScale = 1.0f;
+		bool meshLit = false;
+
+		// If the object never moves. Kept in the file but not applied to streamed objects, which are spawned and destroyed as their
+		// chunk streams in and out so are never baked into the static batches.
+		bool isStatic = false;
+	};
+
+	/* The objects of a level inside one square cell of the ground plane. */
+	struct LevelChunk
+	{
+		int32_t x = 0;
+		int32_t z = 0;
+		std::vector<LevelObject> objects;
+	};
+
+	/* Binary level file. Objects are grouped into chunks by where they are on the X/Z ground plane so a level can be
+	 * streamed in and out a chunk at a time around a point.
+	 * The file is a header, a table of every string used then each chunk and its objects, with the objects strings stored
+	 * as indices into the table so repeated type names and mesh paths are only stored once.
+	 * NOTE: Values are written in the byte order of the machine writing them. */
+	class LevelFile
+	{
+	public:
+
+		// Identifies level files and the version of the layout they were written with.
+		static constexpr char Magic[8] = { 'R', 'E', 'E', 'E', 'L', 'V', 'L', '\0' };
+		static constexpr uint32_t Version = 1;
+
+		/* Setup an empty level split into chunks of the given size. */
+		explicit LevelFile(float newChunkSize = 100.0f) : chunkSize(newChunkSize > 0.0f ? newChunkSize : 100.0f) {}
+
+		/* Add an object to the chunk under its location. */
+		void AddObject(const LevelObject& object)
+		{
+			const int32_t x = GetCell(object.location.X);
+			const int32_t z = GetCell(object.location.Z);
+			const uint64_t key = ((uint64_t)(uint32_t)x << 32) | (uint32_t)z;
+			auto found = chunkLookup.find(key);
+			if (found == chunkLookup.end())
+			{
+				found = chunkLookup.emplace(key, chunks.size()).first;
+				chunks.emplace_back();
+				chunks.back().x = x;
+				chunks.back().z = z;
+			}
+			chunks[found->second].objects.push_back(object);
+		}
+
+		/* Write the level to a file. Returns false if the file could not be written. */
+		bool Save(const std::string& filePath) const
+		{
+			// Gather every string into one table.
+			std::vector<const std::string*> strings;
+			std::unordered_map<std::string, uint32_t> stringIndices;
+			auto addString = [&](const std::string& value)
+			{
+				if (stringIndices.emplace(value, (uint32_t)strings.size()).second) strings.push_back(&value);
+			};
+			for (const LevelChunk& chunk : chunks)
+			{
+				for (const LevelObject& object : chunk.objects)
+				{
+					addString(object.type);
+					addString(object.name);
+					addString(object.meshPath);
+				}
+			}
+
+			std::vector<char> data;
+			data.insert(data.end(), Magic, Magic + sizeof(Magic));
+			Write(data, Version);
+			Write(data, chunkSize);
+			Write(data, (uint32_t)strings.size());
+			Write(data, (uint32_t)chunks.size());
+			for (const std::string* value : strings)
+			{
+				Write(data, (uint32_t)value->size());
+				data.insert(data.end(), value->begin(), value->end());
+			}
+			for (const LevelChunk& chunk : chunks)
+			{
+				Write(data, chunk.x);
+				Write(data, chunk.z);
+				Write(data, (uint32_t)chunk.objects.size());
+				for (const LevelObject& object : chunk.objects)
+				{
+					Write(data, stringIndices[object.type]);
+					Write(data, stringIndices[object.name]);
+					Write(data, stringIndices[object.meshPath]);
+					Write(data, object.meshScale);
+					const float transform[9] = { object.location.X, object.location.Y, object.location.Z,
+						object.rotation.Pitch, object.rotation.Yaw, object.rotation.Roll, object.scale.X, object.scale.Y, object.scale.Z };
+					for (float value : transform) Write(data, value);
+					Write(data, (uint8_t)((object.meshLit ? 1 : 0) | (object.isStatic ? 2 : 0)));
+				}
+			}
+
+			std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+			if (!file) return false;
+			file.write(data.data(), (std::streamsize)data.size());
+			return (bool)file;
+		}
+
+		/* Read a level from a file, replacing anything already in this level. Returns false if the file is missing, is not a level
+		 * of this version or is cut short, leaving the level empty. */
+		bool Load(const std::string& filePath)
+		{
+			chunks.clear();
+			chunkLookup.clear();
+			std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+			if (!file) return false;
+			std::vector<char> data((size_t)file.tellg());
+			file.seekg(0);
+			if (!file.read(data.data(), (std::streamsize)data.size())) return false;
+			if (!Parse(data))
+			{
+				chunks.clear();
+				chunkLookup.clear();
+				return false;
+			}
+			return true;
+		}
+
+		/* Returns the size of each chunk and every chunk in the level. */
+		float GetChunkSize() const { return chunkSize; }
+		const std::vector<LevelChunk>& GetChunks() const { return chunks; }
+
+		/* Returns the number of objects in every chunk. */
+		size_t GetObjectCount() const
+		{
+			size_t count = 0;
+			for (const LevelChunk& chunk : chunks) count += chunk.objects.size();
+			return count;
+		}
+
+		/* Returns the centre of a chunk on the ground plane. */
+		Vector3D GetChunkCentre(const LevelChunk& chunk) const
+		{
+			return Vector3D((chunk.x + 0.5f) * chunkSize, 0.0f, (chunk.z + 0.5f) * chunkSize);
+		}
+
+	private:
+
+		// Bytes each chunk header and object take up in the file.
+		static constexpr size_t ChunkBytes = sizeof(int32_t) * 2 + sizeof(uint32_t);
+		static constexpr size_t ObjectBytes = sizeof(uint32_t) * 3 + sizeof(float) * 10 + sizeof(uint8_t);
+
+		/* Returns the chunk cell a position on an axis is in. */
+		int32_t GetCell(float position) const
+		{
+			return (int32_t)std::floor(position / chunkSize);
+		}
+
+		/* Append a plain value to the data being written. */
+		template<class T>
+		static void Write(std::vector<char>& data, const T& value)
+		{
+			const char* bytes = reinterpret_cast<const char*>(&value);
+			data.insert(data.end(), bytes, bytes + sizeof(T));
+		}
+
+		/* Read a plain value from the data, returns false if there is not enough left. */
+		template<class T>
+		static bool Read(const std::vector<char>& data, size_t& offset, T& value)
+		{
+			if (data.size() - offset < sizeof(T)) return false;
+			std::memcpy(&value, data.data() + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+
+		/* Read the level out of a files data. */
+		bool Parse(const std::vector<char>& data)
+		{
+			size_t offset = 0;
+			uint32_t version, stringCount, chunkCount;
+			if (data.size() < sizeof(Magic) || std::memcmp(data.data(), Magic, sizeof(Magic)) != 0) return false;
+			offset += sizeof(Magic);
+			if (!Read(data, offset, version) || version != Version) return false;
+			if (!Read(data, offset, chunkSize) || !(chunkSize > 0.0f)) return false;
+			if (!Read(data, offset, stringCount) || !Read(data, offset, chunkCount)) return false;
+
+			// Every string, chunk and object takes up at least some bytes so counts bigger than the file can hold are broken.
+			if (stringCount > data.size() / sizeof(uint32_t) || chunkCount > data.size() / ChunkBytes) return false;
+
+			std::vector<std::string> strings(stringCount);
+			for (std::string& value : strings)
+			{
+				uint32_t length;
+				if (!Read(data, offset, length) || data.size() - offset < length) return false;
+				value.assign(data.data() + offset, length);
+				offset += length;
+			}
+
+			chunks.resize(chunkCount);
+			for (LevelChunk& chunk : chunks)
+			{
+				uint32_t objectCount;
+				if (!Read(data, offset, chunk.x) || !Read(data, offset, chunk.z) || !Read(data, offset, objectCount)) return false;
+				if (objectCount > (data.size() - offset) / ObjectBytes) return false;
+				chunkLookup[((uint64_t)(uint32_t)chunk.x << 32) | (uint32_t)chunk.z] = (size_t)(&chunk - chunks.data());
+				chunk.objects.resize(objectCount);
+				for (LevelObject& object : chunk.objects)
+				{
+					uint32_t type, name, meshPath;
+					float transform[9];
+					uint8_t flags;
+					if (!Read(data, offset, type) || !Read(data, offset, name) || !Read(data, offset, meshPath) || !Read(data, offset, object.meshScale)) return false;
+					for (float& value : transform)
+					{
+						if (!Read(data, offset, value)) return false;
+					}
+					if (!Read(data, offset, flags)) return false;
+					if (type >= stringCount || name >= stringCount || meshPath >= stringCount) return false;
+					object.type = strings[type];
+					object.name = strings[name];
+					object.meshPath = strings[meshPath];
+					object.location = Vector3D(transform[0], transform[1], transform[2]);
+					object.rotation = Rotator(transform[3], transform[4], transform[5]);
+					object.scale = Vector3D(transform[6], transform[7], transform[8]);
+					object.meshLit = (flags & 1) != 0;
+					object.isStatic = (flags & 2) != 0;
+				}
+			}
+			return offset == data.size();
+		}
+
+	private:
+
+		// Size of each square chunk on the ground plane.
+		float chunkSize;
+
+		// Every chunk with objects in it and where each is in the list by its cell.
+		std::vector<LevelChunk> chunks;
+		std::unordered_map<uint64_t, size_t> chunkLookup;
+	};
+}
\ No newline at end of file
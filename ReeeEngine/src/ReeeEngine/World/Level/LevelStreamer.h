@@ -0,0 +1,337 @@
+#pragma once
+#include "LevelFile.h"
+#include "../Core/ObjectHandle.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <deque>
+#include <algorithm>
+#include <limits>
+
+namespace ReeeEngine
+{
+	/* Define used classes. */
+	class GameObject;
+
+	/* How far around the streaming origin a level is kept loaded and how long each update can spend on it. */
+	struct LevelStreamingSettings
+	{
+		// Chunks with their centre within loadRadius of the origin are streamed in and ones further than unloadRadius streamed out.
+		// The gap between the two stops chunks on the edge loading and unloading every frame as the origin moves back and forth.
+		float loadRadius = 300.0f;
+		float unloadRadius = 400.0f;
+
+		// Milliseconds each update can spend spawning and destroying objects, at least one object is always handled per update.
+		float frameBudgetMs = 2.0f;
+	};
+
+	/* Counters of the last streaming update. */
+	struct LevelStreamingStats
+	{
+		// Objects spawned and destroyed by the update.
+		uint32_t spawned = 0;
+		uint32_t destroyed = 0;
+
+		// Chunks with every object spawned and chunks still being prepared, spawned or destroyed.
+		uint32_t loadedChunks = 0;
+		uint32_t busyChunks = 0;
+
+		// Time the update took.
+		float updateMs = 0.0f;
+	};
+
+	/* Streams the chunks of a level file in and out around a point, e.g. the camera.
+	 * The file is read on a background thread which then prepares each chunk before it is needed, e.g. reading the mesh files
+	 * its objects use. Objects of prepared chunks are spawned on the game thread a few at a time each update, nearest chunk
+	 * first, stopping once the updates time budget is spent so loading a big level is spread across frames instead of stalling one.
+	 * NOTE: Spawning and destroying goes through the given functions so the streamer does not depend on the world. */
+	class LevelStreamer
+	{
+	public:
+
+		/* Ran on the background thread for each object of a chunk about to be streamed in. */
+		typedef std::function<void(const LevelObject&)> PrepareFunction;
+
+		/* Ran on the game thread to spawn an object, returns a handle to it or a null handle if it could not be spawned. */
+		typedef std::function<ObjectHandle<GameObject>(const LevelObject&)> SpawnFunction;
+
+		/* Ran on the game thread to destroy an object spawned by the streamer. */
+		typedef std::function<void(const ObjectHandle<GameObject>&)> DestroyFunction;
+
+		/* Setup the streamer with how objects are spawned, destroyed and optionally prepared. */
+		LevelStreamer(const SpawnFunction& spawnFunction, const DestroyFunction& destroyFunction, const PrepareFunction& prepareFunction = nullptr) :
+			spawn(spawnFunction), destroy(destroyFunction), prepare(prepareFunction), readState(ReadState::Closed), stopping(false) {}
+		LevelStreamer(const LevelStreamer&) = delete;
+		LevelStreamer& operator=(const LevelStreamer&) = delete;
+
+		/* Stop the background thread. Objects already spawned are left in the world. */
+		~LevelStreamer()
+		{
+			{
+				std::lock_guard<std::mutex> lock(jobMutex);
+				stopping = true;
+			}
+			jobCondition.notify_all();
+			if (backgroundThread.joinable()) backgroundThread.join();
+		}
+
+		/* Start reading a level file on the background thread. Chunks are streamed in by the updates once it has been read.
+		 * NOTE: Can only be called once, make a new streamer for each level. */
+		void Open(const std::string& filePath)
+		{
+			if (readState.load() != ReadState::Closed) return;
+			readState.store(ReadState::Reading);
+			backgroundThread = std::thread([this, filePath]() { BackgroundLoop(filePath); });
+		}
+
+		/* Returns if the level file has been read and if reading it failed. */
+		bool IsReady() const { return readState.load() == ReadState::Ready; }
+		bool HasFailed() const { return readState.load() == ReadState::Failed; }
+
+		/* Returns if the level has been read and every chunk is loaded or unloaded with nothing left to do. */
+		bool IsIdle() const { return IsReady() && lastStats.busyChunks == 0; }
+
+		/* Stream chunks in and out around the origin, spending at most the frame budget spawning and destroying objects. */
+		void Update(const Vector3D& origin)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			LevelStreamingStats stats;
+			if (IsReady())
+			{
+				const auto& levelChunks = level.GetChunks();
+				if (chunks.size() != levelChunks.size()) chunks.resize(levelChunks.size());
+
+				// Pick up the chunks the background thread has finished preparing.
+				{
+					std::lock_guard<std::mutex> lock(jobMutex);
+					for (size_t index : preparedChunks)
+					{
+						if (chunks[index].state == ChunkState::Preparing) chunks[index].state = ChunkState::Prepared;
+					}
+					preparedChunks.clear();
+				}
+
+				// Move each chunk on by how far it is from the origin.
+				std::vector<size_t> newJobs;
+				busyChunks.clear();
+				for (size_t i = 0; i < chunks.size(); i++)
+				{
+					StreamedChunk& chunk = chunks[i];
+					const Vector3D centre = level.GetChunkCentre(levelChunks[i]);
+					const float dx = centre.X - origin.X, dz = centre.Z - origin.Z;
+					chunk.distance = std::sqrt(dx * dx + dz * dz);
+					const bool inLoadRange = chunk.distance <= settings.loadRadius;
+					const bool inKeepRange = chunk.distance <= settings.unloadRadius;
+					switch (chunk.state)
+					{
+					case ChunkState::Unloaded:
+						if (inLoadRange)
+						{
+							chunk.state = ChunkState::Preparing;
+							newJobs.push_back(i);
+						}
+						break;
+					case ChunkState::Prepared:
+						chunk.state = inKeepRange ? ChunkState::Spawning : ChunkState::Unloaded;
+						break;
+					case ChunkState::Spawning:
+					case ChunkState::Loaded:
+						if (!inKeepRange) chunk.state = ChunkState::Destroying;
+						break;
+					case ChunkState::Destroying:
+						if (inLoadRange) chunk.state = ChunkState::Spawning;
+						break;
+					default:
+						break;
+					}
+
+					// Chunks only ever spawn the next object after the ones already spawned so flipping between spawning and destroying just carries on.
+					if (chunk.state == ChunkState::Spawning && chunk.objects.size() == levelChunks[i].objects.size()) chunk.state = ChunkState::Loaded;
+					if (chunk.state == ChunkState::Destroying && chunk.objects.empty()) chunk.state = ChunkState::Unloaded;
+					if (chunk.state == ChunkState::Spawning || chunk.state == ChunkState::Destroying) busyChunks.push_back(i);
+				}
+				if (!newJobs.empty())
+				{
+					{
+						std::lock_guard<std::mutex> lock(jobMutex);
+						jobs.insert(jobs.end(), newJobs.begin(), newJobs.end());
+					}
+					jobCondition.notify_one();
+				}
+
+				// Free chunks going out first then spawn the nearest chunks first.
+				std::sort(busyChunks.begin(), busyChunks.end(), [this](size_t a, size_t b)
+				{
+					const bool aDestroying = chunks[a].state == ChunkState::Destroying, bDestroying = chunks[b].state == ChunkState::Destroying;
+					if (aDestroying != bDestroying) return aDestroying;
+					return chunks[a].distance < chunks[b].distance;
+				});
+				const auto budget = std::chrono::duration<float, std::milli>(settings.frameBudgetMs);
+				bool budgetSpent = false;
+				for (size_t index : busyChunks)
+				{
+					StreamedChunk& chunk = chunks[index];
+					const std::vector<LevelObject>& objects = levelChunks[index].objects;
+					while (chunk.state == ChunkState::Spawning || chunk.state == ChunkState::Destroying)
+					{
+						if ((stats.spawned + stats.destroyed) > 0 && std::chrono::steady_clock::now() - start >= budget)
+						{
+							budgetSpent = true;
+							break;
+						}
+						if (chunk.state == ChunkState::Destroying)
+						{
+							if (destroy && !chunk.objects.back().IsNull()) destroy(chunk.objects.back());
+							chunk.objects.pop_back();
+							stats.destroyed++;
+							if (chunk.objects.empty()) chunk.state = ChunkState::Unloaded;
+						}
+						else
+						{
+							chunk.objects.push_back(spawn ? spawn(objects[chunk.objects.size()]) : ObjectHandle<GameObject>());
+							stats.spawned++;
+							if (chunk.objects.size() == objects.size()) chunk.state = ChunkState::Loaded;
+						}
+					}
+					if (budgetSpent) break;
+				}
+
+				for (const StreamedChunk& chunk : chunks)
+				{
+					stats.loadedChunks += chunk.state == ChunkState::Loaded ? 1 : 0;
+					stats.busyChunks += (chunk.state != ChunkState::Loaded && chunk.state != ChunkState::Unloaded) ? 1 : 0;
+				}
+			}
+			stats.updateMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			lastStats = stats;
+		}
+
+		/* Stream in everything around the origin before returning, ignoring the frame budget. Waits for the level to be read.
+		 * NOTE: Used for the first frame of a level where a longer load is better than the level appearing bit by bit. */
+		void Flush(const Vector3D& origin)
+		{
+			while (readState.load() == ReadState::Reading) std::this_thread::yield();
+			const float frameBudgetMs = settings.frameBudgetMs;
+			settings.frameBudgetMs = std::numeric_limits<float>::infinity();
+			while (IsReady())
+			{
+				Update(origin);
+				if (IsIdle()) break;
+				std::this_thread::yield();
+			}
+			settings.frameBudgetMs = frameBudgetMs;
+		}
+
+		/* Destroy every object the streamer has spawned straight away and mark every chunk as unloaded. */
+		void DestroyAll()
+		{
+			for (StreamedChunk& chunk : chunks)
+			{
+				for (const auto& object : chunk.objects)
+				{
+					if (destroy && !object.IsNull()) destroy(object);
+				}
+				chunk.objects.clear();
+				if (chunk.state != ChunkState::Preparing) chunk.state = ChunkState::Unloaded;
+			}
+		}
+
+		/* Settings getter and setter. */
+		const LevelStreamingSettings& GetSettings() const { return settings; }
+		void SetSettings(const LevelStreamingSettings& newSettings) { settings = newSettings; }
+
+		/* Returns the counters of the last update. */
+		const LevelStreamingStats& GetStats() const { return lastStats; }
+
+		/* Returns the level being streamed, empty until it has been read. */
+		const LevelFile& GetLevel() const
+		{
+			static const LevelFile emptyLevel;
+			return IsReady() ? level : emptyLevel;
+		}
+
+	private:
+
+		/* Where the level file is in being read. */
+		enum class ReadState : uint8_t
+		{
+			Closed,
+			Reading,
+			Ready,
+			Failed
+		};
+
+		/* Where a chunk is in being streamed in or out. */
+		enum class ChunkState : uint8_t
+		{
+			Unloaded,
+			Preparing,
+			Prepared,
+			Spawning,
+			Loaded,
+			Destroying
+		};
+
+		/* The streaming state of a chunk and handles to the objects spawned for it, in the order they are in the chunk. */
+		struct StreamedChunk
+		{
+			ChunkState state = ChunkState::Unloaded;
+			float distance = 0.0f;
+			std::vector<ObjectHandle<GameObject>> objects;
+		};
+
+		/* Read the level then prepare chunks as they are asked for until the streamer is destroyed. */
+		void BackgroundLoop(const std::string& filePath)
+		{
+			// The level is only written here before it is marked as ready, after that both threads only read it.
+			readState.store(level.Load(filePath) ? ReadState::Ready : ReadState::Failed);
+			while (true)
+			{
+				size_t index;
+				{
+					std::unique_lock<std::mutex> lock(jobMutex);
+					jobCondition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+					if (stopping) return;
+					index = jobs.front();
+					jobs.pop_front();
+				}
+				if (prepare)
+				{
+					for (const LevelObject& object : level.GetChunks()[index].objects) prepare(object);
+				}
+				std::lock_guard<std::mutex> lock(jobMutex);
+				preparedChunks.push_back(index);
+			}
+		}
+
+	private:
+
+		// Functions objects are spawned, destroyed and prepared with.
+		SpawnFunction spawn;
+		DestroyFunction destroy;
+		PrepareFunction prepare;
+
+		// Level being streamed and how far it has been read.
+		LevelFile level;
+		std::atomic<ReadState> readState;
+
+		// Streaming state of each chunk of the level and the chunks being spawned or destroyed this update.
+		std::vector<StreamedChunk> chunks;
+		std::vector<size_t> busyChunks;
+
+		// Chunks waiting for and finished by the background thread.
+		std::thread backgroundThread;
+		std::mutex jobMutex;
+		std::condition_variable jobCondition;
+		std::deque<size_t> jobs;
+		std::vector<size_t> preparedChunks;
+		bool stopping;
+
+		// Streaming settings and counters of the last update.
+		LevelStreamingSettings settings;
+		LevelStreamingStats lastStats;
+	};
+}
\ No newline at end of file
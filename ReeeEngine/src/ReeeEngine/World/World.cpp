@@ -6,11 +6,19 @@
 #include "../Rendering/Lights/PointLight.h"
 #include "GameObjects/StaticMeshObject.h"
 #include "Components/MeshComponent.h"
+#include "Components/SceneComponent.h"
 
 namespace ReeeEngine
 {
 	World::World()
 	{
+		// Register the engines object types so levels can spawn them.
+		RegisterObjectType<GameObject>("GameObject");
+		RegisterObjectType<StaticMeshObject>("StaticMeshObject");
+
+		// Report tick scheduling problems, e.g. prerequisite loops, to the log.
+		ticks.SetWarningFunction([](const std::string& message) { REEE_LOG(Warning, "{0}", message); });
+
 		// Initalise the editor camera object.
 		engineCamera = NewObject<EngineCamera>("EngineCameraObject");
 		activeCamera = &engineCamera->GetCamera();
@@ -18,8 +26,30 @@ namespace ReeeEngine
 
 	World::~World()
 	{
+		// Stop reading the level before the objects it spawns into are gone.
+		levelStreamer.reset();
+
+		// Unlink every object from its entity, handle and other objects components first as the app can keep objects alive after the world is gone.
+		for (auto* list : { &objects, &pendingSpawns })
+		{
+			for (auto& obj : *list)
+			{
+				entities.Destroy(obj->entity);
+				obj->entityStore = nullptr;
+				handles.Remove(obj->handle);
+				obj->handleTable = nullptr;
+				UnlinkSpatialIndex(obj.get());
+				obj->UnlinkComponents();
+			}
+		}
+
 		// Destroy all objects loaded into the world.
+		pendingDestroys.clear();
+		pendingSpawns.clear();
 		objects.clear();
+
+		// The merged static meshes were baked from this worlds level, the next world bakes its own.
+		MeshComponent::ReleaseStaticMeshes();
 	}
 
 	void World::LevelStart()
@@ -27,22 +57,269 @@ namespace ReeeEngine
 		// Temp only supports one point-light default created can be moved.
 		pointLight = new PointLight(Application::GetEngine().GetWindow().GetGraphics());
 
+		// Stream in the level around the camera first so the first frame has all of it.
+		if (levelStreamer) levelStreamer->Flush(GetActiveCamera().GetWorldLocation());
+
+		// Objects spawned from here on are queued so the list below is not changed while it is looped through.
+		levelStarted = true;
+
 		// For each loaded object run level start.
 		for (auto& obj : objects)
 		{
-			obj->LevelStart();
+			if (!obj->pendingDestroy) obj->LevelStart();
+		}
+
+		// Only register what needs ticking now level start has had the chance to change it.
+		for (auto& obj : objects)
+		{
+			RegisterTicks(obj.get());
+		}
+
+		// Start anything spawned and remove anything destroyed during level start.
+		FlushPendingObjects();
+
+		// Notify components of any transforms setup during level start then fit the spatial index around them.
+		SceneComponent::FlushTransformChanges();
+		RefitSpatialIndex();
+
+		// Merge the static meshes now they are in place then stop anything static from moving so the batches stay correct.
+		MeshComponent::BakeStaticMeshes();
+		for (auto& obj : objects)
+		{
+			obj->LockTransforms();
 		}
 	}
 
 	void World::Tick(float deltaTime)
 	{
+		// Tick each registered object and component that is due a tick, phase by phase with the independent ones spread across the worker pool.
+		ticks.Tick(deltaTime);
+
+		// Update the entity components in bulk.
+		for (const SystemFunction& system : systems)
+		{
+			system(entities, deltaTime);
+		}
+
+		// Stream the level around the camera within the streaming budget.
+		if (levelStreamer)
+		{
+			levelStreamer->Update(GetActiveCamera().GetWorldLocation());
+			if (levelStreamer->HasFailed())
+			{
+				REEE_LOG(Warning, "World: failed to read the level being streamed, it is not a level file of this version or is cut short.");
+				levelStreamer.reset();
+			}
+		}
+
+		// Remove the objects destroyed and start the objects spawned this frame now nothing is being ticked.
+		FlushPendingObjects();
+
+		// Notify every component that moved this frame once, no matter how many times it was moved, then refit the objects they belong to.
+		SceneComponent::FlushTransformChanges();
+		RefitSpatialIndex();
+
 		// Bind point light information to pipeline for mesh components to later access through the constant buffer.
+		// NOTE: Bound after ticking so the light and camera are where this frames ticks left them.
 		pointLight->Add(Application::GetEngine().GetWindow().GetGraphics(), GetActiveCamera().GetViewMatrix());
 
-		// For each loaded object tick/render.
-		for (auto& obj : objects)
+		// Rebuild the matrix and bounds of each moved mesh once then gather the ones the active camera can see at this frames transforms.
+		MeshComponent::ResolveMeshTransforms();
+		const CameraComponent& camera = GetActiveCamera();
+		const Matrix4x4 viewMatrix = camera.GetViewMatrix();
+		const Matrix4x4 projectionMatrix = camera.GetProjectionMatrix();
+		renderQueue.Clear();
+		MeshComponent::GatherMeshes(renderQueue, viewMatrix * projectionMatrix, camera.GetWorldLocation());
+
+		// Sort everything gathered by shader, texture and mesh, front to back within each, then collapse each run of the same mesh and material into one instanced draw.
+		renderQueue.Sort();
+		renderQueue.CountStateChanges();
+		instanceBatcher.Build(renderQueue.GetPackets(), viewMatrix, projectionMatrix,
+			[](const DrawPacket& packet) { return packet.renderable->GetTransform(); },
+			[](const DrawPacket& first, const DrawPacket& other) { return first.renderable->CanInstanceWith(*other.renderable); });
+
+		// Draw the batches, runs of one draw are drawn as they are.
+		Graphics& graphics = Application::GetEngine().GetWindow().GetGraphics();
+		const std::vector<DrawPacket>& packets = renderQueue.GetPackets();
+		const std::vector<InstanceTransform>& instances = instanceBatcher.GetInstances();
+		for (const InstanceBatch& batch : instanceBatcher.GetBatches())
+		{
+			const RenderableMesh* renderable = packets[batch.firstPacket].renderable;
+			if (batch.count == 1) renderable->Render(graphics);
+			else renderable->RenderInstanced(graphics, &instances[batch.firstInstance], batch.count);
+		}
+	}
+
+	void World::AddSystem(const SystemFunction& system)
+	{
+		systems.push_back(system);
+	}
+
+	void World::StreamLevel(const std::string& filePath)
+	{
+		if (levelStreamer) levelStreamer->DestroyAll();
+
+		// Mesh files are read ahead on the streamers thread so only the graphics resources are made while spawning.
+		levelStreamer = CreateReff<LevelStreamer>(
+			[this](const LevelObject& levelObject) { return SpawnLevelObject(levelObject); },
+			[this](const ObjectHandle<GameObject>& handle) { DestroyObject(handle); },
+			[](const LevelObject& levelObject) { if (!levelObject.meshPath.empty()) MeshComponent::PreloadStaticMesh(levelObject.meshPath, levelObject.meshScale); });
+		levelStreamer->SetSettings(streamingSettings);
+		levelStreamer->Open(filePath);
+	}
+
+	void World::SetStreamingSettings(const LevelStreamingSettings& newSettings)
+	{
+		streamingSettings = newSettings;
+		if (levelStreamer) levelStreamer->SetSettings(streamingSettings);
+	}
+
+	ObjectHandle<GameObject> World::SpawnLevelObject(const LevelObject& levelObject)
+	{
+		auto type = objectTypes.find(levelObject.type);
+		if (type == objectTypes.end())
+		{
+			REEE_LOG(Warning, "World: the level object {0} has the unregistered type {1} so is not spawned.", levelObject.name, levelObject.type);
+			return ObjectHandle<GameObject>();
+		}
+
+		Pointer<GameObject> object = type->second(levelObject.name);
+		object->SetWorldTransform(Transform(levelObject.location, levelObject.rotation, levelObject.scale));
+		if (!levelObject.meshPath.empty())
+		{
+			StaticMeshObject* meshObject = dynamic_cast<StaticMeshObject*>(object.get());
+			if (meshObject) meshObject->GetStaticMesh().SetStaticMesh(levelObject.meshPath, levelObject.meshScale, levelObject.meshLit);
+		}
+
+		// Level objects are left movable even if they are static in the level. Their chunk can be unloaded and loaded again at any time
+		// but the static batches are baked once for the whole level, so baking them would leave them drawn after they are destroyed.
+		return object->GetHandle();
+	}
+
+	void World::DestroyObject(GameObject* object)
+	{
+		if (!object || object->pendingDestroy || object->handleTable != &handles) return;
+
+		// Stop it ticking and invalidate its handles now, the tick lists are compacted once at the end of the next tick.
+		object->pendingDestroy = true;
+		handles.Remove(object->handle);
+		UnregisterTicks(object);
+		UnlinkSpatialIndex(object);
+		pendingDestroys.push_back(object);
+	}
+
+	void World::SetupNewObject(const Pointer<GameObject>& object)
+	{
+		object->entity = entities.Create(GameObjectEntity{ object.get() });
+		object->entityStore = &entities;
+		object->handle = handles.Add(object.get());
+		object->handleTable = &handles;
+		object->spatialProxy = spatialIndex.Insert(object->GetWorldBounds(), object.get());
+		object->spatialIndex = &spatialIndex;
+		if (levelStarted)
+		{
+			// Mobility is fixed once the level has started, objects spawned from here on are never baked.
+			object->LockTransforms();
+			pendingSpawns.push_back(object);
+			return;
+		}
+		object->worldIndex = objects.size();
+		objects.push_back(object);
+	}
+
+	void World::FlushPendingObjects()
+	{
+		// Starting objects can spawn and destroy more so keep going until nothing is left queued.
+		while (!pendingDestroys.empty() || !pendingSpawns.empty())
+		{
+			// Remove destroyed objects first so objects spawned and destroyed in the same frame are never started.
+			std::vector<GameObject*> destroying;
+			destroying.swap(pendingDestroys);
+			for (GameObject* object : destroying)
+			{
+				RemoveObject(object);
+			}
+
+			// Add every spawned object before starting any of them so objects started can find each other.
+			std::vector<Pointer<GameObject>> spawning;
+			spawning.swap(pendingSpawns);
+			for (auto& object : spawning)
+			{
+				object->worldIndex = objects.size();
+				objects.push_back(object);
+			}
+			for (auto& object : spawning)
+			{
+				if (!object->pendingDestroy) object->LevelStart();
+			}
+			for (auto& object : spawning)
+			{
+				RegisterTicks(object.get());
+			}
+		}
+	}
+
+	void World::RemoveObject(GameObject* object)
+	{
+		// Keep the object alive until it is unlinked, it is only destroyed here if nothing outside the world holds onto it.
+		Pointer<GameObject> removed;
+		const size_t index = object->worldIndex;
+		if (index < objects.size() && objects[index].get() == object)
+		{
+			// Swap the last object into the gap so the list stays packed.
+			removed = std::move(objects[index]);
+			if (index != objects.size() - 1)
+			{
+				objects[index] = std::move(objects.back());
+				objects[index]->worldIndex = index;
+			}
+			objects.pop_back();
+		}
+		else
+		{
+			// Spawned and destroyed before it was ever added to the world.
+			auto pending = std::find_if(pendingSpawns.begin(), pendingSpawns.end(), [object](const Pointer<GameObject>& spawned) { return spawned.get() == object; });
+			if (pending == pendingSpawns.end()) return;
+			removed = std::move(*pending);
+			pendingSpawns.erase(pending);
+		}
+		entities.Destroy(object->entity);
+		object->entityStore = nullptr;
+		object->handleTable = nullptr;
+		UnlinkSpatialIndex(object);
+		object->UnlinkComponents();
+		object->worldIndex = ~size_t(0);
+	}
+
+	void World::RefitSpatialIndex()
+	{
+		spatialIndex.Refit([](GameObject* object) { return object->GetWorldBounds(); });
+	}
+
+	void World::UnlinkSpatialIndex(GameObject* object)
+	{
+		if (object->spatialIndex != &spatialIndex) return;
+		spatialIndex.Remove(object->spatialProxy);
+		object->spatialIndex = nullptr;
+		object->spatialProxy = SpatialIndex<GameObject*>::InvalidProxy;
+	}
+
+	void World::RegisterTicks(GameObject* object)
+	{
+		if (object->pendingDestroy) return;
+		ticks.Register(object);
+		for (Component* comp : object->components)
+		{
+			ticks.Register(comp);
+		}
+	}
+
+	void World::UnregisterTicks(GameObject* object)
+	{
+		ticks.Unregister(object);
+		for (Component* comp : object->components)
 		{
-			obj->Tick(deltaTime);
+			ticks.Unregister(comp);
 		}
 	}
 
@@ -2,6 +2,15 @@
 #include "../Globals.h"
 #include "../ReeeLog.h"
 #include "../Math/Vector3D.h"
+#include "Core/EntityStore.h"
+#include "Core/Object.h"
+#include "Core/ObjectHandle.h"
+#include "Core/ObjectPool.h"
+#include "Core/SpatialIndex.h"
+#include "Level/LevelStreamer.h"
+#include "../Rendering/RenderQueue.h"
+#include "../Rendering/Renderables/InstanceBatcher.h"
+#include <unordered_map>
 
 namespace ReeeEngine
 {
@@ -23,6 +32,9 @@ namespace ReeeEngine
 		World();
 		~World();
 
+		/* Function ran on the entity store every frame with the frames delta time. */
+		typedef std::function<void(EntityStore&, float)> SystemFunction;
+
 		/* Level begin function. */
 		void LevelStart();
 
@@ -33,27 +45,188 @@ namespace ReeeEngine
 		class CameraComponent& GetActiveCamera();
 		void SetActiveCamera(CameraComponent* camera);
 
-		/* Object spawning function for adding new game objects to the world. */
+		/* Object spawning function for adding new game objects to the world.
+		 * NOTE: Objects are allocated from a pool per type so objects of the same type are kept together in memory.
+		 *       Objects spawned once the level has started are setup straight away but only level started and ticked once the
+		 *       pending objects are flushed, at the end of the frame, so spawning from inside a tick is safe. */
 		template<class T>
 		Pointer<T> NewObject(const std::string& name)
 		{
 			// Ensure the type of sub object being created is a type of component.
 			WORLD_EXCEPT((std::is_base_of<GameObject, T>::value), "Attempting to create an object that is not of sub-type gameobject.");
-			Pointer<T> newGameObject = CreatePointer<T>(name);
-			objects.push_back(newGameObject);
+			Pointer<T> newGameObject = std::allocate_shared<T>(PoolAllocator<T>(), name);
+			SetupNewObject(newGameObject);
 			return newGameObject;
 		}
 
+		/* Destroy an object at the end of this frame. It stops ticking and handles to it stop resolving straight away but it
+		 * stays in memory until the pending objects are flushed so pointers to it held during this frame stay safe.
+		 * NOTE: Objects kept alive by shared pointers held outside of the world are only removed from it. */
+		void DestroyObject(GameObject* object);
+		template<class T>
+		void DestroyObject(const ObjectHandle<T>& handle)
+		{
+			DestroyObject(ResolveHandle(handle));
+		}
+
+		/* Register a game object type so levels can spawn it by its type name. */
+		template<class T>
+		void RegisterObjectType(const std::string& typeName)
+		{
+			WORLD_EXCEPT((std::is_base_of<GameObject, T>::value), "Attempting to register an object type that is not of sub-type gameobject.");
+			objectTypes[typeName] = [this](const std::string& name) -> Pointer<GameObject> { return NewObject<T>(name); };
+		}
+
+		/* Start streaming a level file in around the active camera, destroying the objects of any level streamed in before.
+		 * The file is read on a background thread and its objects spawned over the following frames within the streaming budget. */
+		void StreamLevel(const std::string& filePath);
+
+		/* Level streaming settings and the counters of the last streaming update. */
+		void SetStreamingSettings(const LevelStreamingSettings& newSettings);
+		const LevelStreamingSettings& GetStreamingSettings() const { return streamingSettings; }
+		LevelStreamingStats GetStreamingStats() const { return levelStreamer ? levelStreamer->GetStats() : LevelStreamingStats(); }
+
+		/* Returns the number of objects in the world, not counting objects spawned since the last flush. */
+		size_t GetObjectCount() const { return objects.size(); }
+
+		/* Spawn a new game object and return a handle to it instead of a shared pointer. */
+		template<class T>
+		ObjectHandle<T> SpawnObject(const std::string& name)
+		{
+			return GetHandle(NewObject<T>(name).get());
+		}
+
+		/* Returns the handle of an object in this world as a handle to its own type. */
+		template<class T>
+		ObjectHandle<T> GetHandle(const T* object) const
+		{
+			if (!object) return ObjectHandle<T>();
+			const ObjectHandle<GameObject> handle = object->GetHandle();
+			return ObjectHandle<T>(handle.index, handle.generation);
+		}
+
+		/* Returns the object a handle points at or nullptr if it has been destroyed. */
+		template<class T>
+		T* ResolveHandle(const ObjectHandle<T>& handle) const
+		{
+			return handles.Get(handle);
+		}
+
+		/* Returns if a handle still points at an object in this world. */
+		template<class T>
+		bool IsValid(const ObjectHandle<T>& handle) const
+		{
+			return handles.IsValid(handle);
+		}
+
+		/* Call visit with each object whose bounds are within a radius of a point, inside a box or at least partly inside a frustum.
+		 * NOTE: Bounds are as of the end of the last frame, or level start, objects destroyed this frame are never visited. */
+		template<class F>
+		void QueryRadius(const Vector3D& center, float radius, F&& visit) const
+		{
+			spatialIndex.QueryRadius(center, radius, visit);
+		}
+		template<class F>
+		void QueryBox(const BoundingBox& box, F&& visit) const
+		{
+			spatialIndex.QueryBox(box, visit);
+		}
+		template<class F>
+		void QueryFrustum(const Frustum& frustum, F&& visit) const
+		{
+			spatialIndex.QueryFrustum(frustum, visit);
+		}
+
+		/* Find up to maxHits objects nearest a point within maxDistance, written to outHits nearest first. Returns the number found. */
+		size_t QueryNearest(const Vector3D& point, SpatialHit<GameObject*>* outHits, size_t maxHits, float maxDistance = BIG_NUMBER) const
+		{
+			return spatialIndex.QueryNearest(point, outHits, maxHits, maxDistance);
+		}
+
+		/* Spatial index of every object in the world by its bounds. */
+		const SpatialIndex<GameObject*>& GetSpatialIndex() const { return spatialIndex; }
+
+		/* Add a system to update entities every frame. Systems are ran in the order they were added once every object has ticked. */
+		void AddSystem(const SystemFunction& system);
+
+		/* Entity store getter, holds an entity for every game object plus any entities made by systems. */
+		EntityStore& GetEntities() { return entities; }
+
+		/* Returns the counters of how many registered objects were ticked and skipped last frame. */
+		const TickStats& GetTickStats() const { return ticks.GetStats(); }
+
+		/* Microseconds each frame can spend ticking amortized objects, see TickSettings::amortized. */
+		void SetAmortizedTickBudget(float microseconds) { ticks.SetAmortizedBudget(microseconds); }
+		float GetAmortizedTickBudget() const { return ticks.GetAmortizedBudget(); }
+
+		/* Returns the counters of the draws and state changes of the last rendered frame. */
+		const RenderQueueStats& GetRenderStats() const { return renderQueue.GetStats(); }
+
+		/* Returns the counters of the draws collapsed into instanced draws in the last rendered frame. */
+		const InstancingStats& GetInstancingStats() const { return instanceBatcher.GetStats(); }
+
 		// TEMP LIGHT POSITIONING FUNCTION FOR DEMO GAME.
 		void SetLightWorldPosition(const Vector3D& newPosition);
 
+	private:
+
+		/* Create the entity and handle a new game object is linked to and add it to the world, or queue it to be started if the level has already started. */
+		void SetupNewObject(const Pointer<GameObject>& object);
+
+		/* Register or unregister an object and each of its components that can tick. */
+		void RegisterTicks(GameObject* object);
+		void UnregisterTicks(GameObject* object);
+
+		/* Remove the objects destroyed and start the objects spawned since the last flush. Ran at the end of level start and
+		 * after every tick, before anything is rendered. */
+		void FlushPendingObjects();
+
+		/* Unlink an object from the world and drop the worlds reference to it, moving the last object into its place. */
+		void RemoveObject(GameObject* object);
+
+		/* Update the bounds of every object whose scene components moved since the last refit in the spatial index. */
+		void RefitSpatialIndex();
+
+		/* Take an object out of the spatial index. */
+		void UnlinkSpatialIndex(GameObject* object);
+
+		/* Spawn an object of a streamed level from its registered type and place it. */
+		ObjectHandle<GameObject> SpawnLevelObject(const LevelObject& levelObject);
+
 	private:
 
 		// TEMP LIGHT FOR DEMO GAME.
 		class PointLight* pointLight;
 
-		// Array of intialised game objects.
+		// Array of intialised game objects and the handles to them.
 		std::vector<Pointer<GameObject>> objects;
+		HandleTable<GameObject> handles;
+
+		// Objects spawned and destroyed since the pending objects were last flushed.
+		std::vector<Pointer<GameObject>> pendingSpawns;
+		std::vector<GameObject*> pendingDestroys;
+
+		// Entities of every game object and their plain data components, updated in bulk by the systems.
+		EntityStore entities;
+		std::vector<SystemFunction> systems;
+
+		// Spawn functions of the object types levels can spawn by name.
+		std::unordered_map<std::string, std::function<Pointer<GameObject>(const std::string&)>> objectTypes;
+
+		// Level being streamed in around the active camera and how it is streamed.
+		Refference<LevelStreamer> levelStreamer;
+		LevelStreamingSettings streamingSettings;
+
+		// Every object by its world bounds, refit once a frame for the objects that moved.
+		SpatialIndex<GameObject*> spatialIndex;
+
+		// Draws gathered each frame once everything has ticked, sorted then drawn with runs of the same mesh and material drawn instanced.
+		RenderQueue renderQueue;
+		InstanceBatcher instanceBatcher;
+
+		// Lists of the objects and components that need ticking.
+		TickManager ticks;
+		bool levelStarted = false;
 
 		// Pointers to the editor camera.
 		Pointer<class EngineCamera> engineCamera;